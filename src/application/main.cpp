@@ -11,6 +11,7 @@ VookiImageViewer - a tool for showing images.
 #include "../abstraction/init.h"
 #include "../ui/MainWindow.h"
 #include "Application.h"
+#include <exiv2/exiv2.hpp>
 #include <iostream>
 
 int main(int argc, char *argv[])
@@ -46,6 +47,8 @@ int main(int argc, char *argv[])
 #endif // UNIX_LIKE
 
     SystemDependant::Init();
+    // The XMP toolkit is not thread-safe to initialize lazily from the metadata reading pools.
+    Exiv2::XmpParser::initialize();
     MainWindow mainWindow;
     QObject::connect(&application, &Application::aboutToQuit, &mainWindow, &MainWindow::onAboutToQuit);
     QObject::connect(&application, &Application::openFileRequested, &mainWindow, &MainWindow::onOpenFileRequested);
@@ -0,0 +1,162 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "CatalogIndex.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include "../util/PrivateFile.h"
+
+namespace
+{
+    constexpr std::array<char, 8> magic {'V', 'I', 'V', 'C', 'A', 'T', 'I', 'X'};
+    constexpr quint32 version {1};
+
+    struct Header
+    {
+        std::array<char, 8> magic;
+        quint32 version;
+        quint32 criterion;
+        qint64 directoryModificationTime;
+        quint64 count;
+        // In UTF-16 code units
+        quint64 characterCount;
+    };
+
+    struct Entry
+    {
+        quint32 offset;
+        quint32 length;
+        qint64 modificationTime;
+        qint64 captureTime;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<Entry>);
+    // Names follow the entries, they stay aligned for the direct access.
+    static_assert(sizeof(Header) % alignof(char16_t) == 0 && sizeof(Entry) % alignof(char16_t) == 0);
+}
+
+CatalogIndex::CatalogIndex(const QString &directory)
+                                        : m_directory(QDir::cleanPath(directory))
+{
+}
+
+QString CatalogIndex::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/catalog");
+}
+
+QString CatalogIndex::indexPath(const QString &directory, const QString &listing) const
+{
+    const QByteArray hash {QCryptographicHash::hash((directory + QLatin1Char('\n') + listing).toUtf8(), QCryptographicHash::Md5).toHex()};
+    return QStringLiteral("%1/%2.idx").arg(m_directory, QString::fromLatin1(hash));
+}
+
+bool CatalogIndex::load(const QString &path, Contents &contents)
+{
+    QFile file {path};
+    if (!file.open(QIODevice::ReadOnly) || file.size() < static_cast<qint64>(sizeof(Header)))
+        return false;
+
+    // Just the touched pages are read, no buffer of the whole file is allocated.
+    const uchar *data {file.map(0, file.size())};
+    if (data == nullptr)
+        return false;
+
+    const auto size {static_cast<quint64>(file.size())};
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.magic != magic || header.version != version || header.criterion > static_cast<quint32>(CatalogOrder::Criterion::CaptureTime)
+        || header.count > (size - sizeof(Header)) / sizeof(Entry)
+        || header.characterCount != (size - sizeof(Header) - header.count * sizeof(Entry)) / sizeof(char16_t))
+    {
+        qDebug() << "Catalog index is not valid:" << path;
+        return false;
+    }
+
+    const uchar *entries {data + sizeof(Header)};
+    const auto *characters {reinterpret_cast<const QChar *>(entries + header.count * sizeof(Entry))};
+
+    contents.directoryModificationTime = header.directoryModificationTime;
+    contents.criterion = static_cast<CatalogOrder::Criterion>(header.criterion);
+    contents.names.clear();
+    contents.names.reserve(static_cast<qsizetype>(header.count), static_cast<qsizetype>(header.characterCount));
+    contents.keys.clear();
+    contents.keys.reserve(header.count);
+    for (quint64 i = 0; i < header.count; ++i)
+    {
+        Entry entry;
+        std::memcpy(&entry, entries + i * sizeof(Entry), sizeof(Entry));
+        if (static_cast<quint64>(entry.offset) + entry.length > header.characterCount)
+        {
+            qDebug() << "Catalog index is not valid:" << path;
+            return false;
+        }
+
+        contents.names.append(QStringView {characters + entry.offset, static_cast<qsizetype>(entry.length)});
+        contents.keys.push_back({entry.modificationTime, entry.captureTime});
+    }
+
+    // Used recently, so it is the last one to be pruned.
+    file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+
+bool CatalogIndex::store(const QString &path, const Contents &contents)
+{
+    Header header {magic, version, static_cast<quint32>(contents.criterion), contents.directoryModificationTime,
+                   static_cast<quint64>(contents.names.size()), 0};
+    std::vector<Entry> entries;
+    entries.reserve(contents.names.size());
+    for (qsizetype i = 0; i < contents.names.size(); ++i)
+    {
+        const auto length {static_cast<quint32>(contents.names[i].size())};
+        entries.push_back({static_cast<quint32>(header.characterCount), length, contents.keys[i].modificationTime, contents.keys[i].captureTime});
+        header.characterCount += length;
+    }
+
+    QSaveFile file {path};
+    bool isWritten {Util::openPrivateFile(file)};
+    isWritten = isWritten && file.write(reinterpret_cast<const char *>(&header), sizeof(Header)) == sizeof(Header);
+    isWritten = isWritten && file.write(reinterpret_cast<const char *>(entries.data()), static_cast<qint64>(entries.size() * sizeof(Entry)))
+                                     == static_cast<qint64>(entries.size() * sizeof(Entry));
+    for (qsizetype i = 0; isWritten && i < contents.names.size(); ++i)
+    {
+        const QStringView name {contents.names[i]};
+        isWritten = file.write(reinterpret_cast<const char *>(name.utf16()), name.size() * static_cast<qint64>(sizeof(char16_t))) == name.size() * static_cast<qint64>(sizeof(char16_t));
+    }
+
+    if (!isWritten || !file.commit())
+    {
+        qDebug() << "Catalog index storing failed:" << path << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void CatalogIndex::prune(const qsizetype maxCount) const
+{
+    // The most recently used indexes go first, their loading refreshes the modification time.
+    const QFileInfoList entries {QDir(m_directory).entryInfoList({QStringLiteral("*.idx")}, QDir::Files, QDir::Time)};
+    const QDateTime oldest {QDateTime::currentDateTimeUtc().addDays(-m_maxAge)};
+    for (qsizetype i = 0; i < entries.size(); ++i)
+    {
+        if (i >= maxCount || entries.at(i).lastModified() < oldest)
+            QFile::remove(entries.at(i).absoluteFilePath());
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "CatalogOrder.h"
+#include "../util/StringArena.h"
+#include <QString>
+#include <vector>
+
+/// Sorted catalogs of the directories kept in the cache, so reopening a huge directory does not enumerate it again.
+/// An index is a single file with a header, fixed-size entries and the names stored back to back after them.
+/// It is memory-mapped while loading, in the native byte order, as it never leaves the machine. The cache is bounded
+/// by the number of indexes and their age, the least recently used ones are pruned.
+class CatalogIndex
+{
+public:
+    struct Contents
+    {
+        /// Modification time of the directory when it was listed, in milliseconds since the epoch
+        qint64 directoryModificationTime {0};
+        CatalogOrder::Criterion criterion {CatalogOrder::Criterion::Name};
+        StringArena names {};
+        /// Keys of the names, at the same positions
+        std::vector<CatalogOrder::Keys> keys {};
+    };
+
+    explicit CatalogIndex(const QString &directory = defaultDirectory());
+
+    /// The catalog directory in the application cache location.
+    [[nodiscard]] static QString defaultDirectory();
+    /// Index of the directory listed in the given way, e.g. with the name filters, which are part of the index name.
+    [[nodiscard]] QString indexPath(const QString &directory, const QString &listing) const;
+
+    /// Returns false if there is no index, or it is damaged.
+    [[nodiscard]] static bool load(const QString &path, Contents &contents);
+    /// Written to a temporary file and renamed, so a reader never sees a partial index. The file names tell a lot
+    /// about the user, so the index is readable by the owner only. Safe to call from a worker thread.
+    static bool store(const QString &path, const Contents &contents);
+    /// Removes the indexes over the count, and the ones not used for longer than m_maxAge. Lists the whole
+    /// directory, so the catalog calls it every m_pruneInterval stores.
+    void prune(qsizetype maxCount = m_defaultMaxCount) const;
+
+    static constexpr qsizetype m_defaultMaxCount {256};
+    static constexpr int m_maxAge {90}; // days
+    static constexpr int m_pruneInterval {16};
+
+private:
+    QString m_directory;
+};
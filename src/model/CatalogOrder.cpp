@@ -0,0 +1,167 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "CatalogOrder.h"
+#include <QFileInfo>
+#include <algorithm>
+#include <numeric>
+
+CatalogOrder::CatalogOrder(const Criterion criterion, const QLocale &locale)
+                                        : m_criterion(criterion)
+                                        , m_collator(locale)
+{
+    // The collator initializes itself on the first use, which is not thread-safe. The copy initializes it right away,
+    // the collation keys are derived on several threads at once then.
+    m_collator = QCollator {m_collator};
+}
+
+CatalogOrder::Criterion CatalogOrder::getCriterion() const
+{
+    return m_criterion;
+}
+
+bool CatalogOrder::needsKeys() const
+{
+    return m_criterion == Criterion::ModificationTime || m_criterion == Criterion::CaptureTime;
+}
+
+bool CatalogOrder::hasKeys(const Keys &keys) const
+{
+    switch (m_criterion)
+    {
+        case Criterion::ModificationTime:
+            return keys.modificationTime != m_unknown;
+        case Criterion::CaptureTime:
+            return keys.captureTime != m_unknown;
+        default:
+            return true;
+    }
+}
+
+void CatalogOrder::gatherKeys(const QString &directory, const QString &name, Keys &keys, const CaptureTimeReader &captureTimeReader) const
+{
+    deriveKeys(name, keys);
+    if (hasKeys(keys))
+        return;
+
+    const QString fileName {directory + QLatin1Char('/') + name};
+    if (keys.modificationTime == m_unknown)
+        keys.modificationTime = QFileInfo(fileName).lastModified().toMSecsSinceEpoch();
+
+    if (m_criterion == Criterion::CaptureTime && keys.captureTime == m_unknown)
+    {
+        const QDateTime captureTime {captureTimeReader ? captureTimeReader(fileName) : QDateTime {}};
+        keys.captureTime = captureTime.isValid() ? captureTime.toMSecsSinceEpoch() : keys.modificationTime;
+    }
+}
+
+void CatalogOrder::deriveKeys(const QStringView name, Keys &keys) const
+{
+    switch (m_criterion)
+    {
+        case Criterion::Name:
+            keys.naturalKey = QString {};
+            keys.collationKey.reset();
+            break;
+        case Criterion::Locale:
+            keys.naturalKey = QString {};
+            if (!keys.collationKey)
+                keys.collationKey = m_collator.sortKey(name.toString());
+            break;
+        default:
+            keys.collationKey.reset();
+            if (keys.naturalKey.isNull())
+                keys.naturalKey = naturalSortKey(name);
+    }
+}
+
+bool CatalogOrder::lessThan(const QStringView leftName, const Keys &leftKeys, const QStringView rightName, const Keys &rightKeys) const
+{
+    switch (m_criterion)
+    {
+        case Criterion::Name:
+            return leftName < rightName;
+        case Criterion::ModificationTime:
+        case Criterion::CaptureTime:
+            if (const qint64 left {getTime(m_criterion, leftKeys)}, right {getTime(m_criterion, rightKeys)}; left != right)
+                return left < right;
+            [[fallthrough]];
+        default:
+            // Names differing just in the leading zeros or the letter case still need a stable order.
+            if (const int result {compareNames(leftName, leftKeys, rightName, rightKeys)}; result != 0)
+                return result < 0;
+            return leftName < rightName;
+    }
+}
+
+std::vector<quint32> CatalogOrder::sort(const StringArena &names, std::vector<Keys> &keys) const
+{
+    std::vector<quint32> positions(names.size());
+    std::iota(positions.begin(), positions.end(), 0);
+
+    for (const quint32 position : positions)
+        deriveKeys(names[position], keys[position]);
+
+    std::sort(positions.begin(), positions.end(), [this, &names, &keys](const quint32 left, const quint32 right) {
+        return lessThan(names[left], keys[left], names[right], keys[right]);
+    });
+
+    return positions;
+}
+
+QString CatalogOrder::naturalSortKey(const QStringView name)
+{
+    QString key;
+    key.reserve(name.size() + 8);
+    for (qsizetype i = 0; i < name.size();)
+    {
+        if (!name[i].isDigit())
+        {
+            key.append(name[i].toCaseFolded());
+            ++i;
+            continue;
+        }
+
+        qsizetype end {i};
+        while (end < name.size() && name[end].isDigit())
+            ++end;
+
+        // Leading zeros do not count, but the zero itself does.
+        while (i < end - 1 && name[i].digitValue() == 0)
+            ++i;
+
+        // The digit marker keeps the numbers where the digits were among the other characters.
+        key.append(QLatin1Char('0'));
+        key.append(QChar(static_cast<char16_t>(std::min<qsizetype>(end - i, 0xFFFF))));
+        for (; i < end; ++i)
+            key.append(QChar(static_cast<char16_t>(u'0' + name[i].digitValue())));
+    }
+
+    return key;
+}
+
+qint64 CatalogOrder::getTime(const Criterion criterion, const Keys &keys)
+{
+    return criterion == Criterion::CaptureTime ? keys.captureTime : keys.modificationTime;
+}
+
+int CatalogOrder::compareNames(const QStringView leftName, const Keys &leftKeys, const QStringView rightName, const Keys &rightKeys) const
+{
+    if (m_criterion == Criterion::Locale)
+    {
+        if (leftKeys.collationKey && rightKeys.collationKey)
+            return leftKeys.collationKey->compare(*rightKeys.collationKey);
+        return m_collator.compare(leftName, rightName);
+    }
+
+    if (!leftKeys.naturalKey.isNull() && !rightKeys.naturalKey.isNull())
+        return leftKeys.naturalKey.compare(rightKeys.naturalKey);
+    return naturalSortKey(leftName).compare(naturalSortKey(rightName));
+}
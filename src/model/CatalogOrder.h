@@ -0,0 +1,82 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "../util/StringArena.h"
+#include <QCollator>
+#include <QDateTime>
+#include <QString>
+#include <QStringView>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <vector>
+
+/// Order of the catalog items. The keys are gathered once and kept with the items, so neither re-sorting nor merging
+/// the new items touches the files again or derives the keys from the names in every comparison.
+class CatalogOrder
+{
+public:
+    enum class Criterion
+    {
+        /// Plain comparison of the UTF-16 code units
+        Name,
+        /// Numbers compared by their value, "IMG_9" goes before "IMG_10", letter case is ignored
+        Natural,
+        /// Collation of the locale
+        Locale,
+        ModificationTime,
+        /// EXIF DateTimeOriginal, the modification time is used for the images without it
+        CaptureTime,
+    };
+
+    static constexpr qint64 m_unknown {std::numeric_limits<qint64>::min()};
+
+    /// Keys gathered from the file, in milliseconds since the epoch, and the ones derived from the name.
+    struct Keys
+    {
+        qint64 modificationTime {m_unknown};
+        qint64 captureTime {m_unknown};
+        /// Compared by all the orders but the Name and Locale ones, null until derived
+        QString naturalKey {};
+        /// Compared by the Locale order
+        std::optional<QCollatorSortKey> collationKey {};
+    };
+
+    using CaptureTimeReader = std::function<QDateTime(const QString &fileName)>;
+
+    explicit CatalogOrder(Criterion criterion = Criterion::Name, const QLocale &locale = QLocale());
+
+    [[nodiscard]] Criterion getCriterion() const;
+    /// True if the criterion needs the keys gathered from the files.
+    [[nodiscard]] bool needsKeys() const;
+    /// True if the keys gathered from the file are known.
+    [[nodiscard]] bool hasKeys(const Keys &keys) const;
+    /// Fills in the keys needed by the criterion and not known yet. Reads the file, so it belongs to a worker thread.
+    void gatherKeys(const QString &directory, const QString &name, Keys &keys, const CaptureTimeReader &captureTimeReader) const;
+    /// Fills in the key derived from the name if it is missing, the ones of the other criteria are dropped.
+    void deriveKeys(QStringView name, Keys &keys) const;
+
+    /// Compares the keys derived from the names, the missing ones are derived for the comparison.
+    [[nodiscard]] bool lessThan(QStringView leftName, const Keys &leftKeys, QStringView rightName, const Keys &rightKeys) const;
+    /// Returns the positions of the items in the sorted order. The missing keys derived from the names are filled in first.
+    [[nodiscard]] std::vector<quint32> sort(const StringArena &names, std::vector<Keys> &keys) const;
+
+    /// The key ordering the names naturally when compared as plain strings. Digit runs are replaced by their
+    /// length followed by the significant digits, so the longer numbers go after the shorter ones.
+    [[nodiscard]] static QString naturalSortKey(QStringView name);
+
+private:
+    [[nodiscard]] static qint64 getTime(Criterion criterion, const Keys &keys);
+    [[nodiscard]] int compareNames(QStringView leftName, const Keys &leftKeys, QStringView rightName, const Keys &rightKeys) const;
+
+    Criterion m_criterion;
+    QCollator m_collator;
+};
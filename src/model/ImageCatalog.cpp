@@ -10,34 +10,176 @@ VookiImageViewer - a tool for showing images.
 
 #include "ImageCatalog.h"
 
+#include <QDateTime>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QPromise>
+#include <QSet>
+#include <QtConcurrent>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <unordered_set>
 #include <utility>
 
-ImageCatalog::ImageCatalog(QStringList filter)
-                                        : m_filter(std::move(filter))
+namespace
 {
+    qint64 getModificationTime(const QString &path)
+    {
+        return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    }
+
+    struct StringViewHash
+    {
+        std::size_t operator()(const QStringView string) const
+        {
+            return qHash(string);
+        }
+    };
+
+    /// Gathers the keys needed by the order in parallel and sorts the items by it. The keys derived from the names
+    /// are kept with the items, so merging them into the catalog on the GUI thread just compares those.
+    void prepareItems(const QString &directory, ImageCatalog::Items &items, const CatalogOrder &order,
+                      const CatalogOrder::CaptureTimeReader &captureTimeReader, QThreadPool *pool)
+    {
+        if (order.getCriterion() != CatalogOrder::Criterion::Name)
+        {
+            QtConcurrent::blockingMap(pool, items, [&directory, &order, &captureTimeReader](ImageCatalog::Item &item) {
+                order.gatherKeys(directory, item.first, item.second, captureTimeReader);
+            });
+        }
+
+        std::sort(items.begin(), items.end(), [&order](const ImageCatalog::Item &left, const ImageCatalog::Item &right) {
+            return order.lessThan(left.first, left.second, right.first, right.second);
+        });
+    }
+} // namespace
+
+ImageCatalog::ImageCatalog(QStringList filter, QObject *parent)
+                                        : QObject(parent)
+                                        , m_filter(std::move(filter))
+{
+    // A single thread drives the enumeration, the directories themselves are listed on the walking threads.
+    m_threadPool.setMaxThreadCount(1);
+    m_walkPool.setMaxThreadCount(m_walkThreadCount);
+
+    m_rescanTimer.setSingleShot(true);
+    m_rescanTimer.setInterval(m_rescanDelay);
+    QObject::connect(&m_rescanTimer, &QTimer::timeout, this, &ImageCatalog::onRescanTimeout);
+    QObject::connect(&m_directoryWatcher, &QFileSystemWatcher::directoryChanged, &m_rescanTimer, qOverload<>(&QTimer::start));
+}
+
+ImageCatalog::~ImageCatalog()
+{
+    if (m_enumeration)
+        m_enumeration->cancel();
+
+    if (m_rescan)
+        m_rescan->cancel();
+
+    if (m_keyGathering)
+        m_keyGathering->cancel();
+
+    m_threadPool.waitForDone();
+    m_walkPool.waitForDone();
+    m_keyPool.waitForDone();
 }
 
 void ImageCatalog::initialize(const QFile &imageFile)
 {
     const QFileInfo info(imageFile);
-    const QString &filename {info.fileName()};
-    m_absoluteDir = info.absoluteDir().canonicalPath();
     initialize(info.absoluteDir());
 
-    for (const QString &item : m_catalog)
+    const qsizetype index {m_catalog.indexOf(info.fileName())};
+    m_catalogIndex.reset(std::max<qsizetype>(index, 0));
+}
+
+void ImageCatalog::initialize(const QDir &imageDir)
+{
+    cancelBackgroundWork();
+
+    const QString directory {imageDir.canonicalPath()};
+    Items items;
+    if (!directory.isEmpty())
     {
-        if (item.compare(filename) == 0)
-            break;
-        ++m_catalogIndex;
+        QMutex mutex;
+        walkDirectory(directory, m_filter, m_recursion, &m_walkPool, [&items, &mutex](QStringList fileNames) {
+            const QMutexLocker locker {&mutex};
+            for (QString &fileName : fileNames)
+                items.emplace_back(std::move(fileName), CatalogOrder::Keys {});
+            return true;
+        });
     }
+
+    prepareItems(directory, items, m_order, m_captureTimeReader, &m_keyPool);
+    reset(directory, std::move(items));
 }
 
-void ImageCatalog::initialize(const QDir &imageDir)
+void ImageCatalog::initializeAsync(const QFile &imageFile)
 {
-    m_absoluteDir = imageDir.canonicalPath();
-    m_catalog = imageDir.entryList(m_filter, QDir::Filter::Files);
-    m_catalog.sort();
-    m_catalogIndex.set(0, m_catalog.size());
+    cancelBackgroundWork();
+
+    const QFileInfo info(imageFile);
+    const QString directory {info.absoluteDir().canonicalPath()};
+    const bool isImage {info.isFile() && (m_filter.isEmpty() || QDir::match(m_filter, info.fileName()))};
+    if (loadIndex(directory))
+    {
+        // The image might be newer than the index, it is the current one anyway.
+        if (isImage && m_catalog.indexOf(info.fileName()) < 0)
+        {
+            Items items {{info.fileName(), CatalogOrder::Keys {}}};
+            m_order.gatherKeys(directory, items.back().first, items.back().second, m_captureTimeReader);
+            insertItems(items);
+        }
+
+        m_catalogIndex.reset(std::max<qsizetype>(m_catalog.indexOf(info.fileName()), 0));
+        return;
+    }
+
+    Items items;
+    if (isImage)
+    {
+        // The enumeration finds the file again, its keys have to match for it to be recognized.
+        items.emplace_back(info.fileName(), CatalogOrder::Keys {});
+        m_order.gatherKeys(directory, items.back().first, items.back().second, m_captureTimeReader);
+    }
+
+    reset(directory, std::move(items));
+    startEnumeration();
+}
+
+void ImageCatalog::initializeAsync(const QDir &imageDir)
+{
+    cancelBackgroundWork();
+    if (const QString directory {imageDir.canonicalPath()}; !loadIndex(directory))
+    {
+        reset(directory, {});
+        startEnumeration();
+    }
+}
+
+void ImageCatalog::setIndexDirectory(const QString &directory)
+{
+    if (directory.isEmpty())
+        m_index.reset();
+    else
+        m_index.emplace(directory);
+}
+
+void ImageCatalog::setRecursion(const Recursion recursion)
+{
+    m_recursion = recursion;
+}
+
+ImageCatalog::Recursion ImageCatalog::getRecursion() const
+{
+    return m_recursion;
+}
+
+bool ImageCatalog::isEnumerating() const
+{
+    return m_enumeration != nullptr;
 }
 
 qsizetype ImageCatalog::getCatalogSize() const
@@ -45,6 +187,21 @@ qsizetype ImageCatalog::getCatalogSize() const
     return m_catalog.size();
 }
 
+QString ImageCatalog::getDirectory() const
+{
+    return m_absoluteDir;
+}
+
+QStringList ImageCatalog::getItems() const
+{
+    QStringList items;
+    items.reserve(m_catalog.size());
+    for (qsizetype position = 0; position < m_catalog.size(); ++position)
+        items.append(m_catalog[position].toString());
+
+    return items;
+}
+
 QString ImageCatalog::getCurrent() const
 {
     return getCatalogItem(m_catalogIndex);
@@ -60,10 +217,621 @@ QString ImageCatalog::getPrevious()
     return getCatalogItem(--m_catalogIndex);
 }
 
+QStringList ImageCatalog::getNeighbours(const qsizetype nextCount, const qsizetype previousCount) const
+{
+    QStringList neighbours;
+    if (m_catalog.isEmpty())
+        return neighbours;
+
+    auto nextIndex {m_catalogIndex};
+    auto previousIndex {m_catalogIndex};
+
+    // Neighbours are ordered by their distance from the current item, the following ones go first.
+    for (qsizetype i = 0; i < std::max(nextCount, previousCount); ++i)
+    {
+        if (i < nextCount && ++nextIndex != m_catalogIndex)
+        {
+            if (const QString item {getCatalogItem(nextIndex)}; !neighbours.contains(item))
+                neighbours.append(item);
+        }
+
+        if (i < previousCount && --previousIndex != m_catalogIndex)
+        {
+            if (const QString item {getCatalogItem(previousIndex)}; !neighbours.contains(item))
+                neighbours.append(item);
+        }
+    }
+
+    return neighbours;
+}
+
+QString ImageCatalog::getFileName(const qsizetype index) const
+{
+    if (index < 0 || index >= getCatalogSize())
+        return {};
+
+    return makeFilePath(index);
+}
+
+qsizetype ImageCatalog::indexOf(const QString &fileName) const
+{
+    // Items of the subdirectories are the paths relative to the catalog directory.
+    const QString filePath {QFileInfo(fileName).absoluteFilePath()};
+    if (m_catalog.isEmpty() || filePath.size() <= m_absoluteDir.size() || !filePath.startsWith(m_absoluteDir)
+        || filePath[m_absoluteDir.size()] != QLatin1Char('/'))
+        return -1;
+
+    return m_catalog.indexOf(QStringView {filePath}.sliced(m_absoluteDir.size() + 1));
+}
+
+qsizetype ImageCatalog::getCurrentIndex() const
+{
+    return m_catalog.isEmpty() ? -1 : static_cast<qsizetype>(m_catalogIndex);
+}
+
+QString ImageCatalog::setCurrentIndex(const qsizetype index)
+{
+    if (index < 0 || index >= getCatalogSize())
+        return {};
+
+    m_catalogIndex.reset(index);
+    return getCurrent();
+}
+
+CatalogOrder::Criterion ImageCatalog::getSortCriterion() const
+{
+    return m_pendingCriterion.value_or(m_order.getCriterion());
+}
+
+void ImageCatalog::setSortCriterion(const CatalogOrder::Criterion criterion)
+{
+    m_pendingCriterion = criterion;
+
+    // Batches being enumerated are sorted by the former order, so they are merged first.
+    if (m_enumeration || m_keyGathering)
+        return;
+
+    applyPendingCriterion();
+}
+
+void ImageCatalog::setCaptureTimeReader(CatalogOrder::CaptureTimeReader captureTimeReader)
+{
+    m_captureTimeReader = std::move(captureTimeReader);
+}
+
 QString ImageCatalog::getCatalogItem(const RotatingIndex<QIntegerForSizeof<std::size_t>::Unsigned> &catalogIndex) const
 {
     if (m_catalog.isEmpty())
         return {};
 
-    return QFileInfo{m_absoluteDir + QDir::separator() + m_catalog.at(catalogIndex)}.canonicalFilePath();
+    return makeFilePath(catalogIndex);
+}
+
+QString ImageCatalog::makeFilePath(const qsizetype index) const
+{
+    // The directory is canonical already, so the navigation does not touch the file system.
+    const QStringView item {m_catalog.at(index)};
+    QString filePath;
+    filePath.reserve(m_absoluteDir.size() + 1 + item.size());
+    return filePath.append(m_absoluteDir).append(QLatin1Char('/')).append(item);
+}
+
+qsizetype ImageCatalog::lowerBound(const QStringView name, const CatalogOrder::Keys &keys, qsizetype first) const
+{
+    qsizetype count {getCatalogSize() - first};
+    while (count > 0)
+    {
+        const qsizetype step {count / 2};
+        if (const qsizetype middle {first + step}; m_order.lessThan(m_catalog[middle], m_keys[middle], name, keys))
+        {
+            first = middle + 1;
+            count -= step + 1;
+        }
+        else
+            count = step;
+    }
+
+    return first;
+}
+
+void ImageCatalog::insertItems(const Items &items)
+{
+    // The hash index finds the items already there, without comparing them in the current order.
+    Items fresh;
+    fresh.reserve(items.size());
+    std::ranges::copy_if(items, std::back_inserter(fresh), [this](const Item &item) { return m_catalog.indexOf(item.first) < 0; });
+    if (fresh.empty())
+        return;
+
+    const auto size {getCatalogSize()};
+    const qsizetype current {m_catalog.isEmpty() ? 0 : static_cast<qsizetype>(m_catalogIndex)};
+
+    // Items falling into a single gap, e.g. the batches listed in the sorted order, are inserted as a single run.
+    const qsizetype position {lowerBound(fresh.front().first, fresh.front().second, 0)};
+    if (position == size || m_order.lessThan(fresh.back().first, fresh.back().second, m_catalog[position], m_keys[position]))
+    {
+        const auto count {static_cast<qsizetype>(fresh.size())};
+        emit itemsAboutToBeInserted(position, count);
+        const auto names {fresh | std::views::keys};
+        m_catalog.insert(position, names.begin(), names.end());
+        const auto keys {fresh | std::views::values};
+        m_keys.insert(m_keys.begin() + position, keys.begin(), keys.end());
+        // The current item stays the same, so the shown image does not change under the user.
+        m_catalogIndex.set(size > 0 && position <= current ? current + count : current, m_catalog.size());
+        emit itemsInserted(position, count);
+        return;
+    }
+
+    // Scattered items are merged in a single pass into new arrays, instead of shifting the catalog for every gap.
+    StringArena catalog;
+    std::vector<CatalogOrder::Keys> keys;
+    qsizetype characters {0};
+    for (qsizetype i = 0; i < size; ++i)
+        characters += m_catalog[i].size();
+    for (const Item &item : fresh)
+        characters += item.first.size();
+    catalog.reserve(size + static_cast<qsizetype>(fresh.size()), characters);
+    keys.reserve(static_cast<std::size_t>(size) + fresh.size());
+
+    qsizetype mergedCurrent {current};
+    auto item {fresh.cbegin()};
+    for (qsizetype i = 0; i < size; ++i)
+    {
+        for (; item != fresh.cend() && m_order.lessThan(item->first, item->second, m_catalog[i], m_keys[i]); ++item)
+        {
+            catalog.append(item->first);
+            keys.push_back(item->second);
+            if (i <= current)
+                ++mergedCurrent;
+        }
+
+        catalog.append(m_catalog[i]);
+        keys.push_back(m_keys[i]);
+    }
+
+    for (; item != fresh.cend(); ++item)
+    {
+        catalog.append(item->first);
+        keys.push_back(item->second);
+    }
+
+    m_catalog = std::move(catalog);
+    m_keys = std::move(keys);
+    m_catalogIndex.set(mergedCurrent, m_catalog.size());
+    emit itemsMerged(static_cast<qsizetype>(fresh.size()));
+}
+
+void ImageCatalog::removeItems(const qsizetype first, const qsizetype count)
+{
+    const qsizetype current {static_cast<qsizetype>(m_catalogIndex)};
+    const bool isCurrentRemoved {current >= first && current < first + count};
+
+    emit itemsAboutToBeRemoved(first, count);
+    m_catalog.remove(first, count);
+    m_keys.erase(m_keys.begin() + first, m_keys.begin() + first + count);
+    if (current >= first + count)
+        m_catalogIndex.set(current - count, m_catalog.size());
+    else if (isCurrentRemoved && !m_catalog.isEmpty())
+        m_catalogIndex.set(std::min(first, m_catalog.size() - 1), m_catalog.size());
+    emit itemsRemoved(first, count);
+
+    if (isCurrentRemoved)
+        emit currentItemRemoved();
+}
+
+void ImageCatalog::applyListing(const QStringList &items, const bool isWatched)
+{
+    // The catalog is not sorted by the names, so both are compared through the hashes.
+    Items added;
+    for (const QString &item : items)
+    {
+        if (m_catalog.indexOf(item) < 0)
+            added.emplace_back(item, CatalogOrder::Keys {});
+    }
+
+    const std::unordered_set<QStringView, StringViewHash> listed(items.cbegin(), items.cend());
+    std::vector<std::pair<qsizetype, qsizetype>> removed;
+    for (qsizetype position = 0; position < getCatalogSize(); ++position)
+    {
+        if (listed.contains(m_catalog[position]))
+            continue;
+
+        if (!removed.empty() && removed.back().first + removed.back().second == position)
+            ++removed.back().second;
+        else
+            removed.emplace_back(position, 1);
+    }
+
+    // Removed from the back, the positions of the preceding runs stay valid then.
+    for (auto run {removed.crbegin()}; run != removed.crend(); ++run)
+        removeItems(run->first, run->second);
+
+    if (added.empty())
+        return;
+
+    // Just a few files are added at once, their keys are read right away.
+    for (auto &[name, keys] : added)
+        m_order.gatherKeys(m_absoluteDir, name, keys, m_captureTimeReader);
+
+    std::sort(added.begin(), added.end(), [this](const Item &left, const Item &right) {
+        return m_order.lessThan(left.first, left.second, right.first, right.second);
+    });
+    insertItems(added);
+    if (!isWatched)
+        return;
+
+    QString newestFileName;
+    QDateTime newestModification;
+    for (const Item &item : added)
+    {
+        const QFileInfo info {m_absoluteDir + QLatin1Char('/') + item.first};
+        if (newestFileName.isEmpty() || info.lastModified() > newestModification)
+        {
+            newestFileName = info.filePath();
+            newestModification = info.lastModified();
+        }
+    }
+
+    emit itemsAdded(newestFileName);
+}
+
+void ImageCatalog::reset(const QString &absoluteDir, Items items)
+{
+    StringArena catalog;
+    std::vector<CatalogOrder::Keys> keys;
+    keys.reserve(items.size());
+    for (const auto &[name, itemKeys] : items)
+    {
+        catalog.append(name);
+        keys.push_back(itemKeys);
+    }
+
+    reset(absoluteDir, std::move(catalog), std::move(keys));
+}
+
+void ImageCatalog::reset(const QString &absoluteDir, StringArena catalog, std::vector<CatalogOrder::Keys> keys)
+{
+    cancelRescan();
+    if (const QStringList directories {m_directoryWatcher.directories()}; !directories.isEmpty())
+        m_directoryWatcher.removePaths(directories);
+
+    m_absoluteDir = absoluteDir;
+    m_catalog = std::move(catalog);
+    m_keys = std::move(keys);
+    m_catalogIndex.set(0, m_catalog.size());
+    if (!m_absoluteDir.isEmpty())
+        m_directoryWatcher.addPath(m_absoluteDir);
+
+    emit catalogReset();
+}
+
+QString ImageCatalog::indexPath(const QString &absoluteDir) const
+{
+    return m_index->indexPath(absoluteDir, m_filter.join(QLatin1Char(';')) + QStringLiteral("|%1|%2").arg(m_recursion.maxDepth).arg(m_recursion.followSymlinks));
+}
+
+bool ImageCatalog::loadIndex(const QString &absoluteDir)
+{
+    CatalogIndex::Contents contents;
+    if (!m_index || absoluteDir.isEmpty() || !CatalogIndex::load(indexPath(absoluteDir), contents))
+        return false;
+
+    const CatalogOrder::Criterion criterion {m_order.getCriterion()};
+    m_order = CatalogOrder {contents.criterion};
+    reset(absoluteDir, std::move(contents.names), std::move(contents.keys));
+    m_listedModificationTime = contents.directoryModificationTime;
+
+    // The index might have been sorted by another criterion, the keys are mostly at hand though. The keys derived
+    // from the names are not stored, the re-sorting derives them anyway.
+    if (contents.criterion != criterion)
+        setSortCriterion(criterion);
+    else if (criterion != CatalogOrder::Criterion::Name)
+    {
+        QtConcurrent::blockingMap(&m_keyPool, m_keys, [this](CatalogOrder::Keys &keys) {
+            m_order.deriveKeys(m_catalog[&keys - m_keys.data()], keys);
+        });
+    }
+
+    // The modified directory is patched by the differences. The modification time does not cover the subdirectories,
+    // so those are listed again always.
+    if (m_recursion.maxDepth > 0 || getModificationTime(absoluteDir) != m_listedModificationTime)
+    {
+        m_isIndexRescan = true;
+        onRescanTimeout();
+    }
+
+    // Nothing is enumerated, still the catalog is as complete as the enumerated one.
+    QMetaObject::invokeMethod(this, &ImageCatalog::enumerationFinished, Qt::QueuedConnection);
+    return true;
+}
+
+void ImageCatalog::storeIndex()
+{
+    if (!m_index || m_absoluteDir.isEmpty())
+        return;
+
+    const bool isPruneDue {++m_storedSincePrune % CatalogIndex::m_pruneInterval == 0};
+    m_threadPool.start([index = *m_index, isPruneDue, path = indexPath(m_absoluteDir),
+                        contents = CatalogIndex::Contents {m_listedModificationTime, m_order.getCriterion(), m_catalog, m_keys}]() {
+        if (CatalogIndex::store(path, contents) && isPruneDue)
+            index.prune();
+    });
+}
+
+void ImageCatalog::startEnumeration()
+{
+    // The non-existing directory has no canonical path, the iterator would list the working directory instead.
+    if (m_absoluteDir.isEmpty())
+    {
+        emit enumerationFinished();
+        return;
+    }
+
+    // Taken before the listing, the changes made meanwhile make the index outdated then.
+    m_listedModificationTime = getModificationTime(m_absoluteDir);
+
+    m_enumeration = std::make_unique<QFutureWatcher<Items>>();
+    QObject::connect(m_enumeration.get(), &QFutureWatcher<Items>::resultsReadyAt, this, &ImageCatalog::onResultsReady);
+    QObject::connect(m_enumeration.get(), &QFutureWatcher<Items>::finished, this, &ImageCatalog::onFinished);
+    m_enumeration->setFuture(QtConcurrent::run(&m_threadPool,
+                                               [directory = m_absoluteDir, filter = m_filter, recursion = m_recursion, criterion = m_order.getCriterion(),
+                                                captureTimeReader = m_captureTimeReader, walkPool = &m_walkPool, keyPool = &m_keyPool](QPromise<Items> &promise) {
+        walkDirectory(directory, filter, recursion, walkPool, [&promise, &directory, criterion, &captureTimeReader, keyPool](QStringList fileNames) {
+            if (promise.isCanceled())
+                return false;
+
+            // The collator is shared neither with the GUI thread nor among the walking threads.
+            const CatalogOrder order {criterion};
+            Items batch;
+            batch.reserve(fileNames.size());
+            for (QString &fileName : fileNames)
+                batch.emplace_back(std::move(fileName), CatalogOrder::Keys {});
+
+            // Sorted batches are merged into the catalog in a single pass.
+            prepareItems(directory, batch, order, captureTimeReader, keyPool);
+            promise.addResult(std::move(batch));
+            return true;
+        });
+    }));
+}
+
+void ImageCatalog::walkDirectory(const QString &root, const QStringList &filter, const Recursion &recursion, QThreadPool *pool,
+                                 const BatchHandler &handler)
+{
+    std::atomic<bool> isStopped {false};
+    QSet<QString> visited {QFileInfo(root).canonicalFilePath()};
+    QStringList level {QString {}};
+
+    for (int depth = 0; !level.isEmpty() && !isStopped; ++depth)
+    {
+        const bool listSubdirectories {depth < recursion.maxDepth};
+        const auto subdirectories {QtConcurrent::blockingMapped<QList<QStringList>>(pool, level, [&](const QString &relativeDir) {
+            return listDirectory(root, relativeDir, filter, listSubdirectories, recursion.followSymlinks, handler, isStopped);
+        })};
+
+        level.clear();
+        for (const QStringList &directories : subdirectories)
+        {
+            for (const QString &directory : directories)
+            {
+                // Links might lead to a directory listed already, even to an ancestor one.
+                if (recursion.followSymlinks)
+                {
+                    const QString canonicalPath {QFileInfo(root + QLatin1Char('/') + directory).canonicalFilePath()};
+                    if (visited.contains(canonicalPath))
+                        continue;
+
+                    visited.insert(canonicalPath);
+                }
+
+                level.append(directory);
+            }
+        }
+    }
+}
+
+QStringList ImageCatalog::listDirectory(const QString &root, const QString &relativeDir, const QStringList &filter,
+                                        const bool listSubdirectories, const bool followSymlinks, const BatchHandler &handler,
+                                        std::atomic<bool> &isStopped)
+{
+    const QString prefix {relativeDir.isEmpty() ? QString {} : relativeDir + QLatin1Char('/')};
+    QDir::Filters filters {QDir::Filter::Files};
+    // The name filter does not apply to the directories then.
+    if (listSubdirectories)
+        filters |= QDir::Filter::AllDirs | QDir::Filter::NoDotAndDotDot;
+
+    QDirIterator iterator {prefix.isEmpty() ? root : root + QLatin1Char('/') + relativeDir, filter, filters};
+    QStringList subdirectories;
+    QStringList batch;
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto flush = [&handler, &isStopped, &batch, &timer]() {
+        if (!handler(std::exchange(batch, {})))
+            isStopped = true;
+        timer.restart();
+    };
+
+    while (iterator.hasNext() && !isStopped)
+    {
+        iterator.next();
+        if (const QFileInfo info {iterator.fileInfo()}; info.isDir())
+        {
+            if (followSymlinks || !info.isSymLink())
+                subdirectories.append(prefix + info.fileName());
+            continue;
+        }
+
+        batch.append(prefix + iterator.fileName());
+        if (batch.size() >= m_batchSize || timer.hasExpired(m_batchInterval))
+            flush();
+    }
+
+    if (!batch.isEmpty() && !isStopped)
+        flush();
+
+    return subdirectories;
+}
+
+void ImageCatalog::cancelEnumeration()
+{
+    if (!m_enumeration)
+        return;
+
+    // The results already queued for the cancelled enumeration must not be delivered, so its watcher goes away.
+    m_enumeration->disconnect(this);
+    m_enumeration->cancel();
+    m_enumeration.release()->deleteLater();
+}
+
+void ImageCatalog::cancelRescan()
+{
+    m_isIndexRescan = false;
+    m_rescanTimer.stop();
+    if (!m_rescan)
+        return;
+
+    m_rescan->disconnect(this);
+    m_rescan->cancel();
+    m_rescan.release()->deleteLater();
+}
+
+void ImageCatalog::cancelKeyGathering()
+{
+    if (!m_keyGathering)
+        return;
+
+    m_keyGathering->disconnect(this);
+    m_keyGathering->cancel();
+    m_keyGathering.release()->deleteLater();
+}
+
+void ImageCatalog::cancelBackgroundWork()
+{
+    cancelEnumeration();
+    cancelKeyGathering();
+
+    if (m_pendingCriterion)
+        m_order = CatalogOrder {*std::exchange(m_pendingCriterion, std::nullopt)};
+}
+
+void ImageCatalog::applyPendingCriterion()
+{
+    if (!m_pendingCriterion)
+        return;
+
+    const CatalogOrder order {*m_pendingCriterion};
+    Items missing;
+    for (qsizetype position = 0; position < getCatalogSize(); ++position)
+    {
+        if (!order.hasKeys(m_keys[position]))
+            missing.emplace_back(m_catalog[position].toString(), m_keys[position]);
+    }
+
+    if (missing.empty())
+    {
+        m_pendingCriterion.reset();
+        sortCatalog(order);
+        return;
+    }
+
+    m_keyGathering = std::make_unique<QFutureWatcher<Item>>();
+    QObject::connect(m_keyGathering.get(), &QFutureWatcher<Item>::finished, this, &ImageCatalog::onKeysGathered);
+    m_keyGathering->setFuture(QtConcurrent::mapped(&m_keyPool, std::move(missing),
+                                                   [directory = m_absoluteDir, order, captureTimeReader = m_captureTimeReader](Item item) {
+        order.gatherKeys(directory, item.first, item.second, captureTimeReader);
+        return item;
+    }));
+}
+
+void ImageCatalog::sortCatalog(const CatalogOrder &order)
+{
+    m_order = order;
+    if (m_catalog.isEmpty())
+    {
+        emit catalogSorted();
+        return;
+    }
+
+    // Just the positions are sorted, the keys are at hand, so no file is touched.
+    const std::vector<quint32> positions {m_order.sort(m_catalog, m_keys)};
+    const auto current {static_cast<quint32>(static_cast<qsizetype>(m_catalogIndex))};
+
+    m_catalog.reorder(positions);
+    std::vector<CatalogOrder::Keys> keys;
+    keys.reserve(positions.size());
+    for (const quint32 position : positions)
+        keys.push_back(m_keys[position]);
+    m_keys = std::move(keys);
+
+    const auto currentPosition {std::distance(positions.cbegin(), std::find(positions.cbegin(), positions.cend(), current))};
+    m_catalogIndex.reset(static_cast<qsizetype>(currentPosition));
+    storeIndex();
+    emit catalogSorted();
+}
+
+void ImageCatalog::onResultsReady(const int begin, const int end)
+{
+    for (int i = begin; i < end; ++i)
+        insertItems(m_enumeration->resultAt(i));
+}
+
+void ImageCatalog::onFinished()
+{
+    m_enumeration->disconnect(this);
+    m_enumeration.release()->deleteLater();
+    applyPendingCriterion();
+    storeIndex();
+    emit enumerationFinished();
+}
+
+void ImageCatalog::onRescanTimeout()
+{
+    // The enumeration might have listed the changed part of the directory already, so it is looked at afterwards.
+    if (m_enumeration || m_rescan)
+    {
+        m_rescanTimer.start();
+        return;
+    }
+
+    m_rescanModificationTime = getModificationTime(m_absoluteDir);
+    m_rescan = std::make_unique<QFutureWatcher<QStringList>>();
+    QObject::connect(m_rescan.get(), &QFutureWatcher<QStringList>::finished, this, &ImageCatalog::onRescanFinished);
+    m_rescan->setFuture(QtConcurrent::run(&m_threadPool, [directory = m_absoluteDir, filter = m_filter, recursion = m_recursion,
+                                                          walkPool = &m_walkPool](QPromise<QStringList> &promise) {
+        QMutex mutex;
+        QStringList items;
+        walkDirectory(directory, filter, recursion, walkPool, [&promise, &mutex, &items](const QStringList &fileNames) {
+            const QMutexLocker locker {&mutex};
+            items.append(fileNames);
+            return !promise.isCanceled();
+        });
+        promise.addResult(items);
+    }));
+}
+
+void ImageCatalog::onRescanFinished()
+{
+    const QStringList items {m_rescan->result()};
+    m_rescan->disconnect(this);
+    m_rescan.release()->deleteLater();
+    applyListing(items, !std::exchange(m_isIndexRescan, false));
+    m_listedModificationTime = m_rescanModificationTime;
+    storeIndex();
+}
+
+void ImageCatalog::onKeysGathered()
+{
+    const QList<Item> items {m_keyGathering->future().results()};
+    m_keyGathering->disconnect(this);
+    m_keyGathering.release()->deleteLater();
+
+    // Items might have come and gone meanwhile, so the keys are matched by the names.
+    for (const auto &[name, keys] : items)
+    {
+        if (const qsizetype position {m_catalog.indexOf(name)}; position >= 0)
+            m_keys[position] = keys;
+    }
+
+    applyPendingCriterion();
 }
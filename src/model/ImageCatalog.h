@@ -9,33 +9,197 @@ VookiImageViewer - a tool for showing images.
 
 ****************************************************************************/
 
+#include "CatalogIndex.h"
+#include "CatalogOrder.h"
 #include "../util/RotatingIndex.h"
+#include "../util/StringArena.h"
 #include "../util/compiler.h"
 #include <QDir>
 #include <QFile>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QObject>
 #include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
-class ImageCatalog
+class ImageCatalog : public QObject
 {
+    Q_OBJECT
+
 public:
-    explicit ImageCatalog(QStringList filter);
+    /// File name with its sort keys
+    using Item = std::pair<QString, CatalogOrder::Keys>;
+    using Items = std::vector<Item>;
+
+    /// Subdirectories enumerated along with the directory. Their items are the paths relative to the directory,
+    /// so the navigation goes across the directory boundaries.
+    struct Recursion
+    {
+        /// Levels of the subdirectories, 0 enumerates just the directory itself
+        int maxDepth {0};
+        /// Every directory is enumerated once, even if it is linked several times or the links make a cycle
+        bool followSymlinks {false};
+    };
+
+    explicit ImageCatalog(QStringList filter, QObject *parent = nullptr);
+    ~ImageCatalog() override;
     DISABLE_COPY_MOVE(ImageCatalog);
 
     void initialize(const QFile &imageFile);
     void initialize(const QDir &imageDir);
+    /// The image file is the only item at first, so it could be shown right away. The rest of the directory
+    /// is enumerated on the worker thread and merged in batches, the current item stays the same meanwhile.
+    /// The directory is watched then, the files added or removed later are merged the same way.
+    void initializeAsync(const QFile &imageFile);
+    void initializeAsync(const QDir &imageDir);
+    /// The catalogs of the asynchronously initialized directories are kept there, empty disables them. A directory
+    /// which has not been modified since then is not enumerated again, the modified one is patched by the changes.
+    void setIndexDirectory(const QString &directory);
+    /// Takes effect with the next initialization. Just the directory itself is watched for the changes,
+    /// the whole tree is enumerated again once it changes.
+    void setRecursion(Recursion recursion);
+    [[nodiscard]] Recursion getRecursion() const;
+    [[nodiscard]] bool isEnumerating() const;
 
     [[nodiscard]] qsizetype getCatalogSize() const;
+    /// The absolute directory the items are relative to.
+    [[nodiscard]] QString getDirectory() const;
+    /// Items relative to the directory, in the catalog order.
+    [[nodiscard]] QStringList getItems() const;
     [[nodiscard]] QString getCurrent() const;
     QString getNext();
     QString getPrevious();
+    [[nodiscard]] QStringList getNeighbours(qsizetype nextCount, qsizetype previousCount) const;
+    [[nodiscard]] QString getFileName(qsizetype index) const;
+    /// Returns -1 if the file is not in the catalog.
+    [[nodiscard]] qsizetype indexOf(const QString &fileName) const;
+    [[nodiscard]] qsizetype getCurrentIndex() const;
+    /// Makes the item of the given index the current one, returns it.
+    QString setCurrentIndex(qsizetype index);
+
+    [[nodiscard]] CatalogOrder::Criterion getSortCriterion() const;
+    /// Re-sorts the catalog, the current item stays the same. The keys not gathered yet are read from the files
+    /// in parallel first, so the catalog is sorted once catalogSorted() is emitted. While the directory is being
+    /// enumerated, the catalog is re-sorted after the enumeration.
+    void setSortCriterion(CatalogOrder::Criterion criterion);
+    /// Reads the capture time of the images for the CaptureTime order. Called from the worker threads.
+    void setCaptureTimeReader(CatalogOrder::CaptureTimeReader captureTimeReader);
+
+signals:
+    void catalogReset();
+    void itemsAboutToBeInserted(qsizetype first, qsizetype count);
+    void itemsInserted(qsizetype first, qsizetype count);
+    /// Items have been inserted at various positions at once, the current item stays the same.
+    void itemsMerged(qsizetype count);
+    void itemsAboutToBeRemoved(qsizetype first, qsizetype count);
+    void itemsRemoved(qsizetype first, qsizetype count);
+    /// The current item has been removed from the directory, the following one is the current one now.
+    void currentItemRemoved();
+    /// Files which appeared in the watched directory, the newest one by its modification time is reported.
+    void itemsAdded(const QString &newestFileName);
+    void enumerationFinished();
+    /// The items have been reordered, the current one included.
+    void catalogSorted();
 
 protected:
     [[nodiscard]] QString getCatalogItem(const RotatingIndex<QIntegerForSizeof<std::size_t>::Unsigned> &catalogIndex) const;
+    [[nodiscard]] QString makeFilePath(qsizetype index) const;
+    /// The first position, starting from the given one, whose item does not go before the given one.
+    [[nodiscard]] qsizetype lowerBound(QStringView name, const CatalogOrder::Keys &keys, qsizetype first) const;
+    /// Merges the items sorted by the current order into the catalog, the ones already there are skipped.
+    /// The items falling into a single gap are announced as inserted, the scattered ones are merged in a single
+    /// pass and announced by itemsMerged().
+    void insertItems(const Items &items);
+    void removeItems(qsizetype first, qsizetype count);
+    /// Brings the catalog in line with the directory listing. The files added to the watched directory are announced
+    /// by itemsAdded(), the ones found just by validating the index are not.
+    void applyListing(const QStringList &items, bool isWatched);
+    /// Takes the items sorted by the current order.
+    void reset(const QString &absoluteDir, Items items);
+    void reset(const QString &absoluteDir, StringArena catalog, std::vector<CatalogOrder::Keys> keys);
+    [[nodiscard]] QString indexPath(const QString &absoluteDir) const;
+    /// Fills the catalog from its index, returns false if there is none.
+    bool loadIndex(const QString &absoluteDir);
+    /// Stored on the worker thread.
+    void storeIndex();
+    void startEnumeration();
+    void cancelEnumeration();
+    void cancelRescan();
+    void cancelKeyGathering();
+    /// Cancels the enumeration and the key gathering, the next catalog is built in the pending order right away.
+    void cancelBackgroundWork();
+    /// Gathers the keys missing for the pending criterion, or sorts the catalog if there are none.
+    void applyPendingCriterion();
+    void sortCatalog(const CatalogOrder &order);
+
+private slots:
+    void onResultsReady(int begin, int end);
+    void onFinished();
+    void onRescanTimeout();
+    void onRescanFinished();
+    void onKeysGathered();
 
 private:
+    /// Receives the batches of the relative file paths, from several threads at once. Returns false to stop the walk.
+    using BatchHandler = std::function<bool(QStringList fileNames)>;
+
+    /// Lists the files of the directory tree level by level, the directories of a level are listed in parallel.
+    static void walkDirectory(const QString &root, const QStringList &filter, const Recursion &recursion, QThreadPool *pool,
+                              const BatchHandler &handler);
+    /// Hands over the files of a single directory in batches, returns its subdirectories if asked for them.
+    [[nodiscard]] static QStringList listDirectory(const QString &root, const QString &relativeDir, const QStringList &filter,
+                                                   bool listSubdirectories, bool followSymlinks, const BatchHandler &handler,
+                                                   std::atomic<bool> &isStopped);
+
+    // Resolved once, the items are just the file names in it.
     QString m_absoluteDir;
-    QStringList m_catalog;
+    StringArena m_catalog;
+    // Keys of the items in the catalog, kept at the same positions
+    std::vector<CatalogOrder::Keys> m_keys {};
     RotatingIndex<QIntegerForSizeof<std::size_t>::Unsigned> m_catalogIndex;
     QStringList m_filter;
+    Recursion m_recursion {};
+
+    std::optional<CatalogIndex> m_index {};
+    // Modification time of the directory when the catalog was listed, the index is valid as long as it stays the same
+    qint64 m_listedModificationTime {0};
+    qint64 m_rescanModificationTime {0};
+    int m_storedSincePrune {0};
+    // The rescan validates the index just loaded, rather than following the changes of the watched directory
+    bool m_isIndexRescan {false};
+
+    CatalogOrder m_order {};
+    CatalogOrder::CaptureTimeReader m_captureTimeReader {};
+    // Criterion to re-sort the catalog by, once the enumeration or the key gathering is done
+    std::optional<CatalogOrder::Criterion> m_pendingCriterion {};
+
+    QThreadPool m_threadPool {};
+    // A watcher per enumeration, the cancelled one is dropped together with its pending results.
+    std::unique_ptr<QFutureWatcher<Items>> m_enumeration {};
+    // Directories of a tree level are listed in parallel, which pays off on the network mounts and SSDs.
+    QThreadPool m_walkPool {};
+
+    // Reading the image headers is not bound to the directory listing, so the keys are gathered on all the cores.
+    QThreadPool m_keyPool {};
+    std::unique_ptr<QFutureWatcher<Item>> m_keyGathering {};
+
+    // The watcher just tells the directory has changed, so it is listed again once the changes settle down.
+    QFileSystemWatcher m_directoryWatcher {};
+    QTimer m_rescanTimer {};
+    std::unique_ptr<QFutureWatcher<QStringList>> m_rescan {};
+
+    // Items are handed over in batches, the slow network mounts hand over whatever they have at least this often.
+    static constexpr qsizetype m_batchSize {512};
+    static constexpr qint64 m_batchInterval {100};
+    static constexpr int m_walkThreadCount {4};
+    // Files being written, e.g. by a tethered camera, change the directory repeatedly.
+    static constexpr int m_rescanDelay {250};
 };
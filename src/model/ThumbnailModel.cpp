@@ -0,0 +1,156 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ThumbnailModel.h"
+#include <QFileInfo>
+#include <QPointer>
+
+ThumbnailModel::ThumbnailModel(const QString &thumbnailDirectory, QObject *parent)
+                                        : QAbstractListModel(parent)
+                                        , m_thumbnailCache(thumbnailDirectory)
+{
+}
+
+ThumbnailModel::~ThumbnailModel()
+{
+    m_thumbnailCache.cancel();
+}
+
+void ThumbnailModel::setCatalog(const ImageCatalog *catalog)
+{
+    if (m_catalog)
+        QObject::disconnect(m_catalog, nullptr, this, nullptr);
+
+    m_catalog = catalog;
+    if (m_catalog)
+    {
+        QObject::connect(m_catalog, &ImageCatalog::catalogReset, this, &ThumbnailModel::onCatalogReset);
+        QObject::connect(m_catalog, &ImageCatalog::catalogSorted, this, &ThumbnailModel::onCatalogReset);
+        QObject::connect(m_catalog, &ImageCatalog::itemsAboutToBeInserted, this, &ThumbnailModel::onItemsAboutToBeInserted);
+        QObject::connect(m_catalog, &ImageCatalog::itemsInserted, this, &ThumbnailModel::onItemsInserted);
+        // The merged batch touches rows all over the catalog, it is cheaper to reset than to announce them one by one.
+        QObject::connect(m_catalog, &ImageCatalog::itemsMerged, this, &ThumbnailModel::onCatalogReset);
+        QObject::connect(m_catalog, &ImageCatalog::itemsAboutToBeRemoved, this, &ThumbnailModel::onItemsAboutToBeRemoved);
+        QObject::connect(m_catalog, &ImageCatalog::itemsRemoved, this, &ThumbnailModel::onItemsRemoved);
+    }
+
+    onCatalogReset();
+}
+
+QString ThumbnailModel::getFileName(const int row) const
+{
+    return m_catalog ? m_catalog->getFileName(row) : QString {};
+}
+
+int ThumbnailModel::getRow(const QString &fileName) const
+{
+    return m_catalog ? static_cast<int>(m_catalog->indexOf(fileName)) : -1;
+}
+
+void ThumbnailModel::cancelRequests()
+{
+    ++m_generation;
+    m_thumbnailCache.cancel();
+    m_requested.clear();
+}
+
+int ThumbnailModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() || !m_catalog ? 0 : static_cast<int>(m_catalog->getCatalogSize());
+}
+
+QVariant ThumbnailModel::data(const QModelIndex &index, const int role) const
+{
+    const QString fileName {index.isValid() ? getFileName(index.row()) : QString {}};
+    if (fileName.isEmpty())
+        return {};
+
+    switch (role)
+    {
+        case Qt::DisplayRole:
+            return QFileInfo(fileName).fileName();
+        case Qt::ToolTipRole:
+            return fileName;
+        case Qt::DecorationRole:
+        {
+            if (QImage thumbnail {m_thumbnails.find(fileName)}; !thumbnail.isNull())
+                return thumbnail;
+
+            if (!m_failed.contains(fileName) && m_requested.insert(fileName).second)
+                requestThumbnail(index.row(), fileName);
+
+            return {};
+        }
+        default:
+            return {};
+    }
+}
+
+QCoro::Task<void> ThumbnailModel::requestThumbnail(int row, const QString fileName) const
+{
+    const quint64 generation {m_generation};
+    // The request may finish after the model is gone, e.g. when the dock is torn down at the shutdown.
+    const QPointer<const ThumbnailModel> safeThis {this};
+    const QImage thumbnail {co_await m_thumbnailCache.thumbnail(fileName, m_thumbnailSize)};
+    if (!safeThis)
+        co_return;
+
+    // Even the thumbnails of the cancelled requests are worth keeping if they are done.
+    if (!thumbnail.isNull())
+    {
+        m_thumbnails.insert(fileName, thumbnail);
+        if (getFileName(row) != fileName)
+            row = getRow(fileName);
+
+        if (row >= 0)
+        {
+            const QModelIndex modelIndex {index(row)};
+            emit const_cast<ThumbnailModel *>(this)->dataChanged(modelIndex, modelIndex, {Qt::DecorationRole});
+        }
+    }
+
+    // Cancelled requests have been forgotten already, the cell asks again if it is still visible.
+    if (generation != m_generation)
+        co_return;
+
+    m_requested.erase(fileName);
+    if (thumbnail.isNull())
+        m_failed.insert(fileName);
+}
+
+void ThumbnailModel::onCatalogReset()
+{
+    cancelRequests();
+
+    beginResetModel();
+    // The decoded thumbnails are kept, going back to the previous directory is instant then.
+    m_failed.clear();
+    endResetModel();
+}
+
+void ThumbnailModel::onItemsAboutToBeInserted(const qsizetype first, const qsizetype count)
+{
+    beginInsertRows({}, static_cast<int>(first), static_cast<int>(first + count - 1));
+}
+
+void ThumbnailModel::onItemsInserted()
+{
+    endInsertRows();
+}
+
+void ThumbnailModel::onItemsAboutToBeRemoved(const qsizetype first, const qsizetype count)
+{
+    beginRemoveRows({}, static_cast<int>(first), static_cast<int>(first + count - 1));
+}
+
+void ThumbnailModel::onItemsRemoved()
+{
+    endRemoveRows();
+}
@@ -0,0 +1,69 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ImageCatalog.h"
+#include "../processing/ImageCache.h"
+#include "../processing/ThumbnailCache.h"
+#include "../util/compiler.h"
+#include <QAbstractListModel>
+#include <QPointer>
+#include <qcorotask.h>
+#include <unordered_set>
+
+/// Lists the catalog images with their thumbnails, the rows follow the catalog even while it is being enumerated.
+/// Thumbnails are requested lazily, when the view asks for the decoration, so just the visible cells are ever decoded.
+/// Decoded ones are kept in a size-bounded cache, so the memory does not grow with the number of images.
+class ThumbnailModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailModel(const QString &thumbnailDirectory = ThumbnailCache::defaultDirectory(), QObject *parent = nullptr);
+    ~ThumbnailModel() override;
+    DISABLE_COPY_MOVE(ThumbnailModel);
+
+    void setCatalog(const ImageCatalog *catalog);
+    [[nodiscard]] QString getFileName(int row) const;
+    /// Returns -1 if the image is not listed.
+    [[nodiscard]] int getRow(const QString &fileName) const;
+    /// Drops the thumbnail requests which have not been started yet, e.g. the scrolled away cells.
+    /// Cells painted again request their thumbnails anew.
+    void cancelRequests();
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
+    static constexpr ThumbnailCache::Size m_thumbnailSize {ThumbnailCache::Size::Normal};
+    // Roughly a thousand of the normal thumbnails
+    static constexpr qsizetype m_maxThumbnailsSize {64 * 1024 * 1024};
+
+protected:
+    /// The row is just a hint, the items inserted meanwhile might have moved the image. Does not touch the model
+    /// once it is destroyed.
+    QCoro::Task<void> requestThumbnail(int row, QString fileName) const;
+
+protected slots:
+    void onCatalogReset();
+    void onItemsAboutToBeInserted(qsizetype first, qsizetype count);
+    void onItemsInserted();
+    void onItemsAboutToBeRemoved(qsizetype first, qsizetype count);
+    void onItemsRemoved();
+
+private:
+    QPointer<const ImageCatalog> m_catalog {};
+    mutable ThumbnailCache m_thumbnailCache;
+    mutable ImageCache m_thumbnails {m_maxThumbnailsSize};
+    // The data() is const, but it is the place where the visible cells ask for their thumbnails.
+    mutable std::unordered_set<QString> m_requested {};
+    mutable std::unordered_set<QString> m_failed {};
+    // Incremented on every cancel, the cancelled requests are not considered as failed.
+    quint64 m_generation {0};
+};
@@ -0,0 +1,125 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "CatalogIndexTest.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include "../CatalogIndex.h"
+
+void CatalogIndexTest::indexPath() const
+{
+    const CatalogIndex index {"/cache"};
+    QVERIFY(index.indexPath("/images", "*.jpg").startsWith("/cache/"));
+    QCOMPARE(index.indexPath("/images", "*.jpg"), index.indexPath("/images", "*.jpg"));
+    QVERIFY(index.indexPath("/images", "*.jpg") != index.indexPath("/images", "*.png"));
+    QVERIFY(index.indexPath("/images", "*.jpg") != index.indexPath("/photos", "*.jpg"));
+}
+
+void CatalogIndexTest::storeAndLoad() const
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path {directory.filePath("cache/index.idx")};
+
+    CatalogIndex::Contents contents {1234, CatalogOrder::Criterion::CaptureTime, {}, {}};
+    constexpr int count {1000};
+    for (int i = 0; i < count; ++i)
+    {
+        contents.names.append(QString("IMG_%1.jpg").arg(i));
+        contents.keys.push_back({i * 10, i % 2 == 0 ? CatalogOrder::m_unknown : i * 20});
+    }
+
+    // The garbage of the removed names is not stored
+    contents.names.remove(0);
+    contents.keys.erase(contents.keys.begin());
+    QVERIFY(CatalogIndex::store(path, contents));
+
+    CatalogIndex::Contents loaded;
+    QVERIFY(CatalogIndex::load(path, loaded));
+    QCOMPARE(loaded.directoryModificationTime, 1234);
+    QVERIFY(loaded.criterion == CatalogOrder::Criterion::CaptureTime);
+    QCOMPARE(loaded.names.size(), count - 1);
+    QCOMPARE(loaded.keys.size(), static_cast<std::size_t>(count - 1));
+    for (int i = 1; i < count; ++i)
+    {
+        QCOMPARE(loaded.names[i - 1].toString(), QString("IMG_%1.jpg").arg(i));
+        QCOMPARE(loaded.keys[i - 1].modificationTime, contents.keys[i - 1].modificationTime);
+        QCOMPARE(loaded.keys[i - 1].captureTime, contents.keys[i - 1].captureTime);
+    }
+
+    QCOMPARE(loaded.names.indexOf(u"IMG_500.jpg"), 499);
+
+    // An empty catalog is a valid one too
+    QVERIFY(CatalogIndex::store(path, CatalogIndex::Contents {}));
+    QVERIFY(CatalogIndex::load(path, loaded));
+    QVERIFY(loaded.names.isEmpty());
+}
+
+void CatalogIndexTest::damaged() const
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path {directory.filePath("index.idx")};
+
+    CatalogIndex::Contents contents;
+    QVERIFY(!CatalogIndex::load(path, contents));
+
+    contents.names.append(u"first.jpg");
+    contents.keys.push_back({});
+    QVERIFY(CatalogIndex::store(path, contents));
+
+    // Truncated
+    QFile file {path};
+    QVERIFY(file.resize(file.size() - 2));
+    QVERIFY(!CatalogIndex::load(path, contents));
+
+    // Not an index at all
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QByteArray(256, 'x'));
+    file.close();
+    QVERIFY(!CatalogIndex::load(path, contents));
+}
+
+void CatalogIndexTest::prune() const
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const CatalogIndex index {directory.path()};
+    const QStringList directories {"/a", "/b", "/c", "/d"};
+    const QDateTime now {QDateTime::currentDateTimeUtc()};
+    for (qsizetype i = 0; i < directories.size(); ++i)
+    {
+        const QString path {index.indexPath(directories.at(i), "*.jpg")};
+        QVERIFY(CatalogIndex::store(path, CatalogIndex::Contents {}));
+        QFile file {path};
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        // The later ones are used more recently, the first one is not used for too long
+        const QDateTime used {i == 0 ? now.addDays(-CatalogIndex::m_maxAge - 1) : now.addSecs(-60 * (directories.size() - i))};
+        QVERIFY(file.setFileTime(used, QFileDevice::FileModificationTime));
+    }
+
+    // Loading marks the index as used
+    CatalogIndex::Contents contents;
+    QVERIFY(CatalogIndex::load(index.indexPath("/b", "*.jpg"), contents));
+
+    index.prune(2);
+    QVERIFY(!QFile::exists(index.indexPath("/a", "*.jpg")));
+    QVERIFY(QFile::exists(index.indexPath("/b", "*.jpg")));
+    QVERIFY(!QFile::exists(index.indexPath("/c", "*.jpg")));
+    QVERIFY(QFile::exists(index.indexPath("/d", "*.jpg")));
+
+#ifdef Q_OS_UNIX
+    // Readable by the owner only
+    QCOMPARE(QFile::permissions(index.indexPath("/d", "*.jpg")) & (QFileDevice::ReadGroup | QFileDevice::ReadOther), QFileDevice::Permissions {});
+#endif
+}
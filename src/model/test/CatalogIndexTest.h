@@ -0,0 +1,22 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+
+class CatalogIndexTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void indexPath() const;
+    void storeAndLoad() const;
+    void damaged() const;
+    void prune() const;
+};
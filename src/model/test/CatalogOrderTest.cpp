@@ -0,0 +1,142 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "CatalogOrderTest.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include "../CatalogOrder.h"
+
+namespace
+{
+    QStringList sortNames(const CatalogOrder &order, const QStringList &names, const std::vector<CatalogOrder::Keys> &keys)
+    {
+        StringArena arena;
+        for (const QString &name : names)
+            arena.append(name);
+
+        std::vector<CatalogOrder::Keys> derivedKeys {keys};
+        QStringList sorted;
+        for (const quint32 position : order.sort(arena, derivedKeys))
+            sorted.append(arena[position].toString());
+
+        // The comparison agrees with the sort, whether the keys derived from the names are known or not
+        for (qsizetype i = 1; i < sorted.size(); ++i)
+        {
+            const auto left {names.indexOf(sorted[i - 1])}, right {names.indexOf(sorted[i])};
+            if (!order.lessThan(names[left], derivedKeys[left], names[right], derivedKeys[right]) ||
+                !order.lessThan(names[left], keys[left], names[right], derivedKeys[right]))
+                return {};
+        }
+
+        return sorted;
+    }
+} // namespace
+
+void CatalogOrderTest::naturalSortKey() const
+{
+    QCOMPARE(CatalogOrder::naturalSortKey(u"IMG_007.jpg"), CatalogOrder::naturalSortKey(u"img_7.JPG"));
+    QCOMPARE(CatalogOrder::naturalSortKey(u"0"), CatalogOrder::naturalSortKey(u"000"));
+    QVERIFY(CatalogOrder::naturalSortKey(u"IMG_9") < CatalogOrder::naturalSortKey(u"IMG_10"));
+    QVERIFY(CatalogOrder::naturalSortKey(u"a2b") < CatalogOrder::naturalSortKey(u"a10"));
+    QVERIFY(CatalogOrder::naturalSortKey(u"1") < CatalogOrder::naturalSortKey(u"a"));
+}
+
+void CatalogOrderTest::nameOrder() const
+{
+    const QStringList names {"img_2.jpg", "IMG_9.jpg", "a.jpg", "IMG_100.jpg", "IMG_10.jpg"};
+    const std::vector<CatalogOrder::Keys> keys(names.size());
+    QCOMPARE(sortNames(CatalogOrder {CatalogOrder::Criterion::Name}, names, keys),
+             QStringList({"IMG_10.jpg", "IMG_100.jpg", "IMG_9.jpg", "a.jpg", "img_2.jpg"}));
+}
+
+void CatalogOrderTest::naturalOrder() const
+{
+    const QStringList names {"img_2.jpg", "IMG_9.jpg", "a.jpg", "IMG_100.jpg", "IMG_10.jpg", "IMG_009.jpg"};
+    const std::vector<CatalogOrder::Keys> keys(names.size());
+    QCOMPARE(sortNames(CatalogOrder {CatalogOrder::Criterion::Natural}, names, keys),
+             QStringList({"a.jpg", "img_2.jpg", "IMG_009.jpg", "IMG_9.jpg", "IMG_10.jpg", "IMG_100.jpg"}));
+}
+
+void CatalogOrderTest::localeOrder() const
+{
+    const QStringList names {"b.jpg", "A.jpg", "a.jpg", "c.jpg"};
+    const std::vector<CatalogOrder::Keys> keys(names.size());
+    const QStringList sorted {sortNames(CatalogOrder {CatalogOrder::Criterion::Locale, QLocale {QLocale::English}}, names, keys)};
+    QCOMPARE(sorted.size(), names.size());
+    QCOMPARE(sorted.mid(2), QStringList({"b.jpg", "c.jpg"}));
+}
+
+void CatalogOrderTest::timeOrder() const
+{
+    const QStringList names {"c.jpg", "a.jpg", "b.jpg", "IMG_10.jpg", "IMG_9.jpg"};
+    const std::vector<CatalogOrder::Keys> keys {{30, 5}, {10, 4}, {20, 3}, {40, 2}, {40, 1}};
+
+    // The equal times are ordered naturally by the names
+    QCOMPARE(sortNames(CatalogOrder {CatalogOrder::Criterion::ModificationTime}, names, keys),
+             QStringList({"a.jpg", "b.jpg", "c.jpg", "IMG_9.jpg", "IMG_10.jpg"}));
+    QCOMPARE(sortNames(CatalogOrder {CatalogOrder::Criterion::CaptureTime}, names, keys),
+             QStringList({"IMG_9.jpg", "IMG_10.jpg", "b.jpg", "a.jpg", "c.jpg"}));
+
+    QVERIFY(!CatalogOrder {CatalogOrder::Criterion::Natural}.needsKeys());
+    QVERIFY(CatalogOrder {CatalogOrder::Criterion::CaptureTime}.needsKeys());
+    QVERIFY(!CatalogOrder {CatalogOrder::Criterion::ModificationTime}.hasKeys({}));
+    QVERIFY(CatalogOrder {CatalogOrder::Criterion::ModificationTime}.hasKeys({10, CatalogOrder::m_unknown}));
+    QVERIFY(!CatalogOrder {CatalogOrder::Criterion::CaptureTime}.hasKeys({10, CatalogOrder::m_unknown}));
+}
+
+void CatalogOrderTest::gatherKeys() const
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString fileName {directory.filePath("image.jpg")};
+    QFile file {fileName};
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    const qint64 modificationTime {QFileInfo(fileName).lastModified().toMSecsSinceEpoch()};
+    const QDateTime captureTime {QDate(2020, 5, 17), QTime(12, 30)};
+    int readCount {0};
+    const CatalogOrder::CaptureTimeReader reader {[&readCount, &captureTime](const QString &) {
+        ++readCount;
+        return captureTime;
+    }};
+
+    // Just the modification time is read for its order
+    CatalogOrder::Keys keys;
+    CatalogOrder {CatalogOrder::Criterion::ModificationTime}.gatherKeys(directory.path(), "image.jpg", keys, reader);
+    QCOMPARE(keys.modificationTime, modificationTime);
+    QCOMPARE(keys.captureTime, CatalogOrder::m_unknown);
+    QCOMPARE(keys.naturalKey, CatalogOrder::naturalSortKey(u"image.jpg"));
+    QCOMPARE(readCount, 0);
+
+    CatalogOrder {CatalogOrder::Criterion::CaptureTime}.gatherKeys(directory.path(), "image.jpg", keys, reader);
+    QCOMPARE(keys.captureTime, captureTime.toMSecsSinceEpoch());
+    QCOMPARE(readCount, 1);
+
+    // The keys known already are not read again
+    CatalogOrder {CatalogOrder::Criterion::CaptureTime}.gatherKeys(directory.path(), "image.jpg", keys, reader);
+    QCOMPARE(readCount, 1);
+
+    // The image without the capture time goes by its modification time
+    CatalogOrder::Keys withoutCaptureTime;
+    CatalogOrder {CatalogOrder::Criterion::CaptureTime}.gatherKeys(directory.path(), "image.jpg", withoutCaptureTime,
+                                                                   [](const QString &) { return QDateTime {}; });
+    QCOMPARE(withoutCaptureTime.captureTime, modificationTime);
+
+    // Just the key derived from the name for the criterion is kept
+    CatalogOrder {CatalogOrder::Criterion::Locale}.gatherKeys(directory.path(), "image.jpg", keys, reader);
+    QVERIFY(keys.collationKey.has_value());
+    QVERIFY(keys.naturalKey.isNull());
+    CatalogOrder {CatalogOrder::Criterion::Name}.gatherKeys(directory.path(), "image.jpg", keys, reader);
+    QVERIFY(!keys.collationKey.has_value());
+    QCOMPARE(readCount, 1);
+}
@@ -0,0 +1,24 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+
+class CatalogOrderTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void naturalSortKey() const;
+    void nameOrder() const;
+    void naturalOrder() const;
+    void localeOrder() const;
+    void timeOrder() const;
+    void gatherKeys() const;
+};
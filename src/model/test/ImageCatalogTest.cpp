@@ -10,6 +10,9 @@ VookiImageViewer - a tool for showing images.
 
 #include "ImageCatalogTest.h"
 
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <atomic>
 #include <ranges>
 #include "../ImageCatalog.h"
 #include "../../util/array.h"
@@ -159,3 +162,333 @@ void ImageCatalogTest::initializationWithExistingFileExtBFiltered() const
         QCOMPARE(imageCatalog.getCurrent(), expectedFile);
     }
 }
+
+void ImageCatalogTest::neighbours() const
+{
+    ImageCatalog emptyCatalog {QStringList {}};
+    QCOMPARE(emptyCatalog.getNeighbours(2, 2), QStringList{});
+
+    ImageCatalog singleFileCatalog {QStringList {}};
+    singleFileCatalog.initialize(QDir(ImageCatalogTest::makeAbsolutePath(m_singleFileDirPath)));
+    QCOMPARE(singleFileCatalog.getNeighbours(2, 2), QStringList{});
+
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    imageCatalog.initialize(QFile(ImageCatalogTest::makeAbsolutePath(m_fourthFilePath)));
+
+    // Sorted: first.a_ext, fourth.a_ext, third.a_ext - the current one is the fourth.a_ext
+    const auto first {makeAbsolutePath(m_multipleFilesExtA[0])};
+    const auto third {makeAbsolutePath(m_multipleFilesExtA[1])};
+    QCOMPARE(imageCatalog.getNeighbours(0, 0), QStringList{});
+    QCOMPARE(imageCatalog.getNeighbours(1, 0), QStringList{third});
+    QCOMPARE(imageCatalog.getNeighbours(0, 1), QStringList{first});
+    QCOMPARE(imageCatalog.getNeighbours(1, 1), (QStringList{third, first}));
+
+    // Wrapping around the small catalog neither duplicates the items nor returns the current one
+    QCOMPARE(imageCatalog.getNeighbours(5, 5), (QStringList{third, first}));
+
+    // Current position is not changed
+    QCOMPARE(imageCatalog.getCurrent(), makeAbsolutePath(m_fourthFilePath));
+}
+
+void ImageCatalogTest::currentIndex() const
+{
+    ImageCatalog emptyCatalog {QStringList {}};
+    QCOMPARE(emptyCatalog.getCurrentIndex(), -1);
+    QCOMPARE(emptyCatalog.setCurrentIndex(0), QString{});
+    QCOMPARE(emptyCatalog.getFileName(0), QString{});
+    QCOMPARE(emptyCatalog.indexOf(makeAbsolutePath(m_fourthFilePath)), -1);
+
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    imageCatalog.initialize(QFile(ImageCatalogTest::makeAbsolutePath(m_fourthFilePath)));
+
+    // Sorted: first.a_ext, fourth.a_ext, third.a_ext - the current one is the fourth.a_ext
+    const auto first {makeAbsolutePath(m_multipleFilesExtA[0])};
+    const auto third {makeAbsolutePath(m_multipleFilesExtA[1])};
+    const auto fourth {makeAbsolutePath(m_multipleFilesExtA[2])};
+    QCOMPARE(imageCatalog.getFileName(0), first);
+    QCOMPARE(imageCatalog.getFileName(2), third);
+    QCOMPARE(imageCatalog.getFileName(3), QString{});
+    QCOMPARE(imageCatalog.indexOf(fourth), 1);
+    QCOMPARE(imageCatalog.indexOf(makeAbsolutePath(m_multipleFilesExtB[0])), -1);
+    QCOMPARE(imageCatalog.getCurrentIndex(), 1);
+
+    QCOMPARE(imageCatalog.setCurrentIndex(2), third);
+    QCOMPARE(imageCatalog.getCurrentIndex(), 2);
+    QCOMPARE(imageCatalog.getNext(), first);
+
+    // Out of the catalog, the current item stays
+    QCOMPARE(imageCatalog.setCurrentIndex(3), QString{});
+    QCOMPARE(imageCatalog.setCurrentIndex(-1), QString{});
+    QCOMPARE(imageCatalog.getCurrentIndex(), 0);
+}
+
+void ImageCatalogTest::asynchronousInitialization() const
+{
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    QSignalSpy finishedSpy {&imageCatalog, &ImageCatalog::enumerationFinished};
+    imageCatalog.initializeAsync(QFile(ImageCatalogTest::makeAbsolutePath(m_fourthFilePath)));
+
+    // The requested file is there right away
+    const auto fourth {makeAbsolutePath(m_fourthFilePath)};
+    QCOMPARE(imageCatalog.getCurrent(), fourth);
+    QCOMPARE(imageCatalog.getCatalogSize(), 1);
+    QVERIFY(imageCatalog.isEnumerating());
+
+    QVERIFY(finishedSpy.wait());
+    QVERIFY(!imageCatalog.isEnumerating());
+    QCOMPARE(imageCatalog.getCatalogSize(), 3);
+    QCOMPARE(imageCatalog.getCurrent(), fourth);
+    QCOMPARE(imageCatalog.getNext(), makeAbsolutePath(m_multipleFilesExtA[1]));
+
+    imageCatalog.initializeAsync(QDir(ImageCatalogTest::makeAbsolutePath(m_multipleFilesDirPath)));
+    QCOMPARE(imageCatalog.getCatalogSize(), 0);
+    QVERIFY(finishedSpy.wait());
+    QCOMPARE(imageCatalog.getCatalogSize(), 3);
+    QCOMPARE(imageCatalog.getCurrentIndex(), 0);
+
+    imageCatalog.initializeAsync(QDir{"@#$"});
+    QCOMPARE(finishedSpy.count(), 3);
+    QCOMPARE(imageCatalog.getCatalogSize(), 0);
+}
+
+void ImageCatalogTest::incrementalEnumeration() const
+{
+    // Several batches, listed in the file system order, are merged into the sorted catalog
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    constexpr int fileCount {2000};
+    for (int i = 0; i < fileCount; ++i)
+    {
+        QFile file {directory.filePath(QString("%1.a_ext").arg((i * 7919) % fileCount, 4, 10, QChar('0')))};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    const QString current {directory.filePath("1000.a_ext")};
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    QSignalSpy finishedSpy {&imageCatalog, &ImageCatalog::enumerationFinished};
+    QSignalSpy insertedSpy {&imageCatalog, &ImageCatalog::itemsInserted};
+    QSignalSpy mergedSpy {&imageCatalog, &ImageCatalog::itemsMerged};
+    imageCatalog.initializeAsync(QFile(current));
+
+    // The current item stays while the items are inserted in front of it
+    qsizetype insertedCount {0};
+    const auto onInserted = [&imageCatalog, &insertedCount, &current](const qsizetype count) {
+        insertedCount += count;
+        QCOMPARE(imageCatalog.getCatalogSize(), insertedCount + 1);
+        QCOMPARE(imageCatalog.getCurrent(), QFileInfo(current).canonicalFilePath());
+    };
+    QObject::connect(&imageCatalog, &ImageCatalog::itemsInserted, [&onInserted](const qsizetype, const qsizetype count) { onInserted(count); });
+    QObject::connect(&imageCatalog, &ImageCatalog::itemsMerged, onInserted);
+
+    QVERIFY(finishedSpy.wait());
+    // The batches in the file system order are scattered over the catalog, each is merged at once
+    QVERIFY(mergedSpy.count() > 0);
+    QVERIFY(insertedSpy.count() + mergedSpy.count() < fileCount / 100);
+    QCOMPARE(imageCatalog.getCatalogSize(), fileCount);
+    QCOMPARE(imageCatalog.getCurrentIndex(), 1000);
+    for (int i = 0; i < fileCount; ++i)
+        QCOMPARE(QFileInfo(imageCatalog.getFileName(i)).fileName(), QString("%1.a_ext").arg(i, 4, 10, QChar('0')));
+}
+
+void ImageCatalogTest::watching() const
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    for (const char *name : {"b.a_ext", "d.a_ext", "f.a_ext"})
+    {
+        QFile file {directory.filePath(name)};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    QSignalSpy finishedSpy {&imageCatalog, &ImageCatalog::enumerationFinished};
+    imageCatalog.initializeAsync(QFile(directory.filePath("d.a_ext")));
+    QVERIFY(finishedSpy.wait());
+    QCOMPARE(imageCatalog.getCatalogSize(), 3);
+
+    // New files are merged, the current item stays
+    QSignalSpy addedSpy {&imageCatalog, &ImageCatalog::itemsAdded};
+    for (const char *name : {"a.a_ext", "e.a_ext", "ignored.b_ext"})
+    {
+        QFile file {directory.filePath(name)};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    QVERIFY(addedSpy.wait());
+    QCOMPARE(imageCatalog.getCatalogSize(), 5);
+    QCOMPARE(imageCatalog.getCurrentIndex(), 2);
+    QCOMPARE(imageCatalog.getFileName(3), QFileInfo(directory.filePath("e.a_ext")).canonicalFilePath());
+    QVERIFY(QStringList({"a.a_ext", "e.a_ext"}).contains(QFileInfo(addedSpy.front().front().toString()).fileName()));
+
+    // Removing the current file moves to the following one
+    QSignalSpy currentRemovedSpy {&imageCatalog, &ImageCatalog::currentItemRemoved};
+    QSignalSpy removedSpy {&imageCatalog, &ImageCatalog::itemsRemoved};
+    QVERIFY(QFile::remove(directory.filePath("a.a_ext")));
+    QVERIFY(QFile::remove(directory.filePath("d.a_ext")));
+
+    QVERIFY(currentRemovedSpy.wait());
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(imageCatalog.getCatalogSize(), 3);
+    QCOMPARE(imageCatalog.getCurrentIndex(), 1);
+    QCOMPARE(imageCatalog.getCurrent(), QFileInfo(directory.filePath("e.a_ext")).canonicalFilePath());
+}
+
+void ImageCatalogTest::sorting() const
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    for (const char *name : {"IMG_9.a_ext", "IMG_10.a_ext", "IMG_100.a_ext"})
+    {
+        QFile file {directory.filePath(name)};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    const auto fileNames = [](const ImageCatalog &imageCatalog) {
+        QStringList names;
+        for (qsizetype i = 0; i < imageCatalog.getCatalogSize(); ++i)
+            names.append(QFileInfo(imageCatalog.getFileName(i)).fileName());
+        return names;
+    };
+
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    imageCatalog.initialize(QFile(directory.filePath("IMG_9.a_ext")));
+    QCOMPARE(fileNames(imageCatalog), QStringList({"IMG_10.a_ext", "IMG_100.a_ext", "IMG_9.a_ext"}));
+    QCOMPARE(imageCatalog.getCurrentIndex(), 2);
+
+    // The order derived from the names is applied right away, the current item stays
+    QSignalSpy sortedSpy {&imageCatalog, &ImageCatalog::catalogSorted};
+    imageCatalog.setSortCriterion(CatalogOrder::Criterion::Natural);
+    QCOMPARE(sortedSpy.count(), 1);
+    QCOMPARE(fileNames(imageCatalog), QStringList({"IMG_9.a_ext", "IMG_10.a_ext", "IMG_100.a_ext"}));
+    QCOMPARE(imageCatalog.getCurrentIndex(), 0);
+
+    // The capture times are read in parallel, just once for every image
+    std::atomic<int> readCount {0};
+    imageCatalog.setCaptureTimeReader([&readCount](const QString &fileName) {
+        ++readCount;
+        const QDateTime captureTime {QDate(2020, 5, 17), QTime(12, 30)};
+        return captureTime.addSecs(-QFileInfo(fileName).fileName().size());
+    });
+    imageCatalog.setSortCriterion(CatalogOrder::Criterion::CaptureTime);
+    QVERIFY(sortedSpy.wait());
+    QCOMPARE(fileNames(imageCatalog), QStringList({"IMG_100.a_ext", "IMG_10.a_ext", "IMG_9.a_ext"}));
+    QCOMPARE(imageCatalog.getCurrent(), QFileInfo(directory.filePath("IMG_9.a_ext")).canonicalFilePath());
+    QCOMPARE(readCount.load(), 3);
+
+    imageCatalog.setSortCriterion(CatalogOrder::Criterion::Name);
+    imageCatalog.setSortCriterion(CatalogOrder::Criterion::CaptureTime);
+    QCOMPARE(sortedSpy.count(), 4);
+    QCOMPARE(fileNames(imageCatalog), QStringList({"IMG_100.a_ext", "IMG_10.a_ext", "IMG_9.a_ext"}));
+    QCOMPARE(readCount.load(), 3);
+
+    // The files added later are merged by their keys
+    QSignalSpy addedSpy {&imageCatalog, &ImageCatalog::itemsAdded};
+    QFile file {directory.filePath("IMG_1000.a_ext")};
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(addedSpy.wait());
+    QCOMPARE(fileNames(imageCatalog), QStringList({"IMG_1000.a_ext", "IMG_100.a_ext", "IMG_10.a_ext", "IMG_9.a_ext"}));
+    QCOMPARE(readCount.load(), 4);
+}
+
+void ImageCatalogTest::recursion() const
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    for (const char *name : {"a.a_ext", "ignored.b_ext", "2024/c.a_ext", "2024/01/b.a_ext", "deep/1/2/3/d.a_ext"})
+    {
+        QVERIFY(QDir(directory.path()).mkpath(QFileInfo(directory.filePath(name)).path()));
+        QFile file {directory.filePath(name)};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    const auto fileNames = [](const ImageCatalog &imageCatalog) {
+        QStringList names;
+        for (qsizetype i = 0; i < imageCatalog.getCatalogSize(); ++i)
+            names.append(imageCatalog.getFileName(i));
+        return names;
+    };
+    const auto canonicalPath = [&directory](const QString &name) {
+        return QFileInfo(directory.filePath(name)).canonicalFilePath();
+    };
+
+    // The items of the subdirectories are the relative paths, the ones too deep are left out
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    imageCatalog.setRecursion({2, false});
+    imageCatalog.initialize(QDir(directory.path()));
+    QCOMPARE(fileNames(imageCatalog), QStringList({canonicalPath("2024/01/b.a_ext"), canonicalPath("2024/c.a_ext"), canonicalPath("a.a_ext")}));
+
+    // The navigation goes across the directories
+    QCOMPARE(imageCatalog.indexOf(canonicalPath("2024/c.a_ext")), 1);
+    QCOMPARE(imageCatalog.indexOf(canonicalPath("deep/1/2/3/d.a_ext")), -1);
+    imageCatalog.setCurrentIndex(1);
+    QCOMPARE(imageCatalog.getNext(), canonicalPath("a.a_ext"));
+    QCOMPARE(imageCatalog.getNext(), canonicalPath("2024/01/b.a_ext"));
+
+    QSignalSpy finishedSpy {&imageCatalog, &ImageCatalog::enumerationFinished};
+    imageCatalog.setRecursion({10, false});
+    imageCatalog.initializeAsync(QDir(directory.path()));
+    QVERIFY(finishedSpy.wait());
+    QCOMPARE(imageCatalog.getCatalogSize(), 4);
+    QCOMPARE(imageCatalog.getFileName(3), canonicalPath("deep/1/2/3/d.a_ext"));
+
+#ifndef Q_OS_WIN
+    // Links to the directories listed already, even the cyclic ones, do not duplicate the items
+    QVERIFY(QFile::link(directory.filePath("2024"), directory.filePath("link")));
+    QVERIFY(QFile::link(directory.path(), directory.filePath("2024/01/up")));
+    imageCatalog.initialize(QDir(directory.path()));
+    QCOMPARE(imageCatalog.getCatalogSize(), 4);
+
+    imageCatalog.setRecursion({10, true});
+    imageCatalog.initialize(QDir(directory.path()));
+    QCOMPARE(imageCatalog.getCatalogSize(), 4);
+#endif
+}
+
+void ImageCatalogTest::index() const
+{
+    QTemporaryDir indexDirectory;
+    QTemporaryDir directory;
+    QVERIFY(indexDirectory.isValid() && directory.isValid());
+    for (const char *name : {"b.a_ext", "d.a_ext", "f.a_ext"})
+    {
+        QFile file {directory.filePath(name)};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    {
+        ImageCatalog imageCatalog {{"*.a_ext"}};
+        imageCatalog.setIndexDirectory(indexDirectory.path());
+        QSignalSpy finishedSpy {&imageCatalog, &ImageCatalog::enumerationFinished};
+        imageCatalog.initializeAsync(QDir(directory.path()));
+        QVERIFY(imageCatalog.isEnumerating());
+        QVERIFY(finishedSpy.wait());
+    }
+
+    // The unmodified directory is complete right away
+    ImageCatalog imageCatalog {{"*.a_ext"}};
+    imageCatalog.setIndexDirectory(indexDirectory.path());
+    QSignalSpy finishedSpy {&imageCatalog, &ImageCatalog::enumerationFinished};
+    imageCatalog.initializeAsync(QFile(directory.filePath("d.a_ext")));
+    QVERIFY(!imageCatalog.isEnumerating());
+    QCOMPARE(imageCatalog.getCatalogSize(), 3);
+    QCOMPARE(imageCatalog.getCurrentIndex(), 1);
+    QCOMPARE(imageCatalog.getFileName(2), QFileInfo(directory.filePath("f.a_ext")).canonicalFilePath());
+    QVERIFY(finishedSpy.wait());
+
+    // The modified one is patched by the changes
+    QVERIFY(QFile::remove(directory.filePath("b.a_ext")));
+    QFile file {directory.filePath("e.a_ext")};
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    // The files found by validating the index are not announced as the new ones
+    QSignalSpy addedSpy {&imageCatalog, &ImageCatalog::itemsAdded};
+    QSignalSpy removedSpy {&imageCatalog, &ImageCatalog::itemsRemoved};
+    imageCatalog.initializeAsync(QDir(directory.path()));
+    QCOMPARE(imageCatalog.getCatalogSize(), 3);
+    QVERIFY(removedSpy.wait());
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(imageCatalog.getCatalogSize(), 3);
+    QCOMPARE(imageCatalog.getFileName(0), QFileInfo(directory.filePath("d.a_ext")).canonicalFilePath());
+    QCOMPARE(imageCatalog.getFileName(1), QFileInfo(directory.filePath("e.a_ext")).canonicalFilePath());
+}
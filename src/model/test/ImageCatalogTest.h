@@ -47,4 +47,12 @@ private slots:
     void initializationWithExistingDir() const;
     void initializationWithExistingDirExtBFiltered() const;
     void initializationWithExistingFileExtBFiltered() const;
+    void neighbours() const;
+    void currentIndex() const;
+    void asynchronousInitialization() const;
+    void incrementalEnumeration() const;
+    void watching() const;
+    void sorting() const;
+    void recursion() const;
+    void index() const;
 };
@@ -0,0 +1,126 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QDir>
+#include <QImage>
+#include <QSignalSpy>
+
+#include "ThumbnailModelTest.h"
+#include "../ThumbnailModel.h"
+
+void ThumbnailModelTest::initTestCase()
+{
+    QVERIFY(m_directory.isValid());
+    for (int i = 0; i < m_imageCount; ++i)
+    {
+        QImage image {400, 300, QImage::Format_RGB32};
+        image.fill(QColor::fromHsv(i * 60, 255, 255));
+        // The catalog lists the images in the canonical directory
+        m_fileNames.append(QDir(m_directory.path()).canonicalPath() + QString("/image%1.png").arg(i));
+        QVERIFY(image.save(m_fileNames.back(), "PNG"));
+    }
+}
+
+void ThumbnailModelTest::fileNames() const
+{
+    const QTemporaryDir thumbnailDirectory;
+    ThumbnailModel model {thumbnailDirectory.path()};
+    QCOMPARE(model.rowCount(), 0);
+
+    ImageCatalog catalog {{"*.png"}};
+    catalog.initialize(QDir(m_directory.path()));
+    QSignalSpy resetSpy {&model, &QAbstractItemModel::modelReset};
+    model.setCatalog(&catalog);
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.rowCount(), m_imageCount);
+    QCOMPARE(model.getFileName(1), m_fileNames[1]);
+    QCOMPARE(model.getFileName(m_imageCount), QString());
+    QCOMPARE(model.getRow(m_fileNames[2]), 2);
+    QCOMPARE(model.getRow("@#$%"), -1);
+
+    catalog.initialize(QDir{"@#$"});
+    QCOMPARE(resetSpy.count(), 2);
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.getRow(m_fileNames[2]), -1);
+}
+
+void ThumbnailModelTest::enumeration() const
+{
+    const QTemporaryDir thumbnailDirectory;
+    ThumbnailModel model {thumbnailDirectory.path()};
+    ImageCatalog catalog {{"*.png"}};
+    model.setCatalog(&catalog);
+
+    // Rows follow the catalog as it grows, the requested image is the first one
+    QSignalSpy finishedSpy {&catalog, &ImageCatalog::enumerationFinished};
+    QSignalSpy insertedSpy {&model, &QAbstractItemModel::rowsInserted};
+    catalog.initializeAsync(QFile(m_fileNames[1]));
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.getFileName(0), m_fileNames[1]);
+
+    // The rest lands on both sides of the requested image, so the batch is merged and the model reset at once.
+    QSignalSpy resetSpy {&model, &QAbstractItemModel::modelReset};
+    QVERIFY(finishedSpy.wait());
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.rowCount(), m_imageCount);
+    for (int row = 0; row < m_imageCount; ++row)
+        QCOMPARE(model.getFileName(row), m_fileNames[row]);
+}
+
+void ThumbnailModelTest::data() const
+{
+    const QTemporaryDir thumbnailDirectory;
+    ThumbnailModel model {thumbnailDirectory.path()};
+    ImageCatalog catalog {{"*.png"}};
+    catalog.initialize(QDir(m_directory.path()));
+    model.setCatalog(&catalog);
+
+    QCOMPARE(model.data(model.index(0), Qt::DisplayRole).toString(), "image0.png");
+    QCOMPARE(model.data(model.index(0), Qt::ToolTipRole).toString(), m_fileNames[0]);
+    QCOMPARE(model.data(model.index(m_imageCount), Qt::DisplayRole), QVariant());
+}
+
+void ThumbnailModelTest::thumbnail() const
+{
+    const QTemporaryDir thumbnailDirectory;
+    ThumbnailModel model {thumbnailDirectory.path()};
+    ImageCatalog catalog {{"*.png"}};
+    catalog.initialize(QDir(m_directory.path()));
+    model.setCatalog(&catalog);
+    QSignalSpy dataChangedSpy {&model, &QAbstractItemModel::dataChanged};
+
+    // Nothing is decoded until the cell is painted
+    QVERIFY(!model.data(model.index(1), Qt::DecorationRole).isValid());
+    QVERIFY(dataChangedSpy.wait());
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.front().front().value<QModelIndex>().row(), 1);
+
+    const QImage thumbnail {model.data(model.index(1), Qt::DecorationRole).value<QImage>()};
+    QCOMPARE(thumbnail.width(), ThumbnailCache::pixelSize(ThumbnailModel::m_thumbnailSize));
+    QCOMPARE(dataChangedSpy.count(), 1);
+}
+
+void ThumbnailModelTest::destroyedWhileRequesting() const
+{
+    const QTemporaryDir thumbnailDirectory;
+    ImageCatalog catalog {{"*.png"}};
+    catalog.initialize(QDir(m_directory.path()));
+
+    {
+        ThumbnailModel model {thumbnailDirectory.path()};
+        model.setCatalog(&catalog);
+        for (int row = 0; row < model.rowCount(); ++row)
+            QVERIFY(!model.data(model.index(row), Qt::DecorationRole).isValid());
+    }
+
+    // The requests finishing now must not touch the destroyed model
+    QTest::qWait(500);
+}
@@ -0,0 +1,30 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTest>
+
+class ThumbnailModelTest: public QObject
+{
+    Q_OBJECT
+
+    static constexpr int m_imageCount {3};
+    QTemporaryDir m_directory {};
+    QStringList m_fileNames {};
+
+private slots:
+    void initTestCase();
+    void fileNames() const;
+    void enumeration() const;
+    void data() const;
+    void thumbnail() const;
+    void destroyedWhileRequesting() const;
+};
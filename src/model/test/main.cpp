@@ -8,8 +8,11 @@ VookiImageViewer - a tool for showing images.
 
 ****************************************************************************/
 
+#include "CatalogIndexTest.h"
+#include "CatalogOrderTest.h"
 #include "FileSystemSortFilterProxyModelTest.h"
 #include "ImageCatalogTest.h"
+#include "ThumbnailModelTest.h"
 
 #include "../../util/testing.h"
 
@@ -18,8 +21,11 @@ int main(int argc, char *argv[])
 {
     int status = 0;
 
+    TEST::runTests<CatalogIndexTest>(argc, argv, &status);
+    TEST::runTests<CatalogOrderTest>(argc, argv, &status);
     TEST::runTests<ImageCatalogTest>(argc, argv, &status);
     TEST::runTests<FileSystemSortFilterProxyModelTest>(argc, argv, &status);
+    TEST::runTests<ThumbnailModelTest>(argc, argv, &status);
 
     return status;
 }
@@ -0,0 +1,215 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "AnimationFrameBuffer.h"
+#include <QImageReader>
+#include <QMutexLocker>
+
+AnimationFrameBuffer::AnimationFrameBuffer()
+{
+    // The frames have to be decoded in order anyway.
+    m_threadPool.setMaxThreadCount(1);
+}
+
+AnimationFrameBuffer::~AnimationFrameBuffer()
+{
+    close();
+    setMemoryBudget(nullptr);
+}
+
+bool AnimationFrameBuffer::open(const QString &fileName, const int frameCount)
+{
+    close();
+
+    QImageReader reader {fileName};
+    reader.setAutoTransform(true);
+    if (frameCount <= 0 || !reader.canRead())
+        return false;
+
+    // Frames are decoded in the full resolution, so their size is known in advance.
+    const QSize size {reader.size()};
+    const qsizetype frameSize {static_cast<qsizetype>(size.width()) * size.height() * MemoryBudget::m_bytesPerPixel};
+    const qsizetype available {m_memoryBudget ? m_memoryBudget->available() : m_defaultMaxSize};
+
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_isOpen = true;
+        m_frameCount = frameCount;
+        m_keepsAllFrames = size.isValid() && frameSize * frameCount <= available;
+        if (m_keepsAllFrames)
+            m_frames.reserve(frameCount);
+    }
+
+    m_isCancelled = false;
+    m_threadPool.start([this, fileName, frameCount]() { decodeFrames(fileName, frameCount); });
+    return true;
+}
+
+void AnimationFrameBuffer::close()
+{
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_isCancelled = true;
+        m_frameTaken.wakeAll();
+    }
+
+    m_threadPool.waitForDone();
+
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_frames.clear();
+        m_ring.clear();
+        m_size = 0;
+        m_frameCount = 0;
+        m_isOpen = false;
+        m_isFailed = false;
+        m_frameDecoded.wakeAll();
+    }
+
+    reportUsage();
+}
+
+bool AnimationFrameBuffer::isOpen() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_isOpen;
+}
+
+bool AnimationFrameBuffer::keepsAllFrames() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_keepsAllFrames;
+}
+
+std::optional<AnimationFrameBuffer::Frame> AnimationFrameBuffer::takeFrame(const int index)
+{
+    std::optional<Frame> frame;
+    bool isStreamed {false};
+    {
+        QMutexLocker locker(&m_mutex);
+        if (index < 0 || index >= m_frameCount)
+            return {};
+
+        isStreamed = !m_keepsAllFrames;
+        while (m_isOpen && !frame)
+        {
+            if (m_keepsAllFrames)
+            {
+                if (index < static_cast<int>(m_frames.size()))
+                    frame = m_frames[index];
+            }
+            else
+            {
+                while (!m_ring.empty() && m_ring.front().index != index)
+                {
+                    m_size -= m_ring.front().frame.image.sizeInBytes();
+                    m_ring.pop_front();
+                }
+
+                if (!m_ring.empty())
+                {
+                    frame = std::move(m_ring.front().frame);
+                    m_size -= frame->image.sizeInBytes();
+                    m_ring.pop_front();
+                }
+
+                m_frameTaken.wakeAll();
+            }
+
+            // The worker has finished already, so waiting would never end.
+            if (!frame && m_isFailed)
+                return {};
+
+            if (!frame)
+                m_frameDecoded.wait(&m_mutex);
+        }
+    }
+
+    if (frame && isStreamed)
+        reportUsage();
+
+    return frame;
+}
+
+void AnimationFrameBuffer::setMemoryBudget(MemoryBudget *budget)
+{
+    if (m_memoryBudget)
+        m_memoryBudget->unregisterHolder(m_budgetHolder);
+
+    m_memoryBudget = budget;
+    if (m_memoryBudget)
+        m_budgetHolder = m_memoryBudget->registerHolder(MemoryBudget::Category::AnimationFrames);
+
+    reportUsage();
+}
+
+void AnimationFrameBuffer::decodeFrames(const QString &fileName, const int frameCount)
+{
+    QImageReader reader {fileName};
+    reader.setAutoTransform(true);
+
+    for (int index = 0; !m_isCancelled; ++index)
+    {
+        if (index == frameCount)
+        {
+            const QMutexLocker locker(&m_mutex);
+            if (m_keepsAllFrames)
+                return;
+
+            // Animation formats are not seekable, so the decoding starts over from the first frame.
+            index = 0;
+            reader.setFileName(fileName);
+        }
+
+        Frame frame;
+        if (!reader.read(&frame.image))
+        {
+            const QMutexLocker locker(&m_mutex);
+            m_isFailed = true;
+            m_frameDecoded.wakeAll();
+            return;
+        }
+        frame.delay = reader.nextImageDelay();
+        frame.rect = reader.currentImageRect();
+
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_keepsAllFrames && !m_isCancelled && static_cast<int>(m_ring.size()) >= m_ringCapacity)
+                m_frameTaken.wait(&m_mutex);
+
+            if (m_isCancelled)
+                return;
+
+            m_size += frame.image.sizeInBytes();
+            if (m_keepsAllFrames)
+                m_frames.push_back(std::move(frame));
+            else
+                m_ring.push_back({index, std::move(frame)});
+
+            m_frameDecoded.wakeAll();
+        }
+
+        reportUsage();
+    }
+}
+
+void AnimationFrameBuffer::reportUsage()
+{
+    // Called without the m_mutex locked, see MemoryBudget.
+    if (!m_memoryBudget)
+        return;
+
+    qsizetype size;
+    {
+        const QMutexLocker locker(&m_mutex);
+        size = m_size;
+    }
+    m_memoryBudget->setUsage(m_budgetHolder, size);
+}
@@ -0,0 +1,91 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QMutex>
+#include <QRect>
+#include <QString>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "MemoryBudget.h"
+#include "../util/compiler.h"
+
+/// Decodes the animation frames ahead on a worker thread. If all frames fit the memory budget, they are decoded
+/// just once and kept, so looping animations do not decode anything anymore. Otherwise just a few frames ahead
+/// are kept in a ring buffer and the worker decodes the animation over and over.
+class AnimationFrameBuffer
+{
+public:
+    struct Frame
+    {
+        QImage image {};
+        /// Milliseconds to show the frame for
+        int delay {0};
+        /// Part of the image the frame has updated, the null rectangle if the codec does not tell.
+        QRect rect {};
+    };
+
+    AnimationFrameBuffer();
+    ~AnimationFrameBuffer();
+    DISABLE_COPY_MOVE(AnimationFrameBuffer);
+
+    /// Starts decoding of the frames from the first one.
+    bool open(const QString &fileName, int frameCount);
+    void close();
+    [[nodiscard]] bool isOpen() const;
+    /// True if all frames are kept, false if the frames are streamed through the ring buffer.
+    [[nodiscard]] bool keepsAllFrames() const;
+
+    /// Returns the frame of the given index, waits for the worker if the frame has not been decoded yet.
+    /// The ring buffer expects the frames are taken in order, the skipped ones are dropped.
+    /// Returns nothing if the decoding failed, or the buffer is not open.
+    [[nodiscard]] std::optional<Frame> takeFrame(int index);
+
+    /// The kept frames are reported in the AnimationFrames category.
+    void setMemoryBudget(MemoryBudget *budget);
+
+    static constexpr int m_ringCapacity {8};
+    // Limit of the kept frames if there is no budget
+    static constexpr qsizetype m_defaultMaxSize {256 * 1024 * 1024};
+
+protected:
+    void decodeFrames(const QString &fileName, int frameCount);
+    void reportUsage();
+
+private:
+    struct IndexedFrame
+    {
+        int index {0};
+        Frame frame {};
+    };
+
+    mutable QMutex m_mutex {};
+    QWaitCondition m_frameDecoded {};
+    QWaitCondition m_frameTaken {};
+    // All frames in their order, if they are kept
+    std::vector<Frame> m_frames {};
+    // Frames decoded ahead, if they are streamed
+    std::deque<IndexedFrame> m_ring {};
+    qsizetype m_size {0};
+    int m_frameCount {0};
+    bool m_isOpen {false};
+    bool m_keepsAllFrames {false};
+    bool m_isFailed {false};
+    std::atomic_bool m_isCancelled {false};
+
+    MemoryBudget *m_memoryBudget {nullptr};
+    int m_budgetHolder {0};
+    QThreadPool m_threadPool {};
+};
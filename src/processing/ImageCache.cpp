@@ -0,0 +1,173 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ImageCache.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+ImageCache::ImageCache(const qsizetype maxSize)
+                                        : m_maxSize(maxSize)
+{
+}
+
+ImageCache::~ImageCache()
+{
+    setMemoryBudget(nullptr);
+}
+
+QString ImageCache::imageKey(const QString &fileName, const QSize &scaledSizeHint)
+{
+    const QFileInfo info {fileName};
+    return QStringLiteral("%1|%2|%3|%4x%5")
+        .arg(fileName)
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch())
+        .arg(scaledSizeHint.width())
+        .arg(scaledSizeHint.height());
+}
+
+bool ImageCache::contains(const QString &fileName) const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_index.contains(fileName);
+}
+
+QImage ImageCache::find(const QString &fileName)
+{
+    const QMutexLocker locker(&m_mutex);
+    const auto it = m_index.find(fileName);
+    if (it == m_index.end())
+        return {};
+
+    // Mark as the most recently used
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->second;
+}
+
+void ImageCache::insert(const QString &fileName, const QImage &image)
+{
+    if (fileName.isEmpty() || image.isNull())
+        return;
+
+    {
+        const QMutexLocker locker(&m_mutex);
+        if (const auto it = m_index.find(fileName); it != m_index.end())
+        {
+            m_size -= it->second->second.sizeInBytes();
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
+
+        // Image which cannot fit into the cache at all would just flush everything else.
+        if (image.sizeInBytes() <= m_maxSize)
+        {
+            evict(m_maxSize - image.sizeInBytes());
+            m_entries.emplace_front(fileName, image);
+            m_index.emplace(fileName, m_entries.begin());
+            m_size += image.sizeInBytes();
+        }
+    }
+
+    reportUsage();
+}
+
+void ImageCache::remove(const QString &fileName)
+{
+    {
+        const QMutexLocker locker(&m_mutex);
+        if (const auto it = m_index.find(fileName); it != m_index.end())
+        {
+            m_size -= it->second->second.sizeInBytes();
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
+    }
+
+    reportUsage();
+}
+
+void ImageCache::clear()
+{
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_index.clear();
+        m_entries.clear();
+        m_size = 0;
+    }
+
+    reportUsage();
+}
+
+qsizetype ImageCache::count() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return static_cast<qsizetype>(m_entries.size());
+}
+
+qsizetype ImageCache::size() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+qsizetype ImageCache::maxSize() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_maxSize;
+}
+
+void ImageCache::setMaxSize(const qsizetype maxSize)
+{
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_maxSize = maxSize;
+        evict(m_maxSize);
+    }
+
+    reportUsage();
+}
+
+void ImageCache::setMemoryBudget(MemoryBudget *budget)
+{
+    if (m_budget)
+        m_budget->unregisterHolder(m_budgetHolder);
+
+    m_budget = budget;
+    if (!m_budget)
+        return;
+
+    // Called by the budget with its lock held, so it must not report back.
+    m_budgetHolder = m_budget->registerHolder(MemoryBudget::Category::Cache, [this](const qsizetype maxSize) {
+        const QMutexLocker locker(&m_mutex);
+        evict(maxSize);
+        return m_size;
+    });
+    reportUsage();
+}
+
+void ImageCache::reportUsage() const
+{
+    // Called without the m_mutex locked, since the budget may ask this cache to evict.
+    if (m_budget)
+        m_budget->setUsage(m_budgetHolder, size());
+}
+
+void ImageCache::evict(const qsizetype maxSize)
+{
+    // Expects the m_mutex is already locked by the caller.
+    while (!m_entries.empty() && m_size > maxSize)
+    {
+        const auto &[fileName, image] = m_entries.back();
+        m_size -= image.sizeInBytes();
+        m_index.erase(fileName);
+        m_entries.pop_back();
+    }
+}
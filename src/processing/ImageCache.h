@@ -0,0 +1,66 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include "MemoryBudget.h"
+#include "../util/compiler.h"
+
+/// Size-bounded LRU cache of decoded images keyed by strings, imageKey() makes the keys of the decoded files.
+/// All methods are thread-safe, so the cache could be filled from worker threads.
+class ImageCache
+{
+public:
+    explicit ImageCache(qsizetype maxSize = m_defaultMaxSize);
+    ~ImageCache();
+    DISABLE_COPY_MOVE(ImageCache);
+
+    /// Tells the file content by its size and modification time, and the requested decoding size apart,
+    /// so the modified file is decoded again and the reduced resolution does not replace the full one.
+    [[nodiscard]] static QString imageKey(const QString &fileName, const QSize &scaledSizeHint);
+
+    [[nodiscard]] bool contains(const QString &fileName) const;
+    [[nodiscard]] QImage find(const QString &fileName);
+    void insert(const QString &fileName, const QImage &image);
+    void remove(const QString &fileName);
+    void clear();
+
+    [[nodiscard]] qsizetype count() const;
+    [[nodiscard]] qsizetype size() const;
+    [[nodiscard]] qsizetype maxSize() const;
+    void setMaxSize(qsizetype maxSize);
+    /// Reports the cache size to the budget, which evicts the least recently used images under pressure.
+    /// Not thread-safe, the budget has to be set before the cache is shared with other threads.
+    void setMemoryBudget(MemoryBudget *budget);
+
+    static constexpr qsizetype m_defaultMaxSize {512 * 1024 * 1024};
+
+protected:
+    void evict(qsizetype maxSize);
+    void reportUsage() const;
+
+private:
+    using Entry = std::pair<QString, QImage>;
+
+    mutable QMutex m_mutex {};
+    // The most recently used entry is at the front.
+    std::list<Entry> m_entries {};
+    std::unordered_map<QString, std::list<Entry>::iterator> m_index {};
+    qsizetype m_size {0};
+    qsizetype m_maxSize;
+    MemoryBudget *m_budget {nullptr};
+    int m_budgetHolder {0};
+};
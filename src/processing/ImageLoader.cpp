@@ -9,21 +9,101 @@ VookiImageViewer - a tool for showing images.
 ****************************************************************************/
 
 #include "ImageLoader.h"
+#include "ImageTileSource.h"
 #include <QDebug>
+#include <QFile>
+#include <QtConcurrent>
+#include <algorithm>
+#include <qcorofuture.h>
+#include <utility>
+
+namespace
+{
+    /// Image plugins read the data through the QIODevice, so failing the reads
+    /// is the way how to interrupt the decoding which is already in progress.
+    class CancellableFile : public QFile
+    {
+    public:
+        CancellableFile(const QString &fileName, std::shared_ptr<std::atomic_bool> isCancelled)
+                                        : QFile(fileName)
+                                        , m_isCancelled(std::move(isCancelled))
+        {
+        }
+
+    protected:
+        qint64 readData(char *data, const qint64 maxSize) override
+        {
+            if (m_isCancelled->load())
+                return -1;
+
+            return QFile::readData(data, maxSize);
+        }
+
+    private:
+        std::shared_ptr<std::atomic_bool> m_isCancelled;
+    };
+}
+
+ImageLoader::ImageLoader()
+{
+    // Decoding more images at once just delays the one the user is waiting for.
+    m_threadPool.setMaxThreadCount(1);
+}
+
+ImageLoader::~ImageLoader()
+{
+    cancel();
+    m_threadPool.waitForDone();
+}
+
+void ImageLoader::configureReader(QImageReader &reader)
+{
+    reader.setQuality(100);
+    reader.setAutoTransform(true);
+}
 
 bool ImageLoader::loadImage(const QString &fileName)
 {
-    QImageReader::setAllocationLimit(ImageLoader::m_maxAllocationImageSize);
+    cancel();
+
+    QImageReader::setAllocationLimit(MemoryBudget::allocationLimit(m_memoryBudget ? m_memoryBudget->getBudget() : MemoryBudget::defaultBudget()));
     m_reader.setFileName(fileName);
-    m_reader.setQuality(100);
-    m_reader.setAutoTransform(true);
+    configureReader(m_reader);
 
     m_originalImage = QImage();
+    m_decodeStrategy = MemoryBudget::DecodeStrategy::Full;
+    m_animationFrames.close();
+    m_frameDelay.reset();
+    m_frameRect = m_changedRect = {};
 
     if (m_reader.canRead())
     {
         if (isAnimated())
+        {
             m_animationIndex.set(0, imageCount());
+            // Animation frames are always decoded in the full resolution.
+            m_reader.setScaledSize({});
+            return true;
+        }
+
+        QSize scaledSizeHint {m_scaledSizeHint};
+        if (m_memoryBudget)
+        {
+            const QSize size {m_reader.size()};
+            m_decodeStrategy = m_memoryBudget->decodeStrategy(size, m_reader.supportsOption(QImageIOHandler::ScaledSize), ImageTileSource::isSupported(m_reader));
+            if (m_decodeStrategy != MemoryBudget::DecodeStrategy::Full)
+            {
+                // The tiles provide the details, so the overview does not need to use the whole budget.
+                QSize reducedSize {m_memoryBudget->scaledSize(size)};
+                if (m_decodeStrategy == MemoryBudget::DecodeStrategy::Tiled)
+                    reducedSize = reducedSize.boundedTo(size.scaled(m_tiledOverviewSide, m_tiledOverviewSide, Qt::KeepAspectRatio));
+
+                if (!scaledSizeHint.isValid() || std::max(reducedSize.width(), reducedSize.height()) < std::max(scaledSizeHint.width(), scaledSizeHint.height()))
+                    scaledSizeHint = reducedSize;
+            }
+        }
+
+        m_reader.setScaledSize(computeScaledSize(m_reader, scaledSizeHint));
         return true;
     }
 
@@ -33,17 +113,111 @@ bool ImageLoader::loadImage(const QString &fileName)
 const QImage &ImageLoader::getImage()
 {
     if (m_originalImage.isNull())
+    {
         m_reader.read(&m_originalImage);
+        bufferAnimationFrames();
+    }
 
     return m_originalImage;
 }
 
+QCoro::Task<QImage> ImageLoader::getImageAsync()
+{
+    if (!m_originalImage.isNull())
+        co_return m_originalImage;
+
+    const auto isCancelled {m_isCancelled};
+    const QString fileName {m_reader.fileName()};
+    const QSize scaledSize {m_reader.scaledSize()};
+    const QImage image {co_await QtConcurrent::run(&m_threadPool, [fileName, scaledSize, isCancelled]() {
+        return ImageLoader::decode(fileName, scaledSize, isCancelled);
+    })};
+
+    // Another image has been loaded meanwhile, so the loader does not belong to this request anymore.
+    if (isCancelled->load())
+        co_return QImage{};
+
+    m_originalImage = image;
+    bufferAnimationFrames();
+    co_return m_originalImage;
+}
+
+void ImageLoader::bufferAnimationFrames()
+{
+    // Started along with the first frame only, so the animations just probed (e.g. by the prefetcher) cost nothing.
+    if (isAnimated() && !m_animationFrames.isOpen())
+        m_animationFrames.open(m_reader.fileName(), imageCount());
+}
+
+void ImageLoader::cancel()
+{
+    m_isCancelled->store(true);
+    m_isCancelled = std::make_shared<std::atomic_bool>(false);
+}
+
+QSize ImageLoader::computeScaledSize(const QImageReader &reader, const QSize &areaSize)
+{
+    // Plugins not supporting the scaled decoding would decode the full image and scale it afterwards,
+    // which is just a waste of time since the ImageProcessor does the scaling anyway.
+    if (!areaSize.isValid() || !reader.supportsOption(QImageIOHandler::ScaledSize))
+        return {};
+
+    const QSize size {reader.size()};
+    if (!size.isValid())
+        return {};
+
+    // Covers the area even if the image is rotated by 90 degrees later.
+    const int areaSide {std::max(areaSize.width(), areaSize.height())};
+    const int imageSide {std::max(size.width(), size.height())};
+    if (imageSide <= areaSide)
+        return {};
+
+    const double factor {static_cast<double>(areaSide) / imageSide};
+    return { std::max(1, qRound(size.width() * factor)), std::max(1, qRound(size.height() * factor)) };
+}
+
+QImage ImageLoader::decode(const QString &fileName, const QSize &scaledSize, const std::shared_ptr<std::atomic_bool> &isCancelled)
+{
+    // Stale requests waiting in the queue are dropped without touching the file at all.
+    if (isCancelled->load())
+        return {};
+
+    CancellableFile file {fileName, isCancelled};
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QImageReader reader {&file};
+    configureReader(reader);
+    reader.setScaledSize(scaledSize);
+
+    // Interrupted by the cancellation as often as not, so the failure is not worth reporting.
+    QImage image;
+    if (!reader.read(&image))
+        return {};
+
+    return image;
+}
+
 const QImage &ImageLoader::getNextImage()
 {
     if (!isAnimated())
         return getImage();
 
-    if (++m_animationIndex == 0)
+    ++m_animationIndex;
+    // Frames are decoded ahead on the worker, the GUI thread waits just if the worker is late.
+    if (const auto frame {m_animationFrames.takeFrame(static_cast<int>(m_animationIndex))})
+    {
+        m_originalImage = frame->image;
+        m_frameDelay = frame->delay;
+        m_changedRect = m_frameRect.isNull() || frame->rect.isNull() ? QRect {} : m_frameRect | frame->rect;
+        m_frameRect = frame->rect;
+        return m_originalImage;
+    }
+
+    // The frame buffer has failed, so the frames are decoded here the old way.
+    m_frameDelay.reset();
+    m_frameRect = m_changedRect = {};
+    if (m_animationIndex == 0)
         m_reader.setFileName(m_reader.fileName());
 
     qDebug() << "Index: " << m_animationIndex;
@@ -54,6 +228,41 @@ const QImage &ImageLoader::getNextImage()
     return m_originalImage;
 }
 
+QString ImageLoader::getFileName() const
+{
+    return m_reader.fileName();
+}
+
+QSize ImageLoader::getOriginalSize() const
+{
+    const QSize size {m_reader.size()};
+    if (m_reader.autoTransform() && m_reader.transformation().testFlag(QImageIOHandler::TransformationRotate90))
+        return size.transposed();
+
+    return size;
+}
+
+void ImageLoader::setScaledSizeHint(const QSize &areaSize)
+{
+    m_scaledSizeHint = areaSize;
+}
+
+QSize ImageLoader::getScaledSizeHint() const
+{
+    return m_scaledSizeHint;
+}
+
+void ImageLoader::setMemoryBudget(MemoryBudget *budget)
+{
+    m_memoryBudget = budget;
+    m_animationFrames.setMemoryBudget(budget);
+}
+
+MemoryBudget::DecodeStrategy ImageLoader::getDecodeStrategy() const
+{
+    return m_decodeStrategy;
+}
+
 bool ImageLoader::isAnimated() const
 {
     return imageCount() != 0;
@@ -66,5 +275,10 @@ int ImageLoader::imageCount() const
 
 int ImageLoader::nextImageDelay() const
 {
-    return m_reader.nextImageDelay();
+    return m_frameDelay.value_or(m_reader.nextImageDelay());
+}
+
+QRect ImageLoader::getChangedRect() const
+{
+    return m_changedRect;
 }
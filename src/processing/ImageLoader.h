@@ -12,26 +12,71 @@ VookiImageViewer - a tool for showing images.
 #include <QImage>
 #include <QImageReader>
 #include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <qcorotask.h>
+#include "AnimationFrameBuffer.h"
+#include "MemoryBudget.h"
 #include "../util/compiler.h"
 #include "../util/RotatingIndex.h"
 
 class ImageLoader
 {
 public:
-    ImageLoader() = default;
+    ImageLoader();
+    ~ImageLoader();
     DISABLE_COPY_MOVE(ImageLoader);
 
     bool loadImage(const QString &fileName);
     [[nodiscard]] const QImage &getImage();
+    /// Decodes the image on the worker thread. The null image is returned if the decoding
+    /// was cancelled by loading another image or by calling the cancel().
+    [[nodiscard]] QCoro::Task<QImage> getImageAsync();
+    void cancel();
     [[nodiscard]] const QImage &getNextImage();
+    [[nodiscard]] QString getFileName() const;
+    /// Full resolution size of the loaded image, the orientation is already applied.
+    [[nodiscard]] QSize getOriginalSize() const;
+    /// Enables the reduced resolution decoding, so the image is decoded just large enough to cover
+    /// the given area in any orientation. The invalid size enables the full resolution decoding.
+    void setScaledSizeHint(const QSize &areaSize);
+    [[nodiscard]] QSize getScaledSizeHint() const;
+    /// The budget limits the allocations and chooses the decode strategy of every loaded image.
+    /// Without the budget, images are always decoded as requested by the scaled size hint.
+    /// Animation frames decoded ahead are reported to it as well.
+    void setMemoryBudget(MemoryBudget *budget);
+    /// Strategy chosen for the loaded image. The Scaled and Tiled ones reduce the resolution regardless of the hint.
+    [[nodiscard]] MemoryBudget::DecodeStrategy getDecodeStrategy() const;
     [[nodiscard]] bool isAnimated() const;
     [[nodiscard]] int imageCount() const;
     [[nodiscard]] int nextImageDelay() const;
+    /// Part of the image changed by the last getNextImage(), the null rectangle stands for the whole image.
+    [[nodiscard]] QRect getChangedRect() const;
+
+protected:
+    static void configureReader(QImageReader &reader);
+    void bufferAnimationFrames();
+    [[nodiscard]] static QSize computeScaledSize(const QImageReader &reader, const QSize &areaSize);
+    [[nodiscard]] static QImage decode(const QString &fileName, const QSize &scaledSize, const std::shared_ptr<std::atomic_bool> &isCancelled);
 
 private:
     RotatingIndex<> m_animationIndex {0, 1};
     QImage m_originalImage {};
     QImageReader m_reader {};
+    QSize m_scaledSizeHint {};
+    MemoryBudget *m_memoryBudget {nullptr};
+    MemoryBudget::DecodeStrategy m_decodeStrategy {MemoryBudget::DecodeStrategy::Full};
+    std::shared_ptr<std::atomic_bool> m_isCancelled {std::make_shared<std::atomic_bool>(false)};
+    QThreadPool m_threadPool {};
+    // Frames following the first one, which is decoded by getImage() as any other image
+    AnimationFrameBuffer m_animationFrames {};
+    std::optional<int> m_frameDelay {};
+    // The area updated by the previous frame is changed too, since its disposal restores the background there.
+    QRect m_frameRect {};
+    QRect m_changedRect {};
 
-    static constexpr int m_maxAllocationImageSize = 4096;
+    // Longer side of the overview the tiled images are decoded to
+    static constexpr int m_tiledOverviewSide {4096};
 };
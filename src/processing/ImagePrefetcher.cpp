@@ -0,0 +1,113 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ImagePrefetcher.h"
+#include "ImageLoader.h"
+#include <QMutexLocker>
+#include <QScopeGuard>
+#include <QThread>
+#include <algorithm>
+
+ImagePrefetcher::ImagePrefetcher(ImageCache &cache)
+                                        : m_cache(cache)
+{
+    // Leave some cores for the GUI thread and for the image being currently shown.
+    m_threadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+ImagePrefetcher::~ImagePrefetcher()
+{
+    cancel();
+    m_threadPool.waitForDone();
+}
+
+void ImagePrefetcher::prefetch(const QStringList &fileNames)
+{
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_requested = { fileNames.cbegin(), fileNames.cend() };
+    }
+
+    QSize scaledSizeHint;
+    {
+        const QMutexLocker locker(&m_mutex);
+        scaledSizeHint = m_scaledSizeHint;
+    }
+
+    int priority = static_cast<int>(fileNames.size());
+    for (const QString &fileName : fileNames)
+    {
+        --priority;
+        if (fileName.isEmpty() || m_cache.contains(ImageCache::imageKey(fileName, scaledSizeHint)))
+            continue;
+
+        {
+            const QMutexLocker locker(&m_mutex);
+            if (!m_scheduled.insert(fileName).second)
+                continue;
+        }
+
+        m_threadPool.start([this, fileName]() { decode(fileName); }, priority);
+    }
+}
+
+void ImagePrefetcher::cancel()
+{
+    const QMutexLocker locker(&m_mutex);
+    m_requested.clear();
+}
+
+void ImagePrefetcher::setScaledSizeHint(const QSize &areaSize)
+{
+    const QMutexLocker locker(&m_mutex);
+    m_scaledSizeHint = areaSize;
+}
+
+void ImagePrefetcher::setMemoryBudget(MemoryBudget *budget)
+{
+    const QMutexLocker locker(&m_mutex);
+    m_memoryBudget = budget;
+}
+
+void ImagePrefetcher::decode(const QString &fileName)
+{
+    QSize scaledSizeHint;
+    MemoryBudget *memoryBudget {nullptr};
+    {
+        // The user has already moved somewhere else, this image is not interesting anymore.
+        const QMutexLocker locker(&m_mutex);
+        if (!m_requested.contains(fileName))
+        {
+            m_scheduled.erase(fileName);
+            return;
+        }
+        scaledSizeHint = m_scaledSizeHint;
+        memoryBudget = m_memoryBudget;
+    }
+
+    const auto unschedule = qScopeGuard([this, &fileName]() {
+        const QMutexLocker locker(&m_mutex);
+        m_scheduled.erase(fileName);
+    });
+
+    const QString key {ImageCache::imageKey(fileName, scaledSizeHint)};
+    if (m_cache.contains(key))
+        return;
+
+    ImageLoader loader;
+    loader.setScaledSizeHint(scaledSizeHint);
+    loader.setMemoryBudget(memoryBudget);
+    // Animations are decoded frame by frame, so there is nothing to gain from caching the first frame.
+    if (!loader.loadImage(fileName) || loader.isAnimated())
+        return;
+
+    if (const QImage image {loader.getImage()}; !image.isNull())
+        m_cache.insert(key, image);
+}
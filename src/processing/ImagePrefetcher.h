@@ -0,0 +1,50 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <unordered_set>
+#include "ImageCache.h"
+#include "MemoryBudget.h"
+#include "../util/compiler.h"
+
+/// Decodes images in advance on the worker threads and stores them into the ImageCache.
+class ImagePrefetcher
+{
+public:
+    explicit ImagePrefetcher(ImageCache &cache);
+    ~ImagePrefetcher();
+    DISABLE_COPY_MOVE(ImagePrefetcher);
+
+    /// Requests the given images to be decoded, the first one has the highest priority.
+    /// Images requested by the previous call which have not been started yet are dropped.
+    void prefetch(const QStringList &fileNames);
+    void cancel();
+    /// See ImageLoader::setScaledSizeHint()
+    void setScaledSizeHint(const QSize &areaSize);
+    /// See ImageLoader::setMemoryBudget()
+    void setMemoryBudget(MemoryBudget *budget);
+
+protected:
+    void decode(const QString &fileName);
+
+private:
+    ImageCache &m_cache;
+    QMutex m_mutex {};
+    std::unordered_set<QString> m_requested {};
+    std::unordered_set<QString> m_scheduled {};
+    QSize m_scaledSizeHint {};
+    MemoryBudget *m_memoryBudget {nullptr};
+    QThreadPool m_threadPool {};
+};
@@ -9,23 +9,75 @@ VookiImageViewer - a tool for showing images.
 ****************************************************************************/
 
 #include "ImageProcessor.h"
+#include "ImageQuadrantTransform.h"
+#include "transformation/ImageResampler.h"
+#include <QPainter>
+#include <QtConcurrent>
 #include <algorithm>
+#include <cmath>
+#include <qcorofuture.h>
+#include <utility>
 
-void ImageProcessor::bind(const QImage &image, const bool resetTransformation)
+ImageProcessor::ImageProcessor()
+{
+    // Only the latest refinement matters, the resampling itself runs in parallel anyway.
+    m_threadPool.setMaxThreadCount(1);
+}
+
+ImageProcessor::~ImageProcessor()
+{
+    ++m_generation;
+    m_threadPool.waitForDone();
+    setMemoryBudget(nullptr);
+}
+
+void ImageProcessor::bind(const QImage &image, const bool resetTransformation, const QSize &originalSize)
 {
     // shallow copy
     m_originalImage = image;
+    m_originalSize = originalSize.isValid() ? originalSize : image.size();
+    m_imagePyramid.bind(m_originalImage);
+    m_frameRendering.reset();
+    m_frameImage = {};
     resetTransformation ? ImageProcessor::resetTransformation() : m_genericTransformations.front()->setIsCacheDirty(true);
 }
 
-QImage ImageProcessor::process()
+bool ImageProcessor::bindFrame(const QImage &frame, const QRect &changedRect)
+{
+    // Anything else than the next frame with the same size and the same transformations goes the common way.
+    const bool isDirty {std::ranges::any_of(m_transformations, [](auto const transformation) { return transformation->isCacheDirty(); })};
+    if (!m_frameRendering || isDirty || m_progressiveRendering || frame.isNull() || frame.size() != m_originalImage.size())
+    {
+        bind(frame, false);
+        return false;
+    }
+
+    // shallow copy
+    m_originalImage = frame;
+    m_imagePyramid.bind(m_originalImage);
+
+    const QImage source {m_imagePyramid.level(m_frameRendering->level)};
+    // The viewport rendering transforms the frame while painting anyway.
+    if (m_frameRendering->isViewport)
+        m_imageBorder.bind(source);
+    else
+        renderFrame(source, m_frameRendering->level == 0 ? changedRect : QRect {});
+
+    reportUsage();
+    return true;
+}
+
+void ImageProcessor::prepare()
 {
     if (m_originalImage.isNull())
-        return m_originalImage;
+        return;
 
-    m_imageZoom.setOriginalImageSize(m_originalImage.size());
+    if (m_imageZoom.getOriginalImageSize() != m_originalSize)
+        m_imageZoom.setOriginalImageSize(m_originalSize);
 
-    QTransform lastTransformation {};
+    // Maps the bound image pixels to the full resolution coordinates
+    QTransform lastTransformation {QTransform::fromScale(static_cast<double>(m_originalSize.width()) / m_originalImage.width(),
+                                                         static_cast<double>(m_originalSize.height()) / m_originalImage.height())};
     bool needsTransformation { m_transformations.front()->isCacheDirty() };
     for (auto const transformation : m_transformations)
     {
@@ -38,19 +90,238 @@ QImage ImageProcessor::process()
         lastTransformation = transformation->transform().value<QTransform>();
     }
 
-    needsTransformation = needsTransformation || m_imageTransformations.front()->isCacheDirty();
+    // The scroll offsets and colors are applied by the border only, so the transformed image is kept.
     if (needsTransformation)
     {
-        QImage lastTransformedImage = m_originalImage.transformed(lastTransformation, Qt::SmoothTransformation);
-        for (auto const transformation : m_imageTransformations)
+        // Zooming out resamples the nearest larger pyramid level instead of the whole original image,
+        // so the cost is given by the output size rather than by the source one.
+        const int level {m_imagePyramid.levelForScaleFactor(getImageScaleFactor())};
+        const QImage source {m_imagePyramid.level(level)};
+        const QTransform sourceTransformation {QTransform::fromScale(static_cast<double>(m_originalImage.width()) / source.width(),
+                                                                     static_cast<double>(m_originalImage.height()) / source.height()) * lastTransformation};
+
+        // The viewport rendering leaves the resampling on the border, which maps just the visible area back to the source.
+        const bool isViewport {isViewportRendering(sourceTransformation.mapRect(QRectF{source.rect()}).toAlignedRect().size())};
+        m_imageBorder.setSourceTransformation(isViewport ? std::optional {sourceTransformation} : std::nullopt);
+
+        const QRectF bounds {sourceTransformation.mapRect(QRectF{source.rect()})};
+        m_fullResolutionTransformation = QTransform::fromScale(static_cast<double>(source.width()) / m_originalSize.width(),
+                                                               static_cast<double>(source.height()) / m_originalSize.height());
+        if (!isViewport)
+            m_fullResolutionTransformation *= sourceTransformation * QTransform::fromTranslate(-bounds.left(), -bounds.top());
+
+        // A pending refinement belongs to the previous transformation.
+        ++m_generation;
+        m_refinement.reset();
+        m_frameRendering = FrameRendering {level, sourceTransformation, isViewport};
+        m_frameImage = {};
+
+        if (isViewport)
+            m_imageBorder.bind(source);
+        else if (m_progressiveRendering && !ImageQuadrantTransform::isQuadrant(sourceTransformation))
         {
-            transformation->bind(lastTransformedImage);
-            lastTransformedImage = transformation->transform().value<QImage>();
+            m_imageBorder.bind(transformed(source, sourceTransformation, true));
+            m_refinement = Refinement {source, sourceTransformation};
         }
-        return lastTransformedImage;
+        else
+            m_imageBorder.bind(transformed(source, sourceTransformation));
+
+        reportUsage();
     }
+}
 
-    return m_transformations.front()->transform().value<QImage>();
+QImage ImageProcessor::process()
+{
+    if (m_originalImage.isNull())
+        return m_originalImage;
+
+    prepare();
+    return m_imageBorder.transform().value<QImage>();
+}
+
+void ImageProcessor::paint(QPainter &painter, const QRect &dirtyRect)
+{
+    if (m_originalImage.isNull())
+        return;
+
+    prepare();
+    m_imageBorder.paint(painter, dirtyRect);
+
+    m_missingTiles.clear();
+    // The bound image is just an overview of the tiled one, which is not detailed enough when upscaled.
+    if (m_tileSource && getImageScaleFactor() > 1.0)
+        paintTiles(painter, dirtyRect);
+}
+
+void ImageProcessor::paintTiles(QPainter &painter, const QRect &dirtyRect)
+{
+    const QTransform areaTransformation {m_fullResolutionTransformation * m_imageBorder.areaTransformation()};
+    QRect imageRect {areaTransformation.mapRect(QRectF{QPointF{}, QSizeF{m_originalSize}}).toAlignedRect()};
+    if (m_imageBorder.getDrawBorder())
+        imageRect.adjust(ImageBorder<QImage>::borderWidth, ImageBorder<QImage>::borderWidth, -ImageBorder<QImage>::borderWidth, -ImageBorder<QImage>::borderWidth);
+
+    const QRect clipRect {imageRect & dirtyRect};
+    bool isInvertible {false};
+    const QTransform inverted {areaTransformation.inverted(&isInvertible)};
+    if (clipRect.isEmpty() || !isInvertible)
+        return;
+
+    const int level {m_tileSource->levelForScaleFactor(getScaleFactor())};
+    const QTransform worldTransformation {painter.worldTransform()};
+    painter.save();
+    painter.setClipRect(clipRect);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (const ImageTileSource::Tile &tile : m_tileSource->tiles(level, inverted.mapRect(QRectF{clipRect}).toAlignedRect()))
+    {
+        // Missing tiles are decoded later on, the overview is shown there meanwhile.
+        const QImage image {m_tileSource->tile(tile)};
+        if (image.isNull())
+        {
+            m_missingTiles.push_back(tile);
+            continue;
+        }
+
+        const QRect rect {m_tileSource->tileRect(tile)};
+        painter.setWorldTransform(QTransform::fromScale(static_cast<double>(rect.width()) / image.width(), static_cast<double>(rect.height()) / image.height())
+                                  * QTransform::fromTranslate(rect.x(), rect.y()) * areaTransformation * worldTransformation);
+        painter.drawImage(QPointF{0, 0}, image);
+    }
+    painter.restore();
+}
+
+void ImageProcessor::renderFrame(const QImage &source, const QRect &changedRect)
+{
+    const QTransform &transformation {m_frameRendering->transformation};
+    const QRectF bounds {transformation.mapRect(QRectF{source.rect()})};
+    const QTransform targetTransformation {transformation * QTransform::fromTranslate(-bounds.left(), -bounds.top())};
+
+    // The border keeps a shallow copy, it is released first, so the painting does not detach the reused image.
+    m_imageBorder.bind(QImage {});
+
+    QRect rect {changedRect.isNull() ? source.rect() : changedRect & source.rect()};
+    if (m_frameImage.size() != bounds.toAlignedRect().size())
+    {
+        // The previous frame is not there, so the whole frame is painted.
+        m_frameImage = QImage {bounds.toAlignedRect().size(), QImage::Format_ARGB32_Premultiplied};
+        m_frameImage.fill(Qt::transparent);
+        rect = source.rect();
+    }
+
+    if (!rect.isEmpty())
+    {
+        QPainter painter {&m_frameImage};
+        // The smooth transformation samples the neighbouring source pixels, so every destination pixel sampling
+        // the changed ones is repainted. Once upscaled, that is more than a single destination pixel.
+        painter.setClipRect(targetTransformation.mapRect(QRectF{rect.adjusted(-1, -1, 1, 1) & source.rect()}).toAlignedRect());
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, !ImageQuadrantTransform::isQuadrant(transformation));
+        painter.setTransform(targetTransformation);
+        painter.drawImage(QPointF{0, 0}, source);
+    }
+
+    m_imageBorder.bind(m_frameImage);
+}
+
+bool ImageProcessor::isProgressiveRenderingEnabled() const
+{
+    return m_progressiveRendering;
+}
+
+void ImageProcessor::setProgressiveRendering(const bool progressiveRendering)
+{
+    m_progressiveRendering = progressiveRendering;
+}
+
+bool ImageProcessor::isRefinementPending() const
+{
+    return m_refinement.has_value();
+}
+
+QCoro::Task<bool> ImageProcessor::refine()
+{
+    if (!m_refinement || m_refinement->isStarted)
+        co_return false;
+
+    m_refinement->isStarted = true;
+    const quint64 generation {m_generation};
+    const QImage source {m_refinement->source};
+    const QTransform transformation {m_refinement->transformation};
+    const std::weak_ptr<bool> alive {m_alive};
+    const QImage image {co_await QtConcurrent::run(&m_threadPool, [this, generation, source, transformation]() {
+        // Refinements superseded while waiting in the queue are not worth starting.
+        return generation == m_generation ? transformed(source, transformation) : QImage {};
+    })};
+
+    // Waiting for the thread pool in the destructor does not stop the resume queued already.
+    if (alive.expired() || generation != m_generation || image.isNull())
+        co_return false;
+
+    m_imageBorder.bind(image);
+    m_refinement.reset();
+    reportUsage();
+    co_return true;
+}
+
+void ImageProcessor::setTileSource(ImageTileSource *tileSource)
+{
+    m_tileSource = tileSource;
+    m_missingTiles.clear();
+}
+
+bool ImageProcessor::isTileDecodingPending() const
+{
+    return !m_missingTiles.empty();
+}
+
+QCoro::Task<bool> ImageProcessor::decodeTiles()
+{
+    if (!m_tileSource || m_missingTiles.empty())
+        co_return false;
+
+    const std::vector<ImageTileSource::Tile> tiles {std::exchange(m_missingTiles, {})};
+    co_return co_await m_tileSource->decode(tiles);
+}
+
+QImage ImageProcessor::transformed(const QImage &image, const QTransform &transformation, const bool isPreview)
+{
+    // Rotations and flips without any zoom just move the pixels.
+    if (ImageQuadrantTransform::isQuadrant(transformation))
+        return ImageQuadrantTransform::transformed(image, transformation);
+
+    // x' = m11 * x + m21 * y, y' = m12 * x + m22 * y
+    const bool isTransposed {transformation.m11() == 0.0 && transformation.m22() == 0.0};
+    const double scaleX {std::abs(isTransposed ? transformation.m12() : transformation.m11())};
+    const double scaleY {std::abs(isTransposed ? transformation.m21() : transformation.m22())};
+    const bool isAxisAligned {transformation.isAffine() && (isTransposed || (transformation.m12() == 0.0 && transformation.m21() == 0.0))};
+    if (!isAxisAligned || scaleX == 0.0 || scaleY == 0.0)
+        return image.transformed(transformation, isPreview ? Qt::FastTransformation : Qt::SmoothTransformation);
+
+    // The zoom is resampled in the image orientation first, the rest is a lossless quadrant transformation.
+    const QSize size {std::max(1, qRound(image.width() * scaleX)), std::max(1, qRound(image.height() * scaleY))};
+    const QImage resampled {isPreview ? image.scaled(size, Qt::IgnoreAspectRatio, Qt::FastTransformation)
+                                      : ImageResampler::resampled(image, size, ImageResampler::filterForScaleFactor(std::min(scaleX, scaleY)))};
+
+    const auto sign = [](const qreal value) { return value > 0 ? 1.0 : value < 0 ? -1.0 : 0.0; };
+    const QTransform quadrant {sign(transformation.m11()), sign(transformation.m12()), sign(transformation.m21()), sign(transformation.m22()), 0, 0};
+    return quadrant.isIdentity() ? resampled : ImageQuadrantTransform::transformed(resampled, quadrant);
+}
+
+bool ImageProcessor::isViewportRendering(const QSize &transformedSize) const
+{
+    switch (m_renderMode)
+    {
+        case RenderMode::Full:
+            return false;
+        case RenderMode::Viewport:
+            return true;
+        case RenderMode::Automatic:
+        {
+            const qint64 pixels {static_cast<qint64>(transformedSize.width()) * transformedSize.height()};
+            return pixels > m_maxFullRenderPixels || (m_memoryBudget && pixels * MemoryBudget::m_bytesPerPixel > m_memoryBudget->available());
+        }
+    }
+
+    return false;
 }
 
 void ImageProcessor::setAreaSize(const QSize &size)
@@ -59,6 +330,26 @@ void ImageProcessor::setAreaSize(const QSize &size)
     m_imageBorder.setAreaSize(size);
 }
 
+void ImageProcessor::setMemoryBudget(MemoryBudget *budget)
+{
+    if (m_memoryBudget)
+        m_memoryBudget->unregisterHolder(m_budgetHolder);
+
+    m_memoryBudget = budget;
+    if (m_memoryBudget)
+        m_budgetHolder = m_memoryBudget->registerHolder(MemoryBudget::Category::ProcessedImage);
+}
+
+void ImageProcessor::reportUsage() const
+{
+    if (!m_memoryBudget)
+        return;
+
+    // The viewport rendering binds a pyramid level to the border, which is not a copy.
+    const qsizetype transformedSize {m_imageBorder.getSourceTransformation() ? 0 : m_imageBorder.getOriginalObject().sizeInBytes()};
+    m_memoryBudget->setUsage(m_budgetHolder, m_imagePyramid.sizeInBytes() + transformedSize);
+}
+
 void ImageProcessor::setScaleFactor(const double value)
 {
     m_imageZoom.setScaleFactor(value);
@@ -114,6 +405,19 @@ double ImageProcessor::getScaleFactor() const
     return m_imageZoom.getScaleFactor();
 }
 
+double ImageProcessor::getImageScaleFactor() const
+{
+    if (m_originalImage.isNull())
+        return getScaleFactor();
+
+    return getScaleFactor() * m_originalSize.width() / m_originalImage.width();
+}
+
+QSize ImageProcessor::getOriginalSize() const
+{
+    return m_originalSize;
+}
+
 void ImageProcessor::setFitToArea(const bool fitToArea)
 {
     m_imageZoom.setFitToArea(fitToArea);
@@ -168,3 +472,14 @@ void ImageProcessor::setDrawBorder(const bool drawBorder)
 {
     m_imageBorder.setDrawBorder(drawBorder);
 }
+
+ImageProcessor::RenderMode ImageProcessor::getRenderMode() const
+{
+    return m_renderMode;
+}
+
+void ImageProcessor::setRenderMode(const RenderMode renderMode)
+{
+    m_renderMode = renderMode;
+    m_genericTransformations.front()->setIsCacheDirty(true);
+}
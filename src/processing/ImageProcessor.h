@@ -10,7 +10,16 @@ VookiImageViewer - a tool for showing images.
 ****************************************************************************/
 
 #include <QImage>
+#include <QThreadPool>
 #include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <qcorotask.h>
+#include <vector>
+#include "ImagePyramid.h"
+#include "MemoryBudget.h"
+#include "ImageTileSource.h"
 #include "transformation/ImageBorder.h"
 #include "transformation/ImageFlip.h"
 #include "transformation/ImageRotation.h"
@@ -22,10 +31,27 @@ VookiImageViewer - a tool for showing images.
 class ImageProcessor
 {
 public:
-    ImageProcessor() = default;
+    enum class RenderMode {
+        /// The whole image is transformed, the result is at least the area size.
+        Full,
+        /// Only the visible part of the image is transformed, the result is exactly the area size.
+        Viewport,
+        /// The whole image is transformed if it is not too large, so the scrolling is just a matter of painting.
+        Automatic
+    };
+
+    ImageProcessor();
+    ~ImageProcessor();
     DISABLE_COPY_MOVE(ImageProcessor);
 
-    void bind(const QImage &image, bool resetTransformation = true);
+    /// The originalSize is the size the image would have in the full resolution. If the bound image
+    /// is smaller (decoded in the reduced resolution), all transformations are still computed
+    /// against the full resolution, so the zoom level stays the same.
+    void bind(const QImage &image, bool resetTransformation = true, const QSize &originalSize = {});
+    /// Binds the next frame of the animation being shown. If no transformation has changed since the previous frame,
+    /// the cached one is applied to the frame directly and just the changedRect is painted into the reused image.
+    /// The null changedRect stands for the whole frame. Returns false if the frame was bound the common way, see bind().
+    bool bindFrame(const QImage &frame, const QRect &changedRect = {});
 
     void flipHorizontally();
     void flipVertically();
@@ -35,11 +61,35 @@ public:
 
     void resetTransformation() const;
 
+    /// Recomputes the transformed image if any transformation has changed.
+    void prepare();
     QImage process();
+    /// Paints the transformed image at the current scroll offsets, see ImageBorder::paint().
+    void paint(QPainter &painter, const QRect &dirtyRect);
+
+    /// If enabled, prepare() produces just a fast preview of the resampled image, which needs to be refined afterwards.
+    bool isProgressiveRenderingEnabled() const;
+    void setProgressiveRendering(bool progressiveRendering);
+    bool isRefinementPending() const;
+    /// Resamples the previewed image in the full quality on a worker thread. Returns false if there was nothing to refine,
+    /// or the refined image had been superseded by another transformation before it was done.
+    QCoro::Task<bool> refine();
+    /// Full resolution tiles are painted over the bound image wherever it would be upscaled. The source is not owned,
+    /// its size has to match the original size. The nullptr disables the tiled rendering.
+    void setTileSource(ImageTileSource *tileSource);
+    bool isTileDecodingPending() const;
+    /// Decodes the tiles the last paint() had to skip. Returns true if they are ready to be painted.
+    QCoro::Task<bool> decodeTiles();
     void setAreaSize(const QSize &size);
+    /// Reports the pyramid levels and the transformed image to the budget. The automatic render mode
+    /// renders just the viewport if the transformed image would not fit the budget.
+    void setMemoryBudget(MemoryBudget *budget);
 
     double getScaleFactor() const;
     void setScaleFactor(double value);
+    /// Scale factor relative to the bound image pixels.
+    double getImageScaleFactor() const;
+    QSize getOriginalSize() const;
 
     bool isFitToAreaEnabled() const;
     void setFitToArea(bool fitToArea);
@@ -55,8 +105,18 @@ public:
     void setBackgroundColor(const QColor &color);
     void setDrawBorder(bool drawBorder);
 
+    RenderMode getRenderMode() const;
+    void setRenderMode(RenderMode renderMode);
+
 protected:
     void flip();
+    [[nodiscard]] bool isViewportRendering(const QSize &transformedSize) const;
+    void paintTiles(QPainter &painter, const QRect &dirtyRect);
+    void renderFrame(const QImage &source, const QRect &changedRect);
+    void reportUsage() const;
+    /// Transforms the image with the separable resampling, if the transformation is not a generic one.
+    /// The preview uses the nearest neighbour instead, but the result has the same size.
+    [[nodiscard]] static QImage transformed(const QImage &image, const QTransform &transformation, bool isPreview = false);
 
 private:
     ImageRotation<QTransform> m_imageRotation {};
@@ -73,5 +133,45 @@ private:
     const std::array<ImageTransformation* const, m_genericTransformationsSize> m_genericTransformations { Array::concatenate<ImageTransformation* const>(m_transformations, m_imageTransformations) };
     static_assert(m_transformationsSize > 0, "m_transformations needs to have at least 1 element");
     static_assert(m_imageTransformationsSize > 0, "m_imageTransformations needs to have at least 1 element");
+    // Larger transformed images are rendered just in the viewport (256 MiB in the RGB32)
+    constexpr static qint64 m_maxFullRenderPixels {64 * 1024 * 1024};
     QImage m_originalImage {};
+    QSize m_originalSize {};
+    ImagePyramid m_imagePyramid {};
+    RenderMode m_renderMode {RenderMode::Full};
+
+    struct Refinement
+    {
+        QImage source {};
+        QTransform transformation {};
+        bool isStarted {false};
+    };
+
+    bool m_progressiveRendering {false};
+    std::optional<Refinement> m_refinement {};
+    // Incremented on every transformation, the refinement of an older one is dropped.
+    std::atomic<quint64> m_generation {0};
+    QThreadPool m_threadPool {};
+    // Expires with the processor, the refinement resumed after that does not touch it.
+    const std::shared_ptr<bool> m_alive {std::make_shared<bool>(true)};
+
+    ImageTileSource *m_tileSource {nullptr};
+    std::vector<ImageTileSource::Tile> m_missingTiles {};
+    // Maps the full resolution pixels to the image bound to the border
+    QTransform m_fullResolutionTransformation {};
+
+    struct FrameRendering
+    {
+        int level {0};
+        QTransform transformation {};
+        bool isViewport {false};
+    };
+
+    // Transformation computed by the last prepare(), the following animation frames reuse it
+    std::optional<FrameRendering> m_frameRendering {};
+    // Reused by the animation frames, holds the previous frame as long as the frame rendering is valid
+    QImage m_frameImage {};
+
+    MemoryBudget *m_memoryBudget {nullptr};
+    int m_budgetHolder {0};
 };
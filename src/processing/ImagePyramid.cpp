@@ -0,0 +1,101 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ImagePyramid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+void ImagePyramid::bind(const QImage &image)
+{
+    clear();
+    if (image.isNull())
+        return;
+
+    // shallow copy
+    m_levels.push_back(image);
+    for (int side = std::min(image.width(), image.height()); side > 1; side /= 2)
+        ++m_maxLevel;
+}
+
+void ImagePyramid::clear()
+{
+    m_levels.clear();
+    m_maxLevel = 0;
+}
+
+int ImagePyramid::levelForScaleFactor(const double scaleFactor) const
+{
+    if (scaleFactor <= 0 || scaleFactor >= 0.5)
+        return 0;
+
+    return std::min(static_cast<int>(std::floor(std::log2(1.0 / scaleFactor))), m_maxLevel);
+}
+
+const QImage &ImagePyramid::level(const int level)
+{
+    static const QImage nullImage {};
+    if (m_levels.empty() || level < 0 || level > m_maxLevel)
+        return nullImage;
+
+    // Every level is produced from the nearest larger one.
+    while (static_cast<int>(m_levels.size()) <= level)
+        m_levels.push_back(downsample(m_levels.back()));
+
+    return m_levels[level];
+}
+
+int ImagePyramid::maxLevel() const
+{
+    return m_maxLevel;
+}
+
+qsizetype ImagePyramid::sizeInBytes() const
+{
+    qsizetype size {0};
+    for (std::size_t level = 1; level < m_levels.size(); ++level)
+        size += m_levels[level].sizeInBytes();
+
+    return size;
+}
+
+QImage ImagePyramid::downsample(const QImage &image)
+{
+    // Averaging of the premultiplied pixels does not bleed colors of the transparent pixels.
+    const QImage source {image.hasAlphaChannel() ? image.convertToFormat(QImage::Format_ARGB32_Premultiplied) : image.convertToFormat(QImage::Format_RGB32)};
+    QImage result {std::max(1, source.width() / 2), std::max(1, source.height() / 2), source.format()};
+
+    const int maxX {source.width() - 1};
+    const int maxY {source.height() - 1};
+    for (int y = 0; y < result.height(); ++y)
+    {
+        const auto *const line0 {reinterpret_cast<const QRgb *>(source.constScanLine(std::min(2 * y, maxY)))};
+        const auto *const line1 {reinterpret_cast<const QRgb *>(source.constScanLine(std::min(2 * y + 1, maxY)))};
+        auto *const resultLine {reinterpret_cast<QRgb *>(result.scanLine(y))};
+
+        for (int x = 0; x < result.width(); ++x)
+        {
+            const int x0 {std::min(2 * x, maxX)};
+            const int x1 {std::min(2 * x + 1, maxX)};
+            const QRgb p00 {line0[x0]};
+            const QRgb p01 {line0[x1]};
+            const QRgb p10 {line1[x0]};
+            const QRgb p11 {line1[x1]};
+
+            // 2x2 box filter with rounding
+            resultLine[x] = qRgba((qRed(p00) + qRed(p01) + qRed(p10) + qRed(p11) + 2) / 4,
+                                  (qGreen(p00) + qGreen(p01) + qGreen(p10) + qGreen(p11) + 2) / 4,
+                                  (qBlue(p00) + qBlue(p01) + qBlue(p10) + qBlue(p11) + 2) / 4,
+                                  (qAlpha(p00) + qAlpha(p01) + qAlpha(p10) + qAlpha(p11) + 2) / 4);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <vector>
+#include "../util/compiler.h"
+
+/// Power-of-two downsample pyramid (mipmaps) of the bound image. The level 0 is the bound image itself,
+/// every other level has half the dimensions of the previous one. Levels are built lazily on demand.
+class ImagePyramid
+{
+public:
+    ImagePyramid() = default;
+    DISABLE_COPY_MOVE(ImagePyramid);
+
+    void bind(const QImage &image);
+    void clear();
+
+    /// Returns the smallest level which is still not smaller than the image scaled by the scaleFactor,
+    /// so the remaining scaling is always a downscale by a factor from the (0.5, 1] interval.
+    [[nodiscard]] int levelForScaleFactor(double scaleFactor) const;
+    [[nodiscard]] const QImage &level(int level);
+    [[nodiscard]] int maxLevel() const;
+    /// Bytes held by the levels built so far. The level 0 is not counted, it is not a copy of the bound image.
+    [[nodiscard]] qsizetype sizeInBytes() const;
+
+protected:
+    [[nodiscard]] static QImage downsample(const QImage &image);
+
+private:
+    std::vector<QImage> m_levels {};
+    int m_maxLevel {0};
+};
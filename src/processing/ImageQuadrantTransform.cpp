@@ -0,0 +1,192 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ImageQuadrantTransform.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define QUADRANT_TRANSFORM_SSE2
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define QUADRANT_TRANSFORM_NEON
+#endif
+
+namespace
+{
+    /// result[i] = source[count - 1 - i]
+    void copyReversed(const quint32 *const source, quint32 *const result, const int count)
+    {
+        int i = 0;
+#if defined(QUADRANT_TRANSFORM_SSE2)
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i pixels {_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + count - 4 - i))};
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(result + i), _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 1, 2, 3)));
+        }
+#elif defined(QUADRANT_TRANSFORM_NEON)
+        for (; i + 4 <= count; i += 4)
+        {
+            const uint32x4_t pixels {vrev64q_u32(vld1q_u32(source + count - 4 - i))};
+            vst1q_u32(result + i, vcombine_u32(vget_high_u32(pixels), vget_low_u32(pixels)));
+        }
+#endif
+        for (; i < count; ++i)
+            result[i] = source[count - 1 - i];
+    }
+
+    /// Transposes the 4x4 block of pixels, the k-th source column is stored to the result[k] row.
+    /// If reversed, the pixels of every result row are stored in the reversed order.
+    inline void transposeBlock(const quint32 *const source, const qsizetype sourceStride, quint32 *const result[4], const bool reversed)
+    {
+#if defined(QUADRANT_TRANSFORM_SSE2)
+        const __m128i row0 {_mm_loadu_si128(reinterpret_cast<const __m128i *>(source))};
+        const __m128i row1 {_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + sourceStride))};
+        const __m128i row2 {_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 2 * sourceStride))};
+        const __m128i row3 {_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 3 * sourceStride))};
+
+        const __m128i low01 {_mm_unpacklo_epi32(row0, row1)};
+        const __m128i low23 {_mm_unpacklo_epi32(row2, row3)};
+        const __m128i high01 {_mm_unpackhi_epi32(row0, row1)};
+        const __m128i high23 {_mm_unpackhi_epi32(row2, row3)};
+
+        __m128i columns[4] {_mm_unpacklo_epi64(low01, low23),
+                            _mm_unpackhi_epi64(low01, low23),
+                            _mm_unpacklo_epi64(high01, high23),
+                            _mm_unpackhi_epi64(high01, high23)};
+
+        for (int k = 0; k < 4; ++k)
+        {
+            if (reversed)
+                columns[k] = _mm_shuffle_epi32(columns[k], _MM_SHUFFLE(0, 1, 2, 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(result[k]), columns[k]);
+        }
+#elif defined(QUADRANT_TRANSFORM_NEON)
+        const uint32x4x2_t rows01 {vtrnq_u32(vld1q_u32(source), vld1q_u32(source + sourceStride))};
+        const uint32x4x2_t rows23 {vtrnq_u32(vld1q_u32(source + 2 * sourceStride), vld1q_u32(source + 3 * sourceStride))};
+
+        uint32x4_t columns[4] {vcombine_u32(vget_low_u32(rows01.val[0]), vget_low_u32(rows23.val[0])),
+                               vcombine_u32(vget_low_u32(rows01.val[1]), vget_low_u32(rows23.val[1])),
+                               vcombine_u32(vget_high_u32(rows01.val[0]), vget_high_u32(rows23.val[0])),
+                               vcombine_u32(vget_high_u32(rows01.val[1]), vget_high_u32(rows23.val[1]))};
+
+        for (int k = 0; k < 4; ++k)
+        {
+            if (reversed)
+            {
+                const uint32x4_t column {vrev64q_u32(columns[k])};
+                columns[k] = vcombine_u32(vget_high_u32(column), vget_low_u32(column));
+            }
+            vst1q_u32(result[k], columns[k]);
+        }
+#else
+        for (int k = 0; k < 4; ++k)
+            for (int j = 0; j < 4; ++j)
+                result[k][reversed ? 3 - j : j] = source[j * sourceStride + k];
+#endif
+    }
+}
+
+bool ImageQuadrantTransform::isQuadrant(const QTransform &transformation)
+{
+    if (!transformation.isAffine())
+        return false;
+
+    const auto isUnit = [](const qreal value) { return value == 1.0 || value == -1.0; };
+    const auto isZero = [](const qreal value) { return value == 0.0; };
+
+    return (isUnit(transformation.m11()) && isZero(transformation.m12()) && isZero(transformation.m21()) && isUnit(transformation.m22())) ||
+           (isZero(transformation.m11()) && isUnit(transformation.m12()) && isUnit(transformation.m21()) && isZero(transformation.m22()));
+}
+
+QImage ImageQuadrantTransform::transformed(const QImage &image, const QTransform &transformation)
+{
+    if (image.isNull())
+        return image;
+
+    // Pixels are just moved, so any 32 bits per pixel format is kept as it is.
+    const QImage source {image.depth() == 32 ? image : image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32)};
+
+    // x' = m11 * x + m21 * y, y' = m12 * x + m22 * y
+    const bool isTransposed {transformation.m11() == 0.0};
+    QImage result {isTransposed ? source.size().transposed() : source.size(), source.format()};
+    result.setColorSpace(source.colorSpace());
+    result.setDotsPerMeterX(isTransposed ? source.dotsPerMeterY() : source.dotsPerMeterX());
+    result.setDotsPerMeterY(isTransposed ? source.dotsPerMeterX() : source.dotsPerMeterY());
+
+    if (isTransposed)
+        transposePixels(source, result, transformation.m21() < 0, transformation.m12() < 0);
+    else
+        copyPixels(source, result, transformation.m11() < 0, transformation.m22() < 0);
+
+    return result;
+}
+
+void ImageQuadrantTransform::copyPixels(const QImage &source, QImage &result, const bool mirrorX, const bool mirrorY)
+{
+    const int width {source.width()};
+    const int height {source.height()};
+
+    for (int y = 0; y < height; ++y)
+    {
+        const auto *const sourceLine {reinterpret_cast<const quint32 *>(source.constScanLine(y))};
+        auto *const resultLine {reinterpret_cast<quint32 *>(result.scanLine(mirrorY ? height - 1 - y : y))};
+
+        if (mirrorX)
+            copyReversed(sourceLine, resultLine, width);
+        else
+            std::copy_n(sourceLine, width, resultLine);
+    }
+}
+
+void ImageQuadrantTransform::transposePixels(const QImage &source, QImage &result, const bool mirrorX, const bool mirrorY)
+{
+    const int width {source.width()};
+    const int height {source.height()};
+    const auto *const sourceBits {reinterpret_cast<const quint32 *>(source.constBits())};
+    const qsizetype sourceStride {source.bytesPerLine() / 4};
+    auto *const resultBits {reinterpret_cast<quint32 *>(result.bits())};
+    const qsizetype resultStride {result.bytesPerLine() / 4};
+
+    // The source column x becomes the result row, the source row y becomes the result column.
+    const auto resultLine = [=](const int x) { return resultBits + (mirrorY ? width - 1 - x : x) * resultStride; };
+    const auto resultColumn = [=](const int y) { return mirrorX ? height - 1 - y : y; };
+
+    for (int tileY = 0; tileY < height; tileY += m_tileSize)
+    {
+        const int endY {std::min(tileY + m_tileSize, height)};
+        for (int tileX = 0; tileX < width; tileX += m_tileSize)
+        {
+            const int endX {std::min(tileX + m_tileSize, width)};
+
+            int y = tileY;
+            for (; y + 4 <= endY; y += 4)
+            {
+                // Reversed blocks start at the column of their last pixel.
+                const int column {mirrorX ? height - 4 - y : y};
+
+                int x = tileX;
+                for (; x + 4 <= endX; x += 4)
+                {
+                    quint32 *const resultRows[4] {resultLine(x) + column, resultLine(x + 1) + column, resultLine(x + 2) + column, resultLine(x + 3) + column};
+                    transposeBlock(sourceBits + y * sourceStride + x, sourceStride, resultRows, mirrorX);
+                }
+
+                for (; x < endX; ++x)
+                    for (int j = y; j < y + 4; ++j)
+                        resultLine(x)[resultColumn(j)] = sourceBits[j * sourceStride + x];
+            }
+
+            for (; y < endY; ++y)
+                for (int x = tileX; x < endX; ++x)
+                    resultLine(x)[resultColumn(y)] = sourceBits[y * sourceStride + x];
+        }
+    }
+}
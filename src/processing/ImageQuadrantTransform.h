@@ -0,0 +1,36 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QTransform>
+
+/// Lossless transformation of the image by multiples of 90 degrees and flips. The pixels are just moved,
+/// so the result is exact and much cheaper than the generic resampling done by QImage::transformed().
+class ImageQuadrantTransform
+{
+public:
+    ImageQuadrantTransform() = delete;
+
+    /// Returns true if the transformation maps the pixel grid onto itself (rotation by a multiple of 90 degrees
+    /// and flips without any scaling), the translation is not taken into account.
+    [[nodiscard]] static bool isQuadrant(const QTransform &transformation);
+    /// The result is the same as of the QImage::transformed() with the quadrant transformation.
+    [[nodiscard]] static QImage transformed(const QImage &image, const QTransform &transformation);
+
+protected:
+    /// Copies the rows, the result's X and Y axes are optionally mirrored.
+    static void copyPixels(const QImage &source, QImage &result, bool mirrorX, bool mirrorY);
+    /// Transposes the pixels in cache-friendly tiles, the result's X and Y axes are optionally mirrored.
+    static void transposePixels(const QImage &source, QImage &result, bool mirrorX, bool mirrorY);
+
+    // Tiles of 64x64 pixels, so both the source and result tile rows stay in the L1 cache.
+    static constexpr int m_tileSize {64};
+};
@@ -0,0 +1,195 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ImageTileSource.h"
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <qcorofuture.h>
+
+ImageTileSource::ImageTileSource(const qsizetype cacheSize)
+                                        : m_cache(cacheSize)
+{
+    // Leave some cores for the GUI thread, tiles are small enough to be decoded in parallel.
+    m_threadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+ImageTileSource::~ImageTileSource()
+{
+    close();
+    m_threadPool.waitForDone();
+}
+
+bool ImageTileSource::isSupported(QImageReader &reader)
+{
+    // Plugins without the clip rectangle support would decode the whole image for every single tile.
+    return reader.canRead() && reader.supportsOption(QImageIOHandler::ClipRect) && reader.supportsOption(QImageIOHandler::ScaledSize)
+           && reader.size().isValid() && reader.transformation() == QImageIOHandler::TransformationNone;
+}
+
+bool ImageTileSource::open(const QString &fileName)
+{
+    close();
+
+    QImageReader reader {fileName};
+    reader.setAutoTransform(true);
+    if (!isSupported(reader))
+        return false;
+
+    m_fileName = fileName;
+    m_size = reader.size();
+    return true;
+}
+
+void ImageTileSource::close()
+{
+    ++m_generation;
+    m_fileName.clear();
+    m_size = {};
+    m_scheduled.clear();
+    m_failed.clear();
+    m_cache.clear();
+}
+
+bool ImageTileSource::isOpen() const
+{
+    return !m_fileName.isEmpty();
+}
+
+QString ImageTileSource::getFileName() const
+{
+    return m_fileName;
+}
+
+QSize ImageTileSource::getSize() const
+{
+    return m_size;
+}
+
+int ImageTileSource::levelForScaleFactor(const double scaleFactor) const
+{
+    if (scaleFactor <= 0.0 || scaleFactor >= 1.0)
+        return 0;
+
+    // The same rule as the ImagePyramid uses, the remaining scaling is a downscale from the (0.5, 1] interval.
+    const int level {static_cast<int>(std::floor(std::log2(1.0 / scaleFactor) + 1e-9))};
+    return std::clamp(level, 0, m_maxLevel);
+}
+
+QRect ImageTileSource::tileRect(const Tile &tile) const
+{
+    const int span {m_tileSize << tile.level};
+    return QRect {tile.index.x() * span, tile.index.y() * span, span, span} & QRect {QPoint {}, m_size};
+}
+
+std::vector<ImageTileSource::Tile> ImageTileSource::tiles(const int level, const QRect &rect) const
+{
+    const QRect area {rect & QRect {QPoint {}, m_size}};
+    if (area.isEmpty())
+        return {};
+
+    const int span {m_tileSize << level};
+    std::vector<Tile> result;
+    for (int y = area.top() / span; y <= area.bottom() / span; ++y)
+        for (int x = area.left() / span; x <= area.right() / span; ++x)
+            result.push_back({level, {x, y}});
+
+    return result;
+}
+
+QImage ImageTileSource::tile(const Tile &tile) const
+{
+    return isOpen() ? m_cache.find(key(tile)) : QImage {};
+}
+
+QCoro::Task<bool> ImageTileSource::decode(const std::vector<Tile> &tiles)
+{
+    struct Job
+    {
+        QString key;
+        QRect clipRect;
+        QSize scaledSize;
+    };
+
+    std::vector<Job> jobs;
+    for (const Tile &tile : tiles)
+    {
+        QString tileKey {key(tile)};
+        const QRect rect {tileRect(tile)};
+        if (rect.isEmpty() || m_failed.contains(tileKey) || m_cache.contains(tileKey) || !m_scheduled.insert(tileKey).second)
+            continue;
+
+        const int divisor {1 << tile.level};
+        jobs.push_back({std::move(tileKey), rect, {(rect.width() + divisor - 1) / divisor, (rect.height() + divisor - 1) / divisor}});
+    }
+
+    if (jobs.empty())
+        co_return false;
+
+    const quint64 generation {m_generation};
+    const QString fileName {m_fileName};
+    const std::weak_ptr<bool> alive {m_alive};
+    // The jobs live in the coroutine frame, so they outlive the mapping.
+    co_await QtConcurrent::map(&m_threadPool, jobs, [this, generation, fileName](const Job &job) {
+        // The image has been closed meanwhile, nobody is interested in its tiles anymore.
+        if (generation != m_generation)
+            return;
+
+        if (const QImage image {decodeTile(fileName, job.clipRect, job.scaledSize)}; !image.isNull() && generation == m_generation)
+            m_cache.insert(job.key, image);
+    });
+
+    // Waiting for the thread pool in the destructor does not stop the resume queued already.
+    if (alive.expired() || generation != m_generation)
+        co_return false;
+
+    bool isAnyCached {false};
+    for (const Job &job : jobs)
+    {
+        m_scheduled.erase(job.key);
+        if (m_cache.contains(job.key))
+            isAnyCached = true;
+        else
+            m_failed.insert(job.key);
+    }
+
+    co_return isAnyCached;
+}
+
+void ImageTileSource::setMemoryBudget(MemoryBudget *budget)
+{
+    m_cache.setMemoryBudget(budget);
+}
+
+QString ImageTileSource::key(const Tile &tile) const
+{
+    // The generation keeps the tiles of different images apart, even if a stale one slips into the cache.
+    return QStringLiteral("%1/%2/%3/%4").arg(m_generation.load()).arg(tile.level).arg(tile.index.x()).arg(tile.index.y());
+}
+
+QImage ImageTileSource::decodeTile(const QString &fileName, const QRect &clipRect, const QSize &scaledSize)
+{
+    QImageReader reader {fileName};
+    reader.setQuality(100);
+    reader.setAutoTransform(false);
+    reader.setClipRect(clipRect);
+    reader.setScaledSize(scaledSize);
+
+    QImage image;
+    if (!reader.read(&image))
+    {
+        qDebug() << "Tile decoding failed:" << fileName << clipRect << reader.errorString();
+        return {};
+    }
+
+    return image;
+}
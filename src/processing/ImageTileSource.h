@@ -0,0 +1,89 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QImageReader>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include <qcorotask.h>
+#include "ImageCache.h"
+#include "../util/compiler.h"
+
+/// Decodes just the rectangular tiles of a large image which are really needed, with the help of the QImageReader
+/// clip rectangle. Memory is given by the tile cache size, not by the image size, so gigapixel images could be shown.
+/// Every level halves the resolution of the previous one, the level 0 is the full resolution.
+class ImageTileSource
+{
+public:
+    struct Tile
+    {
+        int level {0};
+        QPoint index {};
+    };
+
+    explicit ImageTileSource(qsizetype cacheSize = m_defaultCacheSize);
+    ~ImageTileSource();
+    DISABLE_COPY_MOVE(ImageTileSource);
+
+    /// The image plugin has to decode the clipped and scaled rectangles directly. Images with the orientation set
+    /// are not supported, tiles are in the stored orientation.
+    [[nodiscard]] static bool isSupported(QImageReader &reader);
+    /// Succeeds only if the image is supported, see isSupported().
+    bool open(const QString &fileName);
+    void close();
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] QString getFileName() const;
+    [[nodiscard]] QSize getSize() const;
+
+    [[nodiscard]] int levelForScaleFactor(double scaleFactor) const;
+    /// Full resolution rectangle covered by the tile, it is cropped at the image edges.
+    [[nodiscard]] QRect tileRect(const Tile &tile) const;
+    /// Tiles of the level which intersect the given full resolution rectangle.
+    [[nodiscard]] std::vector<Tile> tiles(int level, const QRect &rect) const;
+    /// Returns the decoded tile or the null image if the tile has not been decoded yet.
+    [[nodiscard]] QImage tile(const Tile &tile) const;
+    /// Decodes the given tiles on the worker threads. Returns false if no new tile is in the cache afterwards,
+    /// or another image had been opened before the tiles were done. Tiles which failed are not decoded again.
+    QCoro::Task<bool> decode(const std::vector<Tile> &tiles);
+    /// See ImageCache::setMemoryBudget()
+    void setMemoryBudget(MemoryBudget *budget);
+
+    static constexpr int m_tileSize {512};
+    static constexpr int m_maxLevel {3};
+    static constexpr qsizetype m_defaultCacheSize {256 * 1024 * 1024};
+
+protected:
+    [[nodiscard]] QString key(const Tile &tile) const;
+    [[nodiscard]] static QImage decodeTile(const QString &fileName, const QRect &clipRect, const QSize &scaledSize);
+
+private:
+    QString m_fileName {};
+    QSize m_size {};
+    // The lookup marks the tile as the most recently used one.
+    mutable ImageCache m_cache;
+    // Tiles being decoded, so they are not requested twice. Touched by the GUI thread only.
+    std::unordered_set<QString> m_scheduled {};
+    // Tiles which could not be decoded, or were evicted by the budget right away, until the image is closed.
+    // Requesting them again would just repaint and decode over and over. Touched by the GUI thread only.
+    std::unordered_set<QString> m_failed {};
+    // Incremented on every open, tiles of the previous image are dropped.
+    std::atomic<quint64> m_generation {0};
+    QThreadPool m_threadPool {};
+    // Expires with the source, the decoding resumed after that does not touch it.
+    const std::shared_ptr<bool> m_alive {std::make_shared<bool>(true)};
+};
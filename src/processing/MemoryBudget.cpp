@@ -0,0 +1,178 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "MemoryBudget.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined (_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+MemoryBudget::MemoryBudget(const qsizetype budget)
+                                        : m_budget(budget)
+{
+}
+
+qsizetype MemoryBudget::getBudget() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+void MemoryBudget::setBudget(const qsizetype budget)
+{
+    const QMutexLocker locker(&m_mutex);
+    m_budget = budget;
+    enforce();
+}
+
+int MemoryBudget::registerHolder(const Category category, Evictor evictor)
+{
+    const QMutexLocker locker(&m_mutex);
+    const int holder {m_nextHolder++};
+    m_holders.emplace(holder, Holder {category, std::move(evictor)});
+    return holder;
+}
+
+void MemoryBudget::unregisterHolder(const int holder)
+{
+    const QMutexLocker locker(&m_mutex);
+    m_holders.erase(holder);
+}
+
+void MemoryBudget::setUsage(const int holder, const qsizetype size)
+{
+    const QMutexLocker locker(&m_mutex);
+    if (const auto it = m_holders.find(holder); it != m_holders.end())
+    {
+        it->second.size = size;
+        enforce();
+    }
+}
+
+qsizetype MemoryBudget::usage() const
+{
+    const QMutexLocker locker(&m_mutex);
+    qsizetype total {0};
+    for (const auto &[id, holder] : m_holders)
+        total += holder.size;
+
+    return total;
+}
+
+qsizetype MemoryBudget::usage(const Category category) const
+{
+    const QMutexLocker locker(&m_mutex);
+    qsizetype total {0};
+    for (const auto &[id, holder] : m_holders)
+    {
+        if (holder.category == category)
+            total += holder.size;
+    }
+
+    return total;
+}
+
+qsizetype MemoryBudget::available() const
+{
+    const QMutexLocker locker(&m_mutex);
+    qsizetype held {0};
+    for (const auto &[id, holder] : m_holders)
+    {
+        // The image being shown is replaced by the new one.
+        if (!holder.evictor && holder.category != Category::OriginalImage && holder.category != Category::ProcessedImage)
+            held += holder.size;
+    }
+
+    return std::max<qsizetype>(0, m_budget - held);
+}
+
+MemoryBudget::DecodeStrategy MemoryBudget::decodeStrategy(const QSize &size, const bool isScalable, const bool isTileable) const
+{
+    const qint64 pixels {static_cast<qint64>(size.width()) * size.height()};
+    if (size.isEmpty() || pixels * m_bytesPerPixel * m_copiesPerImage <= available())
+        return DecodeStrategy::Full;
+
+    if (isTileable)
+        return DecodeStrategy::Tiled;
+
+    // Plugins which cannot decode the reduced resolution are given a try at least, the allocation limit stops them.
+    return isScalable ? DecodeStrategy::Scaled : DecodeStrategy::Full;
+}
+
+QSize MemoryBudget::scaledSize(const QSize &size) const
+{
+    const qint64 pixels {static_cast<qint64>(size.width()) * size.height()};
+    const qint64 maxPixels {available() / (m_bytesPerPixel * m_copiesPerImage)};
+    if (size.isEmpty() || pixels <= maxPixels)
+        return size;
+
+    const double factor {std::sqrt(static_cast<double>(maxPixels) / static_cast<double>(pixels))};
+    return {std::max(1, static_cast<int>(size.width() * factor)), std::max(1, static_cast<int>(size.height() * factor))};
+}
+
+int MemoryBudget::allocationLimit(const qsizetype budget)
+{
+    const qsizetype megabytes {budget / (1024 * 1024)};
+    return static_cast<int>(std::clamp<qsizetype>(megabytes, 1, std::numeric_limits<int>::max()));
+}
+
+qsizetype MemoryBudget::defaultBudget()
+{
+    return std::max(m_minBudget, physicalMemory() / 4);
+}
+
+qsizetype MemoryBudget::physicalMemory()
+{
+    unsigned long long size {0};
+#if defined (_WIN32)
+    MEMORYSTATUSEX status {};
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status))
+        size = status.ullTotalPhys;
+#elif defined (_SC_PHYS_PAGES) && defined (_SC_PAGESIZE)
+    const long pages {sysconf(_SC_PHYS_PAGES)};
+    const long pageSize {sysconf(_SC_PAGESIZE)};
+    if (pages > 0 && pageSize > 0)
+        size = static_cast<unsigned long long>(pages) * static_cast<unsigned long long>(pageSize);
+#endif
+
+    return static_cast<qsizetype>(std::min<unsigned long long>(size, std::numeric_limits<qsizetype>::max()));
+}
+
+void MemoryBudget::enforce()
+{
+    // Expects the m_mutex is already locked by the caller.
+    qsizetype excess {-m_budget};
+    for (const auto &[id, holder] : m_holders)
+        excess += holder.size;
+
+    for (auto &[id, holder] : m_holders)
+    {
+        if (excess <= 0)
+            break;
+
+        if (!holder.evictor || holder.size == 0)
+            continue;
+
+        const qsizetype size {holder.evictor(std::max<qsizetype>(0, holder.size - excess))};
+        excess -= holder.size - size;
+        holder.size = size;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QMutex>
+#include <QSize>
+#include <functional>
+#include <map>
+#include "../util/compiler.h"
+
+/// Accounts the memory held by the decoded and processed images. Holders register under a category and report
+/// their usage, the evictable ones (caches) are asked to shrink whenever the total would exceed the budget.
+/// All methods are thread-safe. The evictors are called from within the reports, so holders must not report
+/// their usage while holding their own locks, and the evictors must not call the budget back.
+class MemoryBudget
+{
+public:
+    enum class Category {
+        OriginalImage,
+        ProcessedImage,
+        Cache,
+        AnimationFrames
+    };
+
+    enum class DecodeStrategy {
+        /// The whole image in the full resolution
+        Full,
+        /// The whole image in a resolution reduced to fit the budget
+        Scaled,
+        /// The reduced overview, details are decoded tile by tile
+        Tiled
+    };
+
+    /// Shrinks the holder to at most the given amount of bytes and returns the amount it holds afterwards.
+    using Evictor = std::function<qsizetype(qsizetype maxSize)>;
+
+    explicit MemoryBudget(qsizetype budget = defaultBudget());
+    DISABLE_COPY_MOVE(MemoryBudget);
+
+    [[nodiscard]] qsizetype getBudget() const;
+    /// Evicts the caches if the new budget is already exceeded.
+    void setBudget(qsizetype budget);
+
+    [[nodiscard]] int registerHolder(Category category, Evictor evictor = {});
+    void unregisterHolder(int holder);
+    void setUsage(int holder, qsizetype size);
+
+    [[nodiscard]] qsizetype usage() const;
+    [[nodiscard]] qsizetype usage(Category category) const;
+    /// Budget left for a new image, caches do not count since they would be evicted for it.
+    [[nodiscard]] qsizetype available() const;
+
+    /// Chooses how to decode the image of the given full resolution size, so it fits the available budget.
+    [[nodiscard]] DecodeStrategy decodeStrategy(const QSize &size, bool isScalable, bool isTileable) const;
+    /// The largest size with the aspect ratio of the given one, which still fits the available budget.
+    [[nodiscard]] QSize scaledSize(const QSize &size) const;
+
+    /// Allocation limit for the QImageReader in megabytes, a single image cannot exceed the whole budget.
+    [[nodiscard]] static int allocationLimit(qsizetype budget);
+    /// A quarter of the physical memory, but at least the minimum one.
+    [[nodiscard]] static qsizetype defaultBudget();
+    /// Physical memory size, or 0 if it is not known.
+    [[nodiscard]] static qsizetype physicalMemory();
+
+    static constexpr qsizetype m_minBudget {512 * 1024 * 1024};
+    // The decoded image is kept along with its transformed copy
+    static constexpr int m_copiesPerImage {2};
+    static constexpr int m_bytesPerPixel {4};
+
+protected:
+    void enforce();
+
+private:
+    struct Holder
+    {
+        Category category {Category::Cache};
+        Evictor evictor {};
+        qsizetype size {0};
+    };
+
+    // Held while the evictors are called, so the holders cannot unregister meanwhile.
+    mutable QMutex m_mutex {};
+    std::map<int, Holder> m_holders {};
+    int m_nextHolder {0};
+    qsizetype m_budget;
+};
@@ -0,0 +1,276 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "MetadataCache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include "../util/PrivateFile.h"
+
+namespace
+{
+    constexpr quint32 magic {0x564D4554}; // "VMET"
+    constexpr quint32 version {2};
+
+    void writePairs(QDataStream &stream, const MetadataCache::Pairs &pairs)
+    {
+        stream << static_cast<quint32>(pairs.size());
+        for (const auto &[name, value] : pairs)
+            stream << name << value;
+    }
+
+    bool readPairs(QDataStream &stream, MetadataCache::Pairs &pairs)
+    {
+        quint32 count {0};
+        stream >> count;
+        // Guards against the allocation driven by a corrupted file
+        if (stream.status() != QDataStream::Ok || count > 0xFFFF)
+            return false;
+
+        pairs.reserve(count);
+        for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+        {
+            QString name;
+            QString value;
+            stream >> name >> value;
+            pairs.emplace_back(std::move(name), std::move(value));
+        }
+
+        return stream.status() == QDataStream::Ok;
+    }
+}
+
+MetadataCache::Key MetadataCache::Key::fromFile(const QFileInfo &fileInfo)
+{
+    return {fileInfo.absoluteFilePath(), fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch()};
+}
+
+MetadataCache::MetadataCache(const qsizetype maxCount)
+                                        : m_maxCount(maxCount)
+{
+}
+
+QString MetadataCache::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/metadata");
+}
+
+void MetadataCache::setDirectory(const QString &directory)
+{
+    const QMutexLocker locker(&m_mutex);
+    m_directory = directory.isEmpty() ? QString {} : QDir::cleanPath(directory);
+}
+
+void MetadataCache::setLanguage(const QString &language)
+{
+    const QMutexLocker locker(&m_mutex);
+    if (m_language == language)
+        return;
+
+    m_language = language;
+    m_index.clear();
+    m_entries.clear();
+}
+
+QString MetadataCache::storePath(const QString &fileName) const
+{
+    const QMutexLocker locker(&m_mutex);
+    if (m_directory.isEmpty())
+        return {};
+
+    const QByteArray hash {QCryptographicHash::hash((m_language + QLatin1Char('\n') + fileName).toUtf8(), QCryptographicHash::Md5).toHex()};
+    return QStringLiteral("%1/%2.meta").arg(m_directory, QString::fromLatin1(hash));
+}
+
+std::optional<MetadataCache::Metadata> MetadataCache::find(const Key &key)
+{
+    const QMutexLocker locker(&m_mutex);
+    const auto it = m_index.find(key.fileName);
+    if (it == m_index.end())
+        return std::nullopt;
+
+    // The file has been modified since then
+    if (it->second->first != key)
+    {
+        m_entries.erase(it->second);
+        m_index.erase(it);
+        return std::nullopt;
+    }
+
+    // Mark as the most recently used
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->second;
+}
+
+std::optional<MetadataCache::Metadata> MetadataCache::findStored(const Key &key)
+{
+    const QString path {storePath(key.fileName)};
+    if (path.isEmpty())
+        return std::nullopt;
+
+    std::optional<Metadata> metadata {load(path, key)};
+    if (metadata)
+        insertIntoMemory(key, *metadata);
+
+    return metadata;
+}
+
+void MetadataCache::insert(const Key &key, const Metadata &metadata)
+{
+    if (key.fileName.isEmpty())
+        return;
+
+    insertIntoMemory(key, metadata);
+
+    // Written without the m_mutex locked, the other threads keep reading the memory meanwhile.
+    const QString path {storePath(key.fileName)};
+    if (path.isEmpty() || !store(path, key, metadata))
+        return;
+
+    bool isPruneDue {false};
+    {
+        const QMutexLocker locker(&m_mutex);
+        if (++m_storedSincePrune >= m_pruneInterval)
+        {
+            m_storedSincePrune = 0;
+            isPruneDue = true;
+        }
+    }
+
+    if (isPruneDue)
+        prune();
+}
+
+void MetadataCache::setMaxStoredCount(const qsizetype maxStoredCount)
+{
+    const QMutexLocker locker(&m_mutex);
+    m_maxStoredCount = maxStoredCount;
+}
+
+void MetadataCache::prune() const
+{
+    QString directory;
+    qsizetype maxStoredCount {0};
+    {
+        const QMutexLocker locker(&m_mutex);
+        directory = m_directory;
+        maxStoredCount = m_maxStoredCount;
+    }
+
+    if (directory.isEmpty())
+        return;
+
+    // The most recently used entries go first, their loading refreshes the modification time.
+    const QFileInfoList entries {QDir(directory).entryInfoList({QStringLiteral("*.meta")}, QDir::Files, QDir::Time)};
+    const QDateTime oldest {QDateTime::currentDateTimeUtc().addDays(-m_maxStoredAge)};
+    for (qsizetype i = 0; i < entries.size(); ++i)
+    {
+        if (i >= maxStoredCount || entries.at(i).lastModified() < oldest)
+            QFile::remove(entries.at(i).absoluteFilePath());
+    }
+}
+
+void MetadataCache::clear()
+{
+    const QMutexLocker locker(&m_mutex);
+    m_index.clear();
+    m_entries.clear();
+}
+
+qsizetype MetadataCache::count() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return static_cast<qsizetype>(m_entries.size());
+}
+
+qsizetype MetadataCache::maxCount() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_maxCount;
+}
+
+void MetadataCache::insertIntoMemory(const Key &key, const Metadata &metadata)
+{
+    const QMutexLocker locker(&m_mutex);
+    if (const auto it = m_index.find(key.fileName); it != m_index.end())
+    {
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+
+    if (m_maxCount <= 0)
+        return;
+
+    while (static_cast<qsizetype>(m_entries.size()) >= m_maxCount)
+    {
+        m_index.erase(m_entries.back().first.fileName);
+        m_entries.pop_back();
+    }
+
+    m_entries.emplace_front(key, metadata);
+    m_index.emplace(key.fileName, m_entries.begin());
+}
+
+bool MetadataCache::store(const QString &path, const Key &key, const Metadata &metadata) const
+{
+    // The metadata may contain private information, e.g. the GPS position. Several viewers might share the store,
+    // so the file is written to a temporary file and renamed.
+    QSaveFile file {path};
+    if (!Util::openPrivateFile(file))
+        return false;
+
+    QDataStream stream {&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << magic << version << key.fileName << key.size << key.modificationTime;
+    writePairs(stream, metadata.information);
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+    {
+        qDebug() << "Metadata storing failed:" << path << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<MetadataCache::Metadata> MetadataCache::load(const QString &path, const Key &key)
+{
+    QFile file {path};
+    if (!file.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    QDataStream stream {&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 storedMagic {0};
+    quint32 storedVersion {0};
+    Key storedKey;
+    stream >> storedMagic >> storedVersion;
+    if (storedMagic != magic || storedVersion != version)
+        return std::nullopt;
+
+    // The hash collisions and the modified files alike
+    stream >> storedKey.fileName >> storedKey.size >> storedKey.modificationTime;
+    if (stream.status() != QDataStream::Ok || storedKey != key)
+        return std::nullopt;
+
+    Metadata metadata;
+    if (!readPairs(stream, metadata.information))
+        return std::nullopt;
+
+    // Used recently, so it is the last one to be pruned. Set through the open file, the owner may do so even read-only.
+    file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return metadata;
+}
@@ -0,0 +1,99 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QFileInfo>
+#include <QMutex>
+#include <QString>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../util/compiler.h"
+
+/// Count-bounded LRU cache of the parsed image metadata, so the revisited images are not read and parsed again.
+/// Entries are valid as long as the file size and modification time stay the same. They are optionally kept
+/// in the persistent store too, a file per image named by the MD5 of its path and the language. The store is
+/// bounded by the number of files and their age, the least recently used ones are pruned.
+/// All methods are thread-safe.
+class MetadataCache
+{
+public:
+    /// Identity of the file content, as far as the file system tells it without reading the file.
+    struct Key
+    {
+        QString fileName {};
+        qint64 size {0};
+        qint64 modificationTime {0};
+
+        [[nodiscard]] static Key fromFile(const QFileInfo &fileInfo);
+        bool operator==(const Key &other) const = default;
+    };
+
+    using Pairs = std::vector<std::pair<QString, QString>>;
+
+    struct Metadata
+    {
+        /// Translated names and the formatted values, as shown to the user
+        Pairs information {};
+    };
+
+    explicit MetadataCache(qsizetype maxCount = m_defaultMaxCount);
+    DISABLE_COPY_MOVE(MetadataCache);
+
+    /// The metadata directory in the application cache location.
+    [[nodiscard]] static QString defaultDirectory();
+    /// The entries are stored there too, empty keeps them just in the memory.
+    void setDirectory(const QString &directory);
+    /// The information is translated, so the entries stored for other languages are not used.
+    /// The memory is cleared once the language changes.
+    void setLanguage(const QString &language);
+    [[nodiscard]] QString storePath(const QString &fileName) const;
+    void setMaxStoredCount(qsizetype maxStoredCount);
+    /// Removes the stored entries over the count, and the ones not used for longer than m_maxStoredAge.
+    /// Called every m_pruneInterval stores, it lists the whole store.
+    void prune() const;
+
+    /// Looks into the memory only, so it is cheap enough for the GUI thread.
+    [[nodiscard]] std::optional<Metadata> find(const Key &key);
+    /// Looks into the persistent store, the entry found is kept in the memory then. Reads a file, so it belongs
+    /// to a worker thread.
+    [[nodiscard]] std::optional<Metadata> findStored(const Key &key);
+    /// Stores the entry into the persistent store too, so it belongs to a worker thread if there is one.
+    void insert(const Key &key, const Metadata &metadata);
+    void clear();
+
+    [[nodiscard]] qsizetype count() const;
+    [[nodiscard]] qsizetype maxCount() const;
+
+    static constexpr qsizetype m_defaultMaxCount {256};
+    static constexpr qsizetype m_defaultMaxStoredCount {4096};
+    static constexpr int m_maxStoredAge {90}; // days
+    static constexpr int m_pruneInterval {64};
+
+protected:
+    void insertIntoMemory(const Key &key, const Metadata &metadata);
+    bool store(const QString &path, const Key &key, const Metadata &metadata) const;
+    [[nodiscard]] static std::optional<Metadata> load(const QString &path, const Key &key);
+
+private:
+    using Entry = std::pair<Key, Metadata>;
+
+    mutable QMutex m_mutex {};
+    // The most recently used entry is at the front.
+    std::list<Entry> m_entries {};
+    std::unordered_map<QString, std::list<Entry>::iterator> m_index {};
+    qsizetype m_maxCount;
+    QString m_directory {};
+    QString m_language {};
+    qsizetype m_maxStoredCount {m_defaultMaxStoredCount};
+    int m_storedSincePrune {0};
+};
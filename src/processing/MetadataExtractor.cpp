@@ -11,6 +11,7 @@ VookiImageViewer - a tool for showing images.
 #include "MetadataExtractor.h"
 #include "Exiv2ImageAutoPtrWrapper.h"
 #include <QtConcurrent>
+#include <algorithm>
 #include <qcorofuture.h>
 
 std::vector<QString> MetadataExtractor::m_orientationDescriptions{ "", // EXIF does not use the 0 for the orientation encoding
@@ -32,12 +33,13 @@ const QString MetadataExtractor::m_unitPixel{ tr(" px", "Image Description") };
 //: Units: Second
 const QString MetadataExtractor::m_unitSecond{ tr(" s", "Image Description") };
 
-QCoro::Task<void> MetadataExtractor::extract(const QString &filename, const int width, const int height)
+MetadataExtractor::MetadataExtractor(std::shared_ptr<MetadataCache> cache)
+                                        : m_cache(std::move(cache))
 {
-    m_gpsLatitude.clear();
-    m_gpsLongitude.clear();
-    m_gpsAltitude.clear();
+}
 
+QCoro::Task<void> MetadataExtractor::extract(const QString &filename, const int width, const int height)
+{
     const QFileInfo fileInfo(filename);
     InformationMap information{ std::make_pair(tr("File name", "Image Properties"), fileInfo.fileName()) };
     addInformation(tr("Size", "Image Properties"), fileInfo.size(), information, MetadataExtractor::m_unitByte);
@@ -47,38 +49,149 @@ QCoro::Task<void> MetadataExtractor::extract(const QString &filename, const int
     emit imageSizeParsed(fileInfo.size());
     emit imageDimensionsParsed(width, height);
 
-    // Use co_await to make the potentially blocking operations asynchronous
-    co_await QtConcurrent::run([this, filename, &information]() {
-        try
-        {
-            m_exivImage = Exiv2ImageAutoPtrWrapper::open(filename.toStdString());
-            m_exivImage->readMetadata();
-            const Exiv2::ExifData &exifData = m_exivImage->exifData();
+    // Revisited images are not read again
+    const MetadataCache::Key key {MetadataCache::Key::fromFile(fileInfo)};
+    std::optional<MetadataCache::Metadata> metadata {m_cache ? m_cache->find(key) : std::nullopt};
+    if (!metadata)
+    {
+        // Use co_await to make the potentially blocking operations asynchronous
+        metadata = co_await QtConcurrent::run([this, filename, key]() {
+            if (m_cache)
+            {
+                if (std::optional<MetadataCache::Metadata> stored {m_cache->findStored(key)})
+                    return *stored;
+            }
+
+            MetadataCache::Metadata parsed {parse(filename)};
+            // Images without any metadata are cached too, so they are not parsed over and over.
+            if (m_cache)
+                m_cache->insert(key, parsed);
+            return parsed;
+        });
+    }
 
-            // Extract basic image properties
-            extractBasicProperties(exifData, information);
+    information.insert(information.end(), metadata->information.begin(), metadata->information.end());
+    emit imageInformationParsed(information);
+    co_return;
+}
 
-            // Extract GPS information
-            extractGPSInformation(exifData, information);
+MetadataCache::Metadata MetadataExtractor::parse(const QString &filename)
+{
+    m_gpsLatitude.clear();
+    m_gpsLongitude.clear();
+    m_gpsAltitude.clear();
 
-            // Extract camera and lens information
-            extractCameraInformation(exifData, information);
+    MetadataCache::Metadata metadata;
+    try
+    {
+        m_exivImage = Exiv2ImageAutoPtrWrapper::open(filename.toStdString());
+        m_exivImage->readMetadata();
+        const Exiv2::ExifData &exifData = m_exivImage->exifData();
 
-            // Debug output
-            logAllExifTags(exifData);
-        }
+        // Extract basic image properties
+        extractBasicProperties(exifData, metadata.information);
+
+        // Extract GPS information
+        extractGPSInformation(exifData, metadata.information);
+
+        // Extract camera and lens information
+        extractCameraInformation(exifData, metadata.information);
+
+        // Debug output
+        logAllExifTags(exifData);
+    }
 #if EXIV2_TEST_VERSION(0, 28, 0)
-        catch (const Exiv2::Error &error)
+    catch (const Exiv2::Error &error)
 #else
-        catch (const Exiv2::AnyError &error)
+    catch (const Exiv2::AnyError &error)
 #endif
+    {
+        qDebug() << "Cannot parse the EXIF/XMP data:" << error.what() << "Skipping...";
+    }
+
+    return metadata;
+}
+
+QDateTime MetadataExtractor::readCaptureTime(const QString &filename)
+{
+    constexpr const char *DATE_TIME_ORIGINAL_TAG = "Exif.Photo.DateTimeOriginal";
+
+    try
+    {
+        const std::unique_ptr<Exiv2::Image> image {Exiv2ImageAutoPtrWrapper::open(filename.toStdString(), false)};
+        image->readMetadata();
+        const Exiv2::ExifData &exifData = image->exifData();
+        if (const auto value {exifData.findKey(Exiv2::ExifKey(DATE_TIME_ORIGINAL_TAG))}; value != exifData.end())
+            return QDateTime::fromString(QString::fromStdString(value->toString()), QStringLiteral("yyyy:MM:dd HH:mm:ss"));
+    }
+#if EXIV2_TEST_VERSION(0, 28, 0)
+    catch (const Exiv2::Error &)
+#else
+    catch (const Exiv2::AnyError &)
+#endif
+    {
+        // Read for every image of the catalog in parallel, the ones without any metadata are common.
+    }
+
+    return {};
+}
+
+MetadataIndex::Record MetadataExtractor::readRecord(const QString &filename)
+{
+    constexpr const char *DATE_TIME_ORIGINAL_TAG = "Exif.Photo.DateTimeOriginal";
+    constexpr const char *CAMERA_MAKE_TAG = "Exif.Image.Make";
+
+    MetadataIndex::Record record;
+    try
+    {
+        const std::unique_ptr<Exiv2::Image> image {Exiv2ImageAutoPtrWrapper::open(filename.toStdString(), false)};
+        image->readMetadata();
+        const Exiv2::ExifData &exifData = image->exifData();
+
+        // The same easy access lookups as the ones shown in the image information
+        if (const auto value {exifData.findKey(Exiv2::ExifKey(DATE_TIME_ORIGINAL_TAG))}; value != exifData.end())
         {
-            qDebug() << "Cannot parse the EXIF/XMP data:" << error.what() << "Skipping...";
+            if (const QDateTime captureTime {QDateTime::fromString(QString::fromStdString(value->toString()), QStringLiteral("yyyy:MM:dd HH:mm:ss"))}; captureTime.isValid())
+                record.captureTime = captureTime.toMSecsSinceEpoch();
         }
-    });
 
-    emit imageInformationParsed(information);
-    co_return;
+        if (const auto value {Exiv2::isoSpeed(exifData)}; value != exifData.end())
+            record.iso = static_cast<quint32>(std::max<int64_t>(0, toLong(value->getValue())));
+        if (const auto value {Exiv2::fNumber(exifData)}; value != exifData.end())
+            record.fNumber = value->toFloat();
+        if (const auto value {Exiv2::exposureTime(exifData)}; value != exifData.end())
+            record.exposureTime = value->toFloat();
+        if (const auto value {Exiv2::focalLength(exifData)}; value != exifData.end())
+            record.focalLength = value->toFloat();
+
+        record.latitude = decodeGpsDegrees(exifData, "Exif.GPSInfo.GPSLatitude", "Exif.GPSInfo.GPSLatitudeRef");
+        record.longitude = decodeGpsDegrees(exifData, "Exif.GPSInfo.GPSLongitude", "Exif.GPSInfo.GPSLongitudeRef");
+
+        // Most models already start with the maker, the others are told apart by it.
+        if (const auto value {Exiv2::model(exifData)}; value != exifData.end())
+        {
+            record.camera = QString::fromStdString(value->toString()).trimmed();
+            if (const auto maker {exifData.findKey(Exiv2::ExifKey(CAMERA_MAKE_TAG))}; maker != exifData.end())
+            {
+                const QString makerName {QString::fromStdString(maker->toString()).trimmed()};
+                if (!makerName.isEmpty() && !record.camera.startsWith(makerName.section(QLatin1Char(' '), 0, 0), Qt::CaseInsensitive))
+                    record.camera = makerName + QLatin1Char(' ') + record.camera;
+            }
+        }
+
+        if (const auto value {Exiv2::lensName(exifData)}; value != exifData.end())
+            record.lens = QString::fromStdString(value->toString()).trimmed();
+    }
+#if EXIV2_TEST_VERSION(0, 28, 0)
+    catch (const Exiv2::Error &)
+#else
+    catch (const Exiv2::AnyError &)
+#endif
+    {
+        // Indexed with the unknown values then.
+    }
+
+    return record;
 }
 
 void MetadataExtractor::extractBasicProperties(const Exiv2::ExifData &exifData, InformationMap &information) {
@@ -175,6 +288,22 @@ void MetadataExtractor::extractCameraInformation(const Exiv2::ExifData &exifData
                                         information);
 }
 
+double MetadataExtractor::decodeGpsDegrees(const Exiv2::ExifData &exifData, const char *valueTag, const char *referenceTag)
+{
+    const auto value {exifData.findKey(Exiv2::ExifKey(valueTag))};
+    if (value == exifData.end() || value->count() < 3)
+        return MetadataIndex::m_unknownDouble;
+
+    double degrees {value->toFloat(0) + value->toFloat(1) / 60.0 + value->toFloat(2) / 3600.0};
+    if (const auto reference {exifData.findKey(Exiv2::ExifKey(referenceTag))}; reference != exifData.end())
+    {
+        if (const std::string direction {reference->toString()}; direction == "S" || direction == "W")
+            degrees = -degrees;
+    }
+
+    return degrees;
+}
+
 void MetadataExtractor::logAllExifTags(const Exiv2::ExifData &exifData) {
     for (const auto &it : exifData) {
         qDebug() << "+ " << it.key().c_str() << " - " << it.value().toString().c_str();
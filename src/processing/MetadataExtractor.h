@@ -9,16 +9,20 @@ VookiImageViewer - a tool for showing images.
 
 ****************************************************************************/
 
+#include <QDateTime>
 #include <QDebug>
 #include <QObject>
 #include <QString>
 #include <array>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 #include <qcorotask.h>
 #include "AutoPtrWrapper.h"
+#include "MetadataCache.h"
+#include "MetadataIndex.h"
 #include <exiv2/exiv2.hpp>
 #include "../util/compiler.h"
 
@@ -27,11 +31,18 @@ class MetadataExtractor : public QObject
     Q_OBJECT
 
 public:
-    MetadataExtractor() = default;
+    /// The cached metadata are used instead of parsing the image again, the parsed ones are cached.
+    explicit MetadataExtractor(std::shared_ptr<MetadataCache> cache = nullptr);
     ~MetadataExtractor() override = default;
     DISABLE_COPY_MOVE(MetadataExtractor);
 
     virtual QCoro::Task<void> extract(const QString &filename, int width, int height);
+    /// EXIF DateTimeOriginal of the image, the invalid time if there is none. Just the metadata are read,
+    /// so it is cheap enough to be called for every image of the directory.
+    [[nodiscard]] static QDateTime readCaptureTime(const QString &filename);
+    /// The values of the image properties as numbers, not formatted for the user, so they could be indexed.
+    /// Thread-safe, the file name of the record is left empty.
+    [[nodiscard]] static MetadataIndex::Record readRecord(const QString &filename);
 
 signals:
     void imageInformationParsed(const std::vector<std::pair<QString, QString>>& information);
@@ -121,8 +132,13 @@ protected:
     void extractGPSInformation(const Exiv2::ExifData &exifData, InformationMap &information);
     void extractCameraInformation(const Exiv2::ExifData &exifData, InformationMap &information);
 
+    /// Reads and parses the image, runs on the calling thread.
+    [[nodiscard]] MetadataCache::Metadata parse(const QString &filename);
+
 private:
     static void logAllExifTags(const Exiv2::ExifData &exifData);
+    /// Degrees of the rational triple, negative for the south or the west reference.
+    [[nodiscard]] static double decodeGpsDegrees(const Exiv2::ExifData &exifData, const char *valueTag, const char *referenceTag);
     [[nodiscard]] static int64_t toLong(std::unique_ptr<Exiv2::Value> value)
     {
 #if EXIV2_TEST_VERSION(0,28,0)
@@ -150,6 +166,7 @@ private:
     QString m_gpsAltitude;
 
     std::unique_ptr<Exiv2::Image> m_exivImage;
+    std::shared_ptr<MetadataCache> m_cache;
     static std::vector<QString> m_orientationDescriptions;
     static const QString m_unitByte;
     static const QString m_unitMeter;
@@ -0,0 +1,357 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "MetadataIndex.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+#include "../util/PrivateFile.h"
+
+namespace
+{
+    constexpr quint32 magic {0x564D4958}; // "VMIX"
+    constexpr quint32 version {2};
+    // Bytes an entry takes in the file at least, the length of its file name and its columns.
+    constexpr quint64 minEntrySize {sizeof(quint32) + sizeof(qint64) + sizeof(quint32) + 3 * sizeof(float) + 2 * sizeof(double) + 2 * sizeof(quint32)
+                                    + 2 * sizeof(qint64)};
+
+    // Columns are written as they are in the memory, so the whole column is a single read.
+    template<typename T>
+    void writeColumn(QDataStream &stream, const std::vector<T> &column)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        stream.writeRawData(reinterpret_cast<const char *>(column.data()), static_cast<qsizetype>(column.size() * sizeof(T)));
+    }
+
+    template<typename T>
+    bool readColumn(QDataStream &stream, std::vector<T> &column, const quint64 count)
+    {
+        column.resize(count);
+        const auto size {static_cast<qsizetype>(count * sizeof(T))};
+        return stream.readRawData(reinterpret_cast<char *>(column.data()), size) == size;
+    }
+
+    template<typename T, typename IsKnown>
+    void sortByColumn(std::vector<quint32> &positions, const std::vector<T> &column, const bool descending, IsKnown isKnown)
+    {
+        // The positions are sorted by the file names already, the stable algorithms keep that among the equal values.
+        const auto known {std::stable_partition(positions.begin(), positions.end(), [&column, &isKnown](const quint32 position) {
+            return isKnown(column[position]);
+        })};
+        std::stable_sort(positions.begin(), known, [&column, descending](const quint32 left, const quint32 right) {
+            return descending ? column[right] < column[left] : column[left] < column[right];
+        });
+    }
+}
+
+qsizetype MetadataIndex::size() const
+{
+    return m_fileNames.size();
+}
+
+bool MetadataIndex::isEmpty() const
+{
+    return m_fileNames.isEmpty();
+}
+
+void MetadataIndex::reserve(const qsizetype count)
+{
+    // The file names are rarely longer
+    m_fileNames.reserve(count, count * 32);
+    m_captureTimes.reserve(count);
+    m_isos.reserve(count);
+    m_fNumbers.reserve(count);
+    m_exposureTimes.reserve(count);
+    m_focalLengths.reserve(count);
+    m_latitudes.reserve(count);
+    m_longitudes.reserve(count);
+    m_cameras.reserve(count);
+    m_lenses.reserve(count);
+    m_fileSizes.reserve(count);
+    m_modificationTimes.reserve(count);
+}
+
+void MetadataIndex::append(const Record &record)
+{
+    m_fileNames.append(record.fileName);
+    m_captureTimes.push_back(record.captureTime);
+    m_isos.push_back(record.iso);
+    m_fNumbers.push_back(record.fNumber);
+    m_exposureTimes.push_back(record.exposureTime);
+    m_focalLengths.push_back(record.focalLength);
+    m_latitudes.push_back(record.latitude);
+    m_longitudes.push_back(record.longitude);
+    m_cameras.push_back(m_cameraNames.insert(record.camera));
+    m_lenses.push_back(m_lensNames.insert(record.lens));
+    m_fileSizes.push_back(record.fileSize);
+    m_modificationTimes.push_back(record.modificationTime);
+}
+
+void MetadataIndex::clear()
+{
+    *this = {};
+}
+
+MetadataIndex::Record MetadataIndex::at(const qsizetype position) const
+{
+    return {m_fileNames.at(position).toString(),
+            m_captureTimes.at(position),
+            m_isos.at(position),
+            m_fNumbers.at(position),
+            m_exposureTimes.at(position),
+            m_focalLengths.at(position),
+            m_latitudes.at(position),
+            m_longitudes.at(position),
+            m_cameraNames.names.at(m_cameras.at(position)),
+            m_lensNames.names.at(m_lenses.at(position)),
+            m_fileSizes.at(position),
+            m_modificationTimes.at(position)};
+}
+
+qsizetype MetadataIndex::indexOf(const QStringView fileName) const
+{
+    return m_fileNames.indexOf(fileName);
+}
+
+QStringList MetadataIndex::getCameras() const
+{
+    return m_cameraNames.names.mid(1);
+}
+
+QHash<QString, MetadataIndex::CaptureTime> MetadataIndex::getCaptureTimes() const
+{
+    QHash<QString, CaptureTime> captureTimes;
+    captureTimes.reserve(size());
+    for (qsizetype position = 0; position < size(); ++position)
+        captureTimes.insert(m_fileNames[position].toString(), {m_captureTimes[position], m_fileSizes[position], m_modificationTimes[position]});
+
+    return captureTimes;
+}
+
+std::vector<quint32> MetadataIndex::sort(const Column column, const bool descending) const
+{
+    std::vector<quint32> positions(static_cast<std::size_t>(size()));
+    std::iota(positions.begin(), positions.end(), 0);
+    std::sort(positions.begin(), positions.end(), [this, column, descending](const quint32 left, const quint32 right) {
+        // Descending file names just for their own column, they break the ties in the ascending order otherwise.
+        return column == Column::FileName && descending ? m_fileNames[right] < m_fileNames[left] : m_fileNames[left] < m_fileNames[right];
+    });
+
+    const auto isKnownFloat = [](const auto value) { return !std::isnan(value); };
+    const auto isKnownId = [](const quint32 value) { return value != 0; };
+
+    switch (column)
+    {
+        case Column::CaptureTime:
+            sortByColumn(positions, m_captureTimes, descending, [](const qint64 value) { return value != m_unknownTime; });
+            break;
+        case Column::Iso:
+            sortByColumn(positions, m_isos, descending, isKnownId);
+            break;
+        case Column::FNumber:
+            sortByColumn(positions, m_fNumbers, descending, isKnownFloat);
+            break;
+        case Column::ExposureTime:
+            sortByColumn(positions, m_exposureTimes, descending, isKnownFloat);
+            break;
+        case Column::FocalLength:
+            sortByColumn(positions, m_focalLengths, descending, isKnownFloat);
+            break;
+        case Column::Camera:
+        case Column::Lens:
+        {
+            // The dictionary is ranked once, the rows are compared by the ranks then.
+            const Dictionary &dictionary {column == Column::Camera ? m_cameraNames : m_lensNames};
+            const std::vector<quint32> &ids {column == Column::Camera ? m_cameras : m_lenses};
+            const std::vector<quint32> ranks {dictionary.ranks()};
+            std::vector<quint32> rankedIds(ids.size());
+            std::transform(ids.begin(), ids.end(), rankedIds.begin(), [&ranks](const quint32 id) { return ranks[id]; });
+            sortByColumn(positions, rankedIds, descending, isKnownId);
+            break;
+        }
+        case Column::FileName:
+        default:
+            break;
+    }
+
+    return positions;
+}
+
+std::vector<quint32> MetadataIndex::select(const Filter &filter) const
+{
+    std::optional<quint32> camera {};
+    if (!filter.camera.isEmpty())
+    {
+        const auto id {m_cameraNames.ids.constFind(filter.camera)};
+        if (id == m_cameraNames.ids.cend())
+            return {};
+        camera = *id;
+    }
+
+    const bool isTimeFiltered {filter.capturedFrom != std::numeric_limits<qint64>::min() || filter.capturedTo != std::numeric_limits<qint64>::max()};
+    const bool isIsoFiltered {filter.minIso != 0 || filter.maxIso != std::numeric_limits<quint32>::max()};
+
+    std::vector<quint32> positions;
+    for (quint32 position = 0; position < static_cast<quint32>(size()); ++position)
+    {
+        if (isTimeFiltered)
+        {
+            const qint64 captureTime {m_captureTimes[position]};
+            if (captureTime == m_unknownTime || captureTime < filter.capturedFrom || captureTime > filter.capturedTo)
+                continue;
+        }
+
+        if (isIsoFiltered && (m_isos[position] == 0 || m_isos[position] < filter.minIso || m_isos[position] > filter.maxIso))
+            continue;
+
+        if (camera && m_cameras[position] != *camera)
+            continue;
+
+        if (filter.hasLocation && (std::isnan(m_latitudes[position]) || std::isnan(m_longitudes[position])))
+            continue;
+
+        positions.push_back(position);
+    }
+
+    return positions;
+}
+
+QString MetadataIndex::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/metadataindex");
+}
+
+QString MetadataIndex::indexPath(const QString &directory, const QString &indexedDirectory)
+{
+    const QByteArray hash {QCryptographicHash::hash(QDir::cleanPath(indexedDirectory).toUtf8(), QCryptographicHash::Md5).toHex()};
+    return QStringLiteral("%1/%2.midx").arg(QDir::cleanPath(directory), QString::fromLatin1(hash));
+}
+
+bool MetadataIndex::store(const QString &path) const
+{
+    // The index lists the capture times and the places of a whole directory of images.
+    QSaveFile file {path};
+    if (!Util::openPrivateFile(file))
+        return false;
+
+    QDataStream stream {&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << magic << version << static_cast<quint64>(size());
+    for (qsizetype position = 0; position < size(); ++position)
+        stream << m_fileNames[position].toString();
+
+    writeColumn(stream, m_captureTimes);
+    writeColumn(stream, m_isos);
+    writeColumn(stream, m_fNumbers);
+    writeColumn(stream, m_exposureTimes);
+    writeColumn(stream, m_focalLengths);
+    writeColumn(stream, m_latitudes);
+    writeColumn(stream, m_longitudes);
+    writeColumn(stream, m_cameras);
+    writeColumn(stream, m_lenses);
+    writeColumn(stream, m_fileSizes);
+    writeColumn(stream, m_modificationTimes);
+    stream << m_cameraNames.names << m_lensNames.names;
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+    {
+        qDebug() << "Metadata index storing failed:" << path << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<MetadataIndex> MetadataIndex::load(const QString &path)
+{
+    QFile file {path};
+    if (!file.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    QDataStream stream {&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 storedMagic {0};
+    quint32 storedVersion {0};
+    quint64 count {0};
+    stream >> storedMagic >> storedVersion >> count;
+    // Guards against the allocation driven by a corrupted file, the entries could not fit into it.
+    if (stream.status() != QDataStream::Ok || storedMagic != magic || storedVersion != version
+        || count > static_cast<quint64>(file.size()) / minEntrySize)
+        return std::nullopt;
+
+    MetadataIndex index;
+    index.m_fileNames.reserve(static_cast<qsizetype>(count), static_cast<qsizetype>(count) * 32);
+    for (quint64 position = 0; position < count && stream.status() == QDataStream::Ok; ++position)
+    {
+        QString fileName;
+        stream >> fileName;
+        index.m_fileNames.append(fileName);
+    }
+
+    if (!readColumn(stream, index.m_captureTimes, count) || !readColumn(stream, index.m_isos, count) || !readColumn(stream, index.m_fNumbers, count)
+        || !readColumn(stream, index.m_exposureTimes, count) || !readColumn(stream, index.m_focalLengths, count)
+        || !readColumn(stream, index.m_latitudes, count) || !readColumn(stream, index.m_longitudes, count)
+        || !readColumn(stream, index.m_cameras, count) || !readColumn(stream, index.m_lenses, count)
+        || !readColumn(stream, index.m_fileSizes, count) || !readColumn(stream, index.m_modificationTimes, count))
+        return std::nullopt;
+
+    stream >> index.m_cameraNames.names >> index.m_lensNames.names;
+    if (stream.status() != QDataStream::Ok || index.m_cameraNames.names.isEmpty() || index.m_lensNames.names.isEmpty())
+        return std::nullopt;
+
+    // The ids have to point into the dictionaries
+    const auto isValid = [](const std::vector<quint32> &ids, const Dictionary &dictionary) {
+        return std::all_of(ids.begin(), ids.end(), [&dictionary](const quint32 id) { return id < static_cast<quint32>(dictionary.names.size()); });
+    };
+    if (!isValid(index.m_cameras, index.m_cameraNames) || !isValid(index.m_lenses, index.m_lensNames))
+        return std::nullopt;
+
+    for (auto *dictionary : {&index.m_cameraNames, &index.m_lensNames})
+    {
+        dictionary->ids.clear();
+        for (qsizetype id = 0; id < dictionary->names.size(); ++id)
+            dictionary->ids.insert(dictionary->names.at(id), static_cast<quint32>(id));
+    }
+
+    return index;
+}
+
+quint32 MetadataIndex::Dictionary::insert(const QString &name)
+{
+    const auto id {ids.constFind(name)};
+    if (id != ids.cend())
+        return *id;
+
+    const auto newId {static_cast<quint32>(names.size())};
+    names.append(name);
+    ids.insert(name, newId);
+    return newId;
+}
+
+std::vector<quint32> MetadataIndex::Dictionary::ranks() const
+{
+    std::vector<quint32> order(static_cast<std::size_t>(names.size()));
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](const quint32 left, const quint32 right) { return names.at(left) < names.at(right); });
+
+    std::vector<quint32> result(order.size());
+    for (std::size_t rank = 0; rank < order.size(); ++rank)
+        result[order[rank]] = static_cast<quint32>(rank);
+
+    return result;
+}
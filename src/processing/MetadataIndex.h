@@ -0,0 +1,137 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "../util/StringArena.h"
+
+/// Metadata of many images laid out in columns, one value per image in every column. Sorting and filtering scan
+/// just the columns they need, and the camera and lens names are stored once in their dictionaries.
+class MetadataIndex
+{
+public:
+    static constexpr qint64 m_unknownTime {std::numeric_limits<qint64>::min()};
+    static constexpr float m_unknownFloat {std::numeric_limits<float>::quiet_NaN()};
+    static constexpr double m_unknownDouble {std::numeric_limits<double>::quiet_NaN()};
+
+    /// Metadata of a single image, the unknown values are the m_unknown ones, zero or empty.
+    struct Record
+    {
+        QString fileName {};
+        /// EXIF DateTimeOriginal, in milliseconds since the epoch
+        qint64 captureTime {m_unknownTime};
+        quint32 iso {0};
+        float fNumber {m_unknownFloat};
+        /// In seconds
+        float exposureTime {m_unknownFloat};
+        /// In millimeters
+        float focalLength {m_unknownFloat};
+        /// In degrees, the south and the west are negative
+        double latitude {m_unknownDouble};
+        double longitude {m_unknownDouble};
+        QString camera {};
+        QString lens {};
+        /// Of the file when it was indexed, the record is outdated once the file differs
+        qint64 fileSize {-1};
+        qint64 modificationTime {m_unknownTime};
+    };
+
+    /// Capture time of an indexed image, along with the file it was read from.
+    struct CaptureTime
+    {
+        qint64 captureTime {m_unknownTime};
+        qint64 fileSize {-1};
+        qint64 modificationTime {m_unknownTime};
+    };
+
+    enum class Column
+    {
+        FileName,
+        CaptureTime,
+        Iso,
+        FNumber,
+        ExposureTime,
+        FocalLength,
+        Camera,
+        Lens,
+    };
+
+    /// The images matching all the conditions are selected, the default ones match everything.
+    struct Filter
+    {
+        qint64 capturedFrom {std::numeric_limits<qint64>::min()};
+        qint64 capturedTo {std::numeric_limits<qint64>::max()};
+        quint32 minIso {0};
+        quint32 maxIso {std::numeric_limits<quint32>::max()};
+        /// Empty matches any camera
+        QString camera {};
+        bool hasLocation {false};
+    };
+
+    [[nodiscard]] qsizetype size() const;
+    [[nodiscard]] bool isEmpty() const;
+    void reserve(qsizetype count);
+    void append(const Record &record);
+    void clear();
+    [[nodiscard]] Record at(qsizetype position) const;
+    /// Returns -1 if the file is not indexed.
+    [[nodiscard]] qsizetype indexOf(QStringView fileName) const;
+    /// Distinct camera names, in the order they were found.
+    [[nodiscard]] QStringList getCameras() const;
+    /// Capture times by the file names, a snapshot safe to be shared with the worker threads.
+    [[nodiscard]] QHash<QString, CaptureTime> getCaptureTimes() const;
+
+    /// Returns the positions of the images in the sorted order. The images with the unknown value go last
+    /// in both orders, the file names decide among the equal ones.
+    [[nodiscard]] std::vector<quint32> sort(Column column, bool descending = false) const;
+    /// Returns the positions of the matching images, in the index order.
+    [[nodiscard]] std::vector<quint32> select(const Filter &filter) const;
+
+    /// The index directory in the application cache location.
+    [[nodiscard]] static QString defaultDirectory();
+    /// Named by the MD5 of the indexed directory path.
+    [[nodiscard]] static QString indexPath(const QString &directory, const QString &indexedDirectory);
+    bool store(const QString &path) const;
+    /// Returns nothing if the file is missing, corrupted or of another version.
+    [[nodiscard]] static std::optional<MetadataIndex> load(const QString &path);
+
+private:
+    /// Names stored once, the 0 stands for the unknown one.
+    struct Dictionary
+    {
+        QStringList names {QString {}};
+        QHash<QString, quint32> ids {{QString {}, 0}};
+
+        quint32 insert(const QString &name);
+        /// Ranks of the names in their sorted order, the unknown one included.
+        [[nodiscard]] std::vector<quint32> ranks() const;
+    };
+
+    StringArena m_fileNames {};
+    std::vector<qint64> m_captureTimes {};
+    std::vector<quint32> m_isos {};
+    std::vector<float> m_fNumbers {};
+    std::vector<float> m_exposureTimes {};
+    std::vector<float> m_focalLengths {};
+    std::vector<double> m_latitudes {};
+    std::vector<double> m_longitudes {};
+    std::vector<quint32> m_cameras {};
+    std::vector<quint32> m_lenses {};
+    std::vector<qint64> m_fileSizes {};
+    std::vector<qint64> m_modificationTimes {};
+    Dictionary m_cameraNames {};
+    Dictionary m_lensNames {};
+};
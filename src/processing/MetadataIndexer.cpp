@@ -0,0 +1,125 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "MetadataIndexer.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <utility>
+
+double MetadataIndexer::Statistics::filesPerSecond() const
+{
+    return elapsed > 0 ? static_cast<double>(fileCount) * 1000.0 / static_cast<double>(elapsed) : 0.0;
+}
+
+MetadataIndexer::MetadataIndexer(RecordReader recordReader, QObject *parent)
+                                        : QObject(parent)
+                                        , m_recordReader(std::move(recordReader))
+{
+    m_threadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+MetadataIndexer::~MetadataIndexer()
+{
+    if (m_indexing)
+        m_indexing->cancel();
+
+    m_threadPool.waitForDone();
+}
+
+void MetadataIndexer::setMaxThreadCount(const int count)
+{
+    m_threadPool.setMaxThreadCount(std::max(1, count));
+}
+
+int MetadataIndexer::getMaxThreadCount() const
+{
+    return m_threadPool.maxThreadCount();
+}
+
+void MetadataIndexer::start(const QString &directory, const QStringList &fileNames)
+{
+    cancel();
+
+    m_directory = directory;
+    m_totalCount = fileNames.size();
+    m_index.clear();
+    m_statistics = {};
+    m_timer.start();
+
+    m_indexing = std::make_unique<QFutureWatcher<MetadataIndex::Record>>();
+    QObject::connect(m_indexing.get(), &QFutureWatcher<MetadataIndex::Record>::progressValueChanged, this, &MetadataIndexer::onProgressValueChanged);
+    QObject::connect(m_indexing.get(), &QFutureWatcher<MetadataIndex::Record>::finished, this, &MetadataIndexer::onFinished);
+    // The results are kept in the order of the file names, whichever thread reads them.
+    m_indexing->setFuture(QtConcurrent::mapped(&m_threadPool, fileNames, [directory, recordReader = m_recordReader](const QString &fileName) {
+        const QString filePath {directory + QLatin1Char('/') + fileName};
+        // Taken before the reading, the file modified meanwhile is recognized as outdated then.
+        const QFileInfo info {filePath};
+        const qint64 fileSize {info.size()};
+        const qint64 modificationTime {info.lastModified().toMSecsSinceEpoch()};
+        MetadataIndex::Record record {recordReader ? recordReader(filePath) : MetadataIndex::Record {}};
+        record.fileName = fileName;
+        record.fileSize = fileSize;
+        record.modificationTime = modificationTime;
+        return record;
+    }));
+}
+
+void MetadataIndexer::cancel()
+{
+    if (!m_indexing)
+        return;
+
+    m_indexing->disconnect(this);
+    m_indexing->cancel();
+    m_indexing.release()->deleteLater();
+}
+
+bool MetadataIndexer::isRunning() const
+{
+    return m_indexing != nullptr;
+}
+
+const MetadataIndex &MetadataIndexer::getIndex() const
+{
+    return m_index;
+}
+
+QString MetadataIndexer::getDirectory() const
+{
+    return m_directory;
+}
+
+const MetadataIndexer::Statistics &MetadataIndexer::getStatistics() const
+{
+    return m_statistics;
+}
+
+void MetadataIndexer::onProgressValueChanged(const int value)
+{
+    emit progressChanged(value, m_totalCount);
+}
+
+void MetadataIndexer::onFinished()
+{
+    const QFuture<MetadataIndex::Record> future {m_indexing->future()};
+    m_indexing->disconnect(this);
+    m_indexing.release()->deleteLater();
+
+    // The columns are filled on the GUI thread, the records are just copied there.
+    m_index.reserve(future.resultCount());
+    for (int i = 0; i < future.resultCount(); ++i)
+        m_index.append(future.resultAt(i));
+
+    m_statistics = {m_index.size(), m_timer.elapsed()};
+    emit finished();
+}
@@ -0,0 +1,79 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <functional>
+#include <memory>
+#include "MetadataIndex.h"
+#include "../util/compiler.h"
+
+/// Reads the metadata of all the images of a directory in the background and builds their MetadataIndex.
+/// The images are read in parallel on a bounded thread pool, the index keeps the order of the file names.
+class MetadataIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Reads a single image, called from the worker threads. The file name, size and modification time of the record
+    /// are filled in by the indexer.
+    using RecordReader = std::function<MetadataIndex::Record(const QString &filePath)>;
+
+    struct Statistics
+    {
+        qsizetype fileCount {0};
+        /// In milliseconds
+        qint64 elapsed {0};
+
+        [[nodiscard]] double filesPerSecond() const;
+    };
+
+    explicit MetadataIndexer(RecordReader recordReader, QObject *parent = nullptr);
+    ~MetadataIndexer() override;
+    DISABLE_COPY_MOVE(MetadataIndexer);
+
+    /// The indexing should not starve the decoding of the shown image, so just a half of the cores is used by default.
+    void setMaxThreadCount(int count);
+    [[nodiscard]] int getMaxThreadCount() const;
+    /// Indexes the files relative to the directory, the running indexing is cancelled first.
+    void start(const QString &directory, const QStringList &fileNames);
+    void cancel();
+    [[nodiscard]] bool isRunning() const;
+
+    /// Valid once finished() is emitted, until the next start.
+    [[nodiscard]] const MetadataIndex &getIndex() const;
+    [[nodiscard]] QString getDirectory() const;
+    [[nodiscard]] const Statistics &getStatistics() const;
+
+signals:
+    void progressChanged(qsizetype indexedCount, qsizetype totalCount);
+    void finished();
+
+private slots:
+    void onProgressValueChanged(int value);
+    void onFinished();
+
+private:
+    RecordReader m_recordReader;
+    QString m_directory {};
+    qsizetype m_totalCount {0};
+    MetadataIndex m_index {};
+    Statistics m_statistics {};
+    QElapsedTimer m_timer {};
+
+    QThreadPool m_threadPool {};
+    // A watcher per indexing, the cancelled one is dropped together with its pending results.
+    std::unique_ptr<QFutureWatcher<MetadataIndex::Record>> m_indexing {};
+};
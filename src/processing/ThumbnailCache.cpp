@@ -0,0 +1,186 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ThumbnailCache.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QStandardPaths>
+#include <QThread>
+#include <QUrl>
+#include <QtConcurrent>
+#include <algorithm>
+#include <qcorofuture.h>
+#include "../util/PrivateFile.h"
+
+namespace
+{
+    // Keys defined by the specification
+    const QString uriKey {QStringLiteral("Thumb::URI")};
+    const QString mtimeKey {QStringLiteral("Thumb::MTime")};
+    const QString sizeKey {QStringLiteral("Thumb::Size")};
+    const QString widthKey {QStringLiteral("Thumb::Image::Width")};
+    const QString heightKey {QStringLiteral("Thumb::Image::Height")};
+    const QString softwareKey {QStringLiteral("Software")};
+    const QString software {QStringLiteral("VookiImageViewer")};
+}
+
+ThumbnailCache::ThumbnailCache(const QString &directory)
+                                        : m_directory(QDir::cleanPath(directory))
+{
+    // Thumbnails are requested in bulks, but the GUI thread and the shown image should not wait for them.
+    m_threadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    cancel();
+    m_threadPool.waitForDone();
+}
+
+QString ThumbnailCache::defaultDirectory()
+{
+    // Respects the XDG_CACHE_HOME on the freedesktop platforms
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QStringLiteral("/thumbnails");
+}
+
+int ThumbnailCache::pixelSize(const Size size)
+{
+    return size == Size::Large ? 256 : 128;
+}
+
+QString ThumbnailCache::uri(const QString &fileName)
+{
+    return QString::fromLatin1(QUrl::fromLocalFile(QFileInfo(fileName).absoluteFilePath()).toEncoded());
+}
+
+QString ThumbnailCache::thumbnailPath(const QString &fileName, const Size size) const
+{
+    const QByteArray hash {QCryptographicHash::hash(uri(fileName).toUtf8(), QCryptographicHash::Md5).toHex()};
+    return QStringLiteral("%1/%2/%3.png").arg(m_directory, size == Size::Large ? QStringLiteral("large") : QStringLiteral("normal"), QString::fromLatin1(hash));
+}
+
+QString ThumbnailCache::failurePath(const QString &fileName) const
+{
+    const QByteArray hash {QCryptographicHash::hash(uri(fileName).toUtf8(), QCryptographicHash::Md5).toHex()};
+    return QStringLiteral("%1/fail/vookiimageviewer/%2.png").arg(m_directory, QString::fromLatin1(hash));
+}
+
+QImage ThumbnailCache::find(const QString &fileName, const Size size) const
+{
+    QImage thumbnail;
+    if (!thumbnail.load(thumbnailPath(fileName, size), "PNG") || !isValid(thumbnail, fileName))
+        return {};
+
+    return thumbnail;
+}
+
+bool ThumbnailCache::hasFailed(const QString &fileName) const
+{
+    QImage failure;
+    return failure.load(failurePath(fileName), "PNG") && isValid(failure, fileName);
+}
+
+QImage ThumbnailCache::create(const QString &fileName, const Size size) const
+{
+    const QFileInfo info {fileName};
+    // Thumbnails of the thumbnails are never created, see the specification.
+    if (!info.isFile() || info.absoluteFilePath().startsWith(m_directory + QLatin1Char('/')))
+        return {};
+
+    QImageReader reader {fileName};
+    reader.setAutoTransform(true);
+
+    // Plugins supporting the scaled decoding (e.g. JPEG) produce the thumbnail right away. Raw images are decoded
+    // through their embedded preview by the rawthumb plugin, so they do not need anything special.
+    const int side {pixelSize(size)};
+    QSize originalSize {reader.size()};
+    if (originalSize.isValid() && reader.supportsOption(QImageIOHandler::ScaledSize) && std::max(originalSize.width(), originalSize.height()) > side)
+        reader.setScaledSize(originalSize.scaled(side, side, Qt::KeepAspectRatio));
+
+    if (reader.transformation().testFlag(QImageIOHandler::TransformationRotate90))
+        originalSize.transpose();
+
+    QImage image;
+    if (!reader.read(&image))
+    {
+        // Remembered, so the broken image is not decoded over and over.
+        QImage failure {1, 1, QImage::Format_ARGB32};
+        failure.fill(Qt::transparent);
+        store(failure, failurePath(fileName), fileName);
+        return {};
+    }
+
+    if (std::max(image.width(), image.height()) > side)
+        image = image.scaled(side, side, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    if (originalSize.isValid())
+    {
+        image.setText(widthKey, QString::number(originalSize.width()));
+        image.setText(heightKey, QString::number(originalSize.height()));
+    }
+
+    store(image, thumbnailPath(fileName, size), fileName);
+    return image;
+}
+
+QCoro::Task<QImage> ThumbnailCache::thumbnail(const QString &fileName, const Size size)
+{
+    const quint64 generation {m_generation};
+    co_return co_await QtConcurrent::run(&m_threadPool, [this, fileName, size, generation]() {
+        // Requests cancelled while waiting in the queue are not worth starting.
+        if (generation != m_generation)
+            return QImage {};
+
+        if (QImage thumbnail {find(fileName, size)}; !thumbnail.isNull())
+            return thumbnail;
+
+        return hasFailed(fileName) ? QImage {} : create(fileName, size);
+    });
+}
+
+void ThumbnailCache::cancel()
+{
+    ++m_generation;
+}
+
+bool ThumbnailCache::isValid(const QImage &thumbnail, const QString &fileName) const
+{
+    const QFileInfo info {fileName};
+    if (!info.isFile() || thumbnail.text(uriKey) != uri(fileName))
+        return false;
+
+    // The size is optional, but it catches the modifications within the same second.
+    const QString size {thumbnail.text(sizeKey)};
+    return thumbnail.text(mtimeKey) == QString::number(info.lastModified().toSecsSinceEpoch())
+           && (size.isEmpty() || size == QString::number(info.size()));
+}
+
+bool ThumbnailCache::store(QImage &thumbnail, const QString &path, const QString &fileName) const
+{
+    const QFileInfo info {fileName};
+    thumbnail.setText(uriKey, uri(fileName));
+    thumbnail.setText(mtimeKey, QString::number(info.lastModified().toSecsSinceEpoch()));
+    thumbnail.setText(sizeKey, QString::number(info.size()));
+    thumbnail.setText(softwareKey, software);
+
+    // Thumbnails may contain private information, so they are readable by the owner only. Other applications
+    // might read the thumbnail meanwhile, so it is written to a temporary file and renamed.
+    QSaveFile file {path};
+    if (!Util::openPrivateFile(file) || !thumbnail.save(&file, "PNG") || !file.commit())
+    {
+        qDebug() << "Thumbnail storing failed:" << path << file.errorString();
+        return false;
+    }
+
+    return true;
+}
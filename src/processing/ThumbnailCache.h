@@ -0,0 +1,65 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <qcorotask.h>
+#include "../util/compiler.h"
+
+/// Persistent thumbnails following the freedesktop.org thumbnail managing standard, so they are shared with other
+/// desktop applications. Thumbnails are PNG files named by the MD5 of the image URI, they are valid as long as the
+/// stored modification time matches the image one. Images which could not be decoded are remembered too.
+class ThumbnailCache
+{
+public:
+    enum class Size {
+        /// 128 pixels
+        Normal,
+        /// 256 pixels
+        Large
+    };
+
+    explicit ThumbnailCache(const QString &directory = defaultDirectory());
+    ~ThumbnailCache();
+    DISABLE_COPY_MOVE(ThumbnailCache);
+
+    /// The thumbnails directory in the XDG cache location, e.g. ~/.cache/thumbnails.
+    [[nodiscard]] static QString defaultDirectory();
+    [[nodiscard]] static int pixelSize(Size size);
+    /// The canonical URI of the image, the thumbnail file name is derived from it.
+    [[nodiscard]] static QString uri(const QString &fileName);
+    [[nodiscard]] QString thumbnailPath(const QString &fileName, Size size) const;
+    [[nodiscard]] QString failurePath(const QString &fileName) const;
+
+    /// Returns the stored thumbnail, or the null image if there is none or it is outdated. Nothing is decoded.
+    [[nodiscard]] QImage find(const QString &fileName, Size size) const;
+    /// True if the image has already failed to be thumbnailed and has not been modified since then.
+    [[nodiscard]] bool hasFailed(const QString &fileName) const;
+    /// Decodes the image in the reduced resolution and stores its thumbnail. Runs on the calling thread.
+    QImage create(const QString &fileName, Size size) const;
+    /// Returns the stored thumbnail, or creates it on the worker threads. Returns the null image if the image cannot
+    /// be decoded, or the request has been cancelled.
+    QCoro::Task<QImage> thumbnail(const QString &fileName, Size size);
+    /// Drops all requests which have not been started yet.
+    void cancel();
+
+protected:
+    [[nodiscard]] bool isValid(const QImage &thumbnail, const QString &fileName) const;
+    bool store(QImage &thumbnail, const QString &path, const QString &fileName) const;
+
+private:
+    QString m_directory;
+    // Incremented on every cancel, the requests made before are dropped.
+    std::atomic<quint64> m_generation {0};
+    QThreadPool m_threadPool {};
+};
@@ -0,0 +1,105 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QDir>
+#include <QImageReader>
+
+#include "AnimationFrameBufferTest.h"
+#include "../AnimationFrameBuffer.h"
+#include "../MemoryBudget.h"
+
+QString AnimationFrameBufferTest::makeAbsolutePath(const QString &file) const
+{
+    return QDir::cleanPath(m_absolutePath + QDir::separator() + file);
+}
+
+std::vector<QImage> AnimationFrameBufferTest::readFrames() const
+{
+    QImageReader reader(makeAbsolutePath(AnimationFrameBufferTest::animatedNumbersFilePath));
+    reader.setAutoTransform(true);
+    std::vector<QImage> frames;
+    for (int i = 0; i < m_frameCount; ++i)
+        frames.push_back(reader.read());
+
+    return frames;
+}
+
+void AnimationFrameBufferTest::open() const
+{
+    AnimationFrameBuffer buffer;
+    QCOMPARE(buffer.open("@#$%", m_frameCount), false);
+    QCOMPARE(buffer.isOpen(), false);
+    QCOMPARE(buffer.open(makeAbsolutePath(AnimationFrameBufferTest::animatedNumbersFilePath), 0), false);
+    QCOMPARE(buffer.takeFrame(0).has_value(), false);
+
+    QCOMPARE(buffer.open(makeAbsolutePath(AnimationFrameBufferTest::animatedNumbersFilePath), m_frameCount), true);
+    QCOMPARE(buffer.isOpen(), true);
+    // Frames out of the animation are never decoded
+    QCOMPARE(buffer.takeFrame(m_frameCount).has_value(), false);
+    QCOMPARE(buffer.takeFrame(-1).has_value(), false);
+
+    buffer.close();
+    QCOMPARE(buffer.isOpen(), false);
+    QCOMPARE(buffer.takeFrame(0).has_value(), false);
+}
+
+void AnimationFrameBufferTest::keepsAllFrames() const
+{
+    const std::vector<QImage> expectedFrames {readFrames()};
+    MemoryBudget budget;
+    AnimationFrameBuffer buffer;
+    buffer.setMemoryBudget(&budget);
+    QCOMPARE(buffer.open(makeAbsolutePath(AnimationFrameBufferTest::animatedNumbersFilePath), m_frameCount), true);
+    QCOMPARE(buffer.keepsAllFrames(), true);
+
+    // Looping reads the kept frames, nothing is decoded again
+    for (int loop = 0; loop < 2; ++loop)
+    {
+        for (int i = 0; i < m_frameCount; ++i)
+        {
+            const auto frame {buffer.takeFrame(i)};
+            QVERIFY(frame.has_value());
+            QCOMPARE(frame->image, expectedFrames[i]);
+            QCOMPARE(frame->delay, m_frameDelay);
+            // Codecs not telling the updated area return the null rectangle
+            QVERIFY(frame->rect.isNull() || frame->image.rect().contains(frame->rect));
+        }
+    }
+
+    qsizetype expectedSize {0};
+    for (const QImage &frame : expectedFrames)
+        expectedSize += frame.sizeInBytes();
+    QCOMPARE(budget.usage(MemoryBudget::Category::AnimationFrames), expectedSize);
+
+    buffer.close();
+    QCOMPARE(budget.usage(MemoryBudget::Category::AnimationFrames), 0);
+}
+
+void AnimationFrameBufferTest::streamsFrames() const
+{
+    const std::vector<QImage> expectedFrames {readFrames()};
+    // Not even a single frame fits the budget, so the frames are streamed
+    MemoryBudget budget {1};
+    AnimationFrameBuffer buffer;
+    buffer.setMemoryBudget(&budget);
+    QCOMPARE(buffer.open(makeAbsolutePath(AnimationFrameBufferTest::animatedNumbersFilePath), m_frameCount), true);
+    QCOMPARE(buffer.keepsAllFrames(), false);
+
+    // The first frame is skipped, as it is shown by the loader already
+    for (int i = 1; i < 3 * m_frameCount; ++i)
+    {
+        const auto frame {buffer.takeFrame(i % m_frameCount)};
+        QVERIFY(frame.has_value());
+        QCOMPARE(frame->image, expectedFrames[i % m_frameCount]);
+        QCOMPARE(frame->delay, m_frameDelay);
+    }
+
+    QVERIFY(budget.usage(MemoryBudget::Category::AnimationFrames) <= AnimationFrameBuffer::m_ringCapacity * expectedFrames.front().sizeInBytes());
+}
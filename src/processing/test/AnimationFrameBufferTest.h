@@ -0,0 +1,38 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QImage>
+#include <QTest>
+#include <vector>
+
+#ifdef __APPLE__
+    #define PREFIX(X) "../../../" X
+#else
+    #define PREFIX(X) X
+#endif
+
+class AnimationFrameBufferTest: public QObject
+{
+    Q_OBJECT
+
+    QString makeAbsolutePath(const QString &file) const;
+    std::vector<QImage> readFrames() const;
+    static constexpr const char *animatedNumbersFilePath = PREFIX("animated_numbers.webp");
+    static constexpr int m_frameCount {3};
+    static constexpr int m_frameDelay {200};
+
+    const QString m_absolutePath {QCoreApplication::applicationDirPath()};
+
+private slots:
+    void open() const;
+    void keepsAllFrames() const;
+    void streamsFrames() const;
+};
@@ -0,0 +1,143 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+
+#include "ImageCacheTest.h"
+#include "../ImageCache.h"
+
+namespace
+{
+    QImage createImage(const QRgb color)
+    {
+        QImage image {10, 10, QImage::Format_ARGB32};
+        image.fill(color);
+        return image;
+    }
+
+    const qsizetype imageSize {createImage(0).sizeInBytes()};
+}
+
+void ImageCacheTest::insertAndFind() const
+{
+    ImageCache cache;
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(cache.size(), 0);
+    QCOMPARE(cache.find("a"), QImage{});
+
+    const QImage image {createImage(qRgb(1, 2, 3))};
+    cache.insert("a", image);
+    QCOMPARE(cache.contains("a"), true);
+    QCOMPARE(cache.contains("b"), false);
+    QCOMPARE(cache.find("a"), image);
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.size(), imageSize);
+
+    // Re-inserting the same key replaces the image
+    const QImage anotherImage {createImage(qRgb(4, 5, 6))};
+    cache.insert("a", anotherImage);
+    QCOMPARE(cache.find("a"), anotherImage);
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.size(), imageSize);
+
+    // Null images and empty keys are ignored
+    cache.insert("b", QImage{});
+    cache.insert("", image);
+    QCOMPARE(cache.count(), 1);
+
+    cache.remove("a");
+    QCOMPARE(cache.contains("a"), false);
+    QCOMPARE(cache.size(), 0);
+
+    cache.insert("a", image);
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(cache.size(), 0);
+}
+
+void ImageCacheTest::eviction() const
+{
+    ImageCache cache {imageSize * 2};
+    cache.insert("a", createImage(qRgb(1, 1, 1)));
+    cache.insert("b", createImage(qRgb(2, 2, 2)));
+    cache.insert("c", createImage(qRgb(3, 3, 3)));
+
+    QCOMPARE(cache.count(), 2);
+    QCOMPARE(cache.size(), imageSize * 2);
+    QCOMPARE(cache.contains("a"), false);
+    QCOMPARE(cache.contains("b"), true);
+    QCOMPARE(cache.contains("c"), true);
+}
+
+void ImageCacheTest::leastRecentlyUsed() const
+{
+    ImageCache cache {imageSize * 2};
+    cache.insert("a", createImage(qRgb(1, 1, 1)));
+    cache.insert("b", createImage(qRgb(2, 2, 2)));
+
+    // Touching the oldest entry makes the other one the eviction candidate
+    QCOMPARE(cache.find("a").isNull(), false);
+    cache.insert("c", createImage(qRgb(3, 3, 3)));
+
+    QCOMPARE(cache.contains("a"), true);
+    QCOMPARE(cache.contains("b"), false);
+    QCOMPARE(cache.contains("c"), true);
+}
+
+void ImageCacheTest::tooLargeImage() const
+{
+    ImageCache cache {imageSize};
+    cache.insert("a", createImage(qRgb(1, 1, 1)));
+
+    QImage largeImage {100, 100, QImage::Format_ARGB32};
+    largeImage.fill(Qt::red);
+    cache.insert("b", largeImage);
+
+    QCOMPARE(cache.contains("a"), true);
+    QCOMPARE(cache.contains("b"), false);
+}
+
+void ImageCacheTest::maxSize() const
+{
+    ImageCache cache {imageSize * 3};
+    QCOMPARE(cache.maxSize(), imageSize * 3);
+
+    cache.insert("a", createImage(qRgb(1, 1, 1)));
+    cache.insert("b", createImage(qRgb(2, 2, 2)));
+    cache.insert("c", createImage(qRgb(3, 3, 3)));
+    QCOMPARE(cache.count(), 3);
+
+    cache.setMaxSize(imageSize);
+    QCOMPARE(cache.maxSize(), imageSize);
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.contains("c"), true);
+}
+
+void ImageCacheTest::imageKey() const
+{
+    const QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString fileName {directory.filePath("a.png")};
+    QVERIFY(createImage(qRgb(1, 2, 3)).save(fileName));
+
+    const QString fullKey {ImageCache::imageKey(fileName, {})};
+    QCOMPARE(ImageCache::imageKey(fileName, {}), fullKey);
+    // The reduced resolution does not replace the full one
+    QVERIFY(ImageCache::imageKey(fileName, {100, 100}) != fullKey);
+
+    // The modified file is not served from the cache
+    QFile file {fileName};
+    QVERIFY(file.open(QIODevice::Append));
+    QVERIFY(file.write("modified") > 0);
+    file.close();
+    QVERIFY(ImageCache::imageKey(fileName, {}) != fullKey);
+}
@@ -9,6 +9,7 @@ VookiImageViewer - a tool for showing images.
 ****************************************************************************/
 
 #include <QTransform>
+#include <qcorotask.h>
 
 #include "ImageLoaderTest.h"
 #include "../ImageLoader.h"
@@ -58,3 +59,60 @@ void ImageLoaderTest::getImageAnimated() const
     QCOMPARE(loader.nextImageDelay(), expectedDelay);
     QCOMPARE(loader.getNextImage(), expectedImage1);
 }
+
+void ImageLoaderTest::getImageAsync() const
+{
+    ImageLoader loader;
+    QCOMPARE(loader.loadImage(makeAbsolutePath(ImageLoaderTest::png1FilePath)), true);
+
+    QImageReader reader(makeAbsolutePath(ImageLoaderTest::png1FilePath));
+    const QImage expectedImage(reader.read());
+    QCOMPARE(QCoro::waitFor(loader.getImageAsync()), expectedImage);
+
+    // Decoded image is kept, so the synchronous call does not decode it again
+    QCOMPARE(loader.getImage(), expectedImage);
+}
+
+void ImageLoaderTest::getImageAsyncCancelled() const
+{
+    ImageLoader loader;
+    QCOMPARE(loader.loadImage(makeAbsolutePath(ImageLoaderTest::png1FilePath)), true);
+
+    auto task {loader.getImageAsync()};
+    loader.cancel();
+    QCOMPARE(QCoro::waitFor(task), QImage{});
+
+    // Loading another image cancels the pending request too
+    auto anotherTask {loader.getImageAsync()};
+    QCOMPARE(loader.loadImage(makeAbsolutePath(ImageLoaderTest::animatedNumbersFilePath)), true);
+    QCOMPARE(QCoro::waitFor(anotherTask), QImage{});
+}
+
+void ImageLoaderTest::scaledSizeHint() const
+{
+    QImageReader reader(makeAbsolutePath(ImageLoaderTest::png1FilePath));
+    const QImage expectedImage(reader.read());
+
+    ImageLoader loader;
+    // Area larger than the image does not reduce anything
+    loader.setScaledSizeHint({1000, 10});
+    QCOMPARE(loader.loadImage(makeAbsolutePath(ImageLoaderTest::png1FilePath)), true);
+    QCOMPARE(loader.getOriginalSize(), expectedImage.size());
+    QCOMPARE(loader.getImage(), expectedImage);
+
+    // The longer image side is reduced to the longer area side, if the plugin supports it
+    loader.setScaledSizeHint({10, 16});
+    QCOMPARE(loader.loadImage(makeAbsolutePath(ImageLoaderTest::png1FilePath)), true);
+    QCOMPARE(loader.getOriginalSize(), expectedImage.size());
+    const QSize expectedSize {reader.supportsOption(QImageIOHandler::ScaledSize) ? QSize(16, 16) : expectedImage.size()};
+    QCOMPARE(loader.getImage().size(), expectedSize);
+    QCOMPARE(QCoro::waitFor(loader.getImageAsync()).size(), expectedSize);
+
+    // Animations are never reduced
+    QCOMPARE(loader.loadImage(makeAbsolutePath(ImageLoaderTest::animatedNumbersFilePath)), true);
+    QCOMPARE(loader.getImage().size(), loader.getOriginalSize());
+
+    loader.setScaledSizeHint({});
+    QCOMPARE(loader.loadImage(makeAbsolutePath(ImageLoaderTest::png1FilePath)), true);
+    QCOMPARE(loader.getImage(), expectedImage);
+}
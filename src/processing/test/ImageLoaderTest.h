@@ -31,4 +31,7 @@ private slots:
     void open() const;
     void getImageNotAnimated() const;
     void getImageAnimated() const;
+    void getImageAsync() const;
+    void getImageAsyncCancelled() const;
+    void scaledSizeHint() const;
 };
@@ -0,0 +1,77 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QRect>
+
+#include "ImageProcessorTest.h"
+#include "../ImageProcessor.h"
+
+namespace
+{
+    QImage createFrame()
+    {
+        QImage frame {20, 20, QImage::Format_ARGB32_Premultiplied};
+        for (int y = 0; y < frame.height(); ++y)
+            for (int x = 0; x < frame.width(); ++x)
+                frame.setPixel(x, y, qRgb(x * 12, y * 12, (x * y) % 256));
+        return frame;
+    }
+
+    /// Upscaled, so a source pixel covers several destination ones.
+    void prepare(ImageProcessor &processor, const QImage &frame)
+    {
+        processor.setAreaSize({100, 100});
+        processor.setFitToArea(false);
+        processor.setScaleFactor(2.5);
+        processor.bind(frame, true);
+        processor.prepare();
+    }
+}
+
+void ImageProcessorTest::partialFrame() const
+{
+    const QImage first {createFrame()};
+    QImage second {first};
+    const QRect changedRect {8, 8, 3, 3};
+    for (int y = changedRect.top(); y <= changedRect.bottom(); ++y)
+        for (int x = changedRect.left(); x <= changedRect.right(); ++x)
+            second.setPixel(x, y, qRgb(255, 255, 255));
+
+    // The whole frame is painted by both, just the second one is painted partially afterwards.
+    ImageProcessor full;
+    prepare(full, first);
+    QVERIFY(full.bindFrame(first));
+    QVERIFY(full.bindFrame(second));
+
+    ImageProcessor partial;
+    prepare(partial, first);
+    QVERIFY(partial.bindFrame(first));
+    QVERIFY(partial.bindFrame(second, changedRect));
+
+    // The smoothly sampled neighbourhood of the changed pixels is painted again too, nothing stale is left.
+    QCOMPARE(partial.process(), full.process());
+}
+
+void ImageProcessorTest::changedTransformation() const
+{
+    const QImage frame {createFrame()};
+    ImageProcessor processor;
+    prepare(processor, frame);
+    QVERIFY(processor.bindFrame(frame));
+
+    // The transformation of the previous frame cannot be reused
+    processor.rotateLeft();
+    QVERIFY(!processor.bindFrame(frame));
+
+    // Neither for another frame size
+    processor.prepare();
+    QVERIFY(!processor.bindFrame(frame.scaled(10, 10)));
+}
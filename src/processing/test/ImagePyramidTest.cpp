@@ -0,0 +1,89 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+
+#include "ImagePyramidTest.h"
+#include "../ImagePyramid.h"
+
+void ImagePyramidTest::nullImage() const
+{
+    ImagePyramid pyramid;
+    QCOMPARE(pyramid.maxLevel(), 0);
+    QCOMPARE(pyramid.level(0), QImage{});
+
+    pyramid.bind(QImage{});
+    QCOMPARE(pyramid.maxLevel(), 0);
+    QCOMPARE(pyramid.level(0), QImage{});
+    QCOMPARE(pyramid.levelForScaleFactor(0.1), 0);
+}
+
+void ImagePyramidTest::levels() const
+{
+    QImage image {100, 40, QImage::Format_RGB32};
+    image.fill(Qt::red);
+
+    ImagePyramid pyramid;
+    pyramid.bind(image);
+
+    // 40 -> 20 -> 10 -> 5 -> 2 -> 1
+    QCOMPARE(pyramid.maxLevel(), 5);
+    QCOMPARE(pyramid.level(0), image);
+    QCOMPARE(pyramid.level(1).size(), QSize(50, 20));
+    QCOMPARE(pyramid.level(2).size(), QSize(25, 10));
+    QCOMPARE(pyramid.level(5).size(), QSize(3, 1));
+    QCOMPARE(pyramid.level(6), QImage{});
+    QCOMPARE(pyramid.level(-1), QImage{});
+
+    pyramid.clear();
+    QCOMPARE(pyramid.maxLevel(), 0);
+    QCOMPARE(pyramid.level(0), QImage{});
+}
+
+void ImagePyramidTest::levelForScaleFactor() const
+{
+    QImage image {64, 64, QImage::Format_RGB32};
+    image.fill(Qt::red);
+
+    ImagePyramid pyramid;
+    pyramid.bind(image);
+
+    QCOMPARE(pyramid.levelForScaleFactor(2.0), 0);
+    QCOMPARE(pyramid.levelForScaleFactor(1.0), 0);
+    QCOMPARE(pyramid.levelForScaleFactor(0.5), 0);
+    QCOMPARE(pyramid.levelForScaleFactor(0.49), 1);
+    QCOMPARE(pyramid.levelForScaleFactor(0.25), 2);
+    QCOMPARE(pyramid.levelForScaleFactor(0.2), 2);
+    QCOMPARE(pyramid.levelForScaleFactor(0.0001), pyramid.maxLevel());
+    QCOMPARE(pyramid.levelForScaleFactor(0), 0);
+}
+
+void ImagePyramidTest::downsample() const
+{
+    // 2x2 checkerboard averages to the gray
+    QImage image {2, 2, QImage::Format_RGB32};
+    image.setPixel(0, 0, qRgb(0, 0, 0));
+    image.setPixel(1, 0, qRgb(255, 255, 255));
+    image.setPixel(0, 1, qRgb(255, 255, 255));
+    image.setPixel(1, 1, qRgb(0, 0, 0));
+
+    ImagePyramid pyramid;
+    pyramid.bind(image);
+    QCOMPARE(pyramid.level(1).size(), QSize(1, 1));
+    QCOMPARE(pyramid.level(1).pixel(0, 0), qRgb(128, 128, 128));
+
+    // Fully transparent pixels do not darken the opaque ones
+    QImage transparentImage {2, 2, QImage::Format_ARGB32};
+    transparentImage.fill(Qt::transparent);
+    transparentImage.setPixel(0, 0, qRgba(255, 0, 0, 255));
+    pyramid.bind(transparentImage);
+    QCOMPARE(pyramid.level(1).pixelColor(0, 0).toRgb().red(), 255);
+    QCOMPARE(pyramid.level(1).pixelColor(0, 0).alpha(), 64);
+}
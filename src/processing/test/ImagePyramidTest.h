@@ -0,0 +1,22 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+
+class ImagePyramidTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void nullImage() const;
+    void levels() const;
+    void levelForScaleFactor() const;
+    void downsample() const;
+};
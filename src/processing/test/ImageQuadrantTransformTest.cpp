@@ -0,0 +1,104 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QTransform>
+#include <cmath>
+
+#include "ImageQuadrantTransformTest.h"
+#include "../ImageQuadrantTransform.h"
+
+QImage ImageQuadrantTransformTest::referenceTransformed(const QImage &image, const QTransform &transformation)
+{
+    // Every pixel center is mapped on its own.
+    const QRectF bounds {transformation.mapRect(QRectF{image.rect()})};
+    QImage result {bounds.toAlignedRect().size(), image.format()};
+    result.fill(Qt::transparent);
+
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+        {
+            const QPointF point {transformation.map(QPointF{x + 0.5, y + 0.5}) - bounds.topLeft()};
+            result.setPixel(static_cast<int>(std::floor(point.x())), static_cast<int>(std::floor(point.y())), image.pixel(x, y));
+        }
+
+    return result;
+}
+
+void ImageQuadrantTransformTest::isQuadrant() const
+{
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}), true);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(90)), true);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(180)), true);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(270)), true);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(180, Qt::XAxis)), true);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(180, Qt::YAxis)), true);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.translate(10, 20).rotate(90)), true);
+
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(45)), false);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(90).scale(2, 2)), false);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform::fromScale(1, 0.5)), false);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.shear(1, 0)), false);
+    QCOMPARE(ImageQuadrantTransform::isQuadrant(QTransform{}.rotate(30, Qt::XAxis)), false);
+}
+
+void ImageQuadrantTransformTest::transformed() const
+{
+    // All 8 rotations and flips, the sizes cover both the SIMD blocks, tiles and their remainders.
+    const QTransform transformations[] {QTransform{},
+                                        QTransform{}.rotate(90),
+                                        QTransform{}.rotate(180),
+                                        QTransform{}.rotate(270),
+                                        QTransform::fromScale(-1, 1),
+                                        QTransform::fromScale(1, -1),
+                                        QTransform{}.rotate(90).scale(-1, 1),
+                                        QTransform{}.rotate(90).scale(1, -1)};
+
+    for (const QSize size : {QSize{1, 1}, QSize{3, 5}, QSize{4, 4}, QSize{37, 23}, QSize{130, 71}, QSize{200, 3}})
+    {
+        QImage image {size, QImage::Format_RGB32};
+        for (int y = 0; y < image.height(); ++y)
+            for (int x = 0; x < image.width(); ++x)
+                image.setPixel(x, y, qRgb(x, y, (x + y) % 256));
+
+        for (const auto &transformation : transformations)
+        {
+            QVERIFY(ImageQuadrantTransform::isQuadrant(transformation));
+            QCOMPARE(ImageQuadrantTransform::transformed(image, transformation), referenceTransformed(image, transformation));
+        }
+    }
+
+    QCOMPARE(ImageQuadrantTransform::transformed(QImage{}, QTransform{}.rotate(90)), QImage{});
+}
+
+void ImageQuadrantTransformTest::transformedFormat() const
+{
+    {
+        // 32 bits per pixel formats are kept.
+
+        QImage image {10, 20, QImage::Format_ARGB32};
+        image.fill(qRgba(10, 20, 30, 40));
+        const QImage result {ImageQuadrantTransform::transformed(image, QTransform{}.rotate(90))};
+        QCOMPARE(result.format(), QImage::Format_ARGB32);
+        QCOMPARE(result.size(), QSize(20, 10));
+        QCOMPARE(result.pixel(0, 0), qRgba(10, 20, 30, 40));
+    }
+
+    {
+        // Other formats are converted.
+
+        QImage image {10, 20, QImage::Format_Grayscale8};
+        image.fill(Qt::gray);
+        const QImage result {ImageQuadrantTransform::transformed(image, QTransform{}.rotate(270))};
+        QCOMPARE(result.format(), QImage::Format_RGB32);
+        QCOMPARE(result.size(), QSize(20, 10));
+        QCOMPARE(result.pixel(0, 9), image.pixel(0, 0));
+    }
+}
@@ -0,0 +1,23 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+
+class ImageQuadrantTransformTest: public QObject
+{
+    Q_OBJECT
+
+    [[nodiscard]] static QImage referenceTransformed(const QImage &image, const QTransform &transformation);
+
+private slots:
+    void isQuadrant() const;
+    void transformed() const;
+    void transformedFormat() const;
+};
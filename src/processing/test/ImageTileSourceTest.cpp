@@ -0,0 +1,123 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <cstddef>
+#include <qcorotask.h>
+
+#include "ImageTileSourceTest.h"
+#include "../ImageTileSource.h"
+
+void ImageTileSourceTest::initTestCase()
+{
+    if (!QImageWriter::supportedImageFormats().contains("jpg"))
+        QSKIP("The JPEG plugin is not available");
+
+    QVERIFY(m_directory.isValid());
+    QImage image {m_imageSize, QImage::Format_RGB32};
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+            image.setPixel(x, y, qRgb(x % 256, y % 256, (x + y) % 256));
+
+    m_fileName = m_directory.filePath("tiled.jpg");
+    QVERIFY(image.save(m_fileName, "jpg", 100));
+}
+
+void ImageTileSourceTest::open() const
+{
+    ImageTileSource source;
+    QCOMPARE(source.open("@#$%"), false);
+    QCOMPARE(source.isOpen(), false);
+
+    if (!QImageReader(m_fileName).supportsOption(QImageIOHandler::ClipRect))
+        QSKIP("The JPEG plugin does not support the clip rectangle");
+
+    QCOMPARE(source.open(m_fileName), true);
+    QCOMPARE(source.isOpen(), true);
+    QCOMPARE(source.getFileName(), m_fileName);
+    QCOMPARE(source.getSize(), m_imageSize);
+
+    source.close();
+    QCOMPARE(source.isOpen(), false);
+    QCOMPARE(source.getSize(), QSize());
+}
+
+void ImageTileSourceTest::levelForScaleFactor() const
+{
+    const ImageTileSource source;
+    QCOMPARE(source.levelForScaleFactor(2.0), 0);
+    QCOMPARE(source.levelForScaleFactor(1.0), 0);
+    QCOMPARE(source.levelForScaleFactor(0.6), 0);
+    QCOMPARE(source.levelForScaleFactor(0.5), 1);
+    QCOMPARE(source.levelForScaleFactor(0.3), 1);
+    QCOMPARE(source.levelForScaleFactor(0.25), 2);
+    QCOMPARE(source.levelForScaleFactor(0.01), ImageTileSource::m_maxLevel);
+}
+
+void ImageTileSourceTest::tiles() const
+{
+    ImageTileSource source;
+    if (!source.open(m_fileName))
+        QSKIP("The JPEG plugin does not support the tiled decoding");
+
+    const QRect imageRect {QPoint {}, m_imageSize};
+    QCOMPARE(source.tiles(0, imageRect).size(), std::size_t {9});
+    QCOMPARE(source.tiles(1, imageRect).size(), std::size_t {4});
+    QCOMPARE(source.tiles(0, {600, 600, 10, 10}).size(), std::size_t {1});
+    QCOMPARE(source.tiles(0, {500, 500, 30, 30}).size(), std::size_t {4});
+    QVERIFY(source.tiles(0, {2000, 0, 10, 10}).empty());
+
+    // Tiles are cropped at the image edges
+    QCOMPARE(source.tileRect({0, {1, 0}}), QRect(512, 0, 512, 512));
+    QCOMPARE(source.tileRect({0, {2, 2}}), QRect(1024, 1024, 476, 76));
+    QCOMPARE(source.tileRect({1, {1, 1}}), QRect(1024, 1024, 476, 76));
+}
+
+void ImageTileSourceTest::decode() const
+{
+    ImageTileSource source;
+    if (!source.open(m_fileName))
+        QSKIP("The JPEG plugin does not support the tiled decoding");
+
+    const ImageTileSource::Tile tile {0, {1, 1}};
+    const ImageTileSource::Tile reducedTile {1, {1, 0}};
+    QVERIFY(source.tile(tile).isNull());
+    QCOMPARE(QCoro::waitFor(source.decode({tile, reducedTile})), true);
+
+    QImageReader reader {m_fileName};
+    reader.setClipRect(source.tileRect(tile));
+    QCOMPARE(source.tile(tile), reader.read());
+    // The reduced level has half the resolution
+    QCOMPARE(source.tile(reducedTile).size(), QSize(238, 512));
+
+    // Tiles already decoded are not decoded again
+    QCOMPARE(QCoro::waitFor(source.decode({tile})), false);
+
+    // Tiles belong to the image opened
+    source.close();
+    QVERIFY(source.tile(tile).isNull());
+}
+
+void ImageTileSourceTest::unavailableTile() const
+{
+    // The cache cannot hold even a single tile
+    ImageTileSource source {1};
+    if (!source.open(m_fileName))
+        QSKIP("The JPEG plugin does not support the tiled decoding");
+
+    const ImageTileSource::Tile tile {0, {0, 0}};
+    QCOMPARE(QCoro::waitFor(source.decode({tile})), false);
+    QVERIFY(source.tile(tile).isNull());
+
+    // Not decoded again, the repaint would request it over and over otherwise
+    QCOMPARE(QCoro::waitFor(source.decode({tile})), false);
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class ImageTileSourceTest: public QObject
+{
+    Q_OBJECT
+
+    static constexpr QSize m_imageSize {1500, 1100};
+    QTemporaryDir m_directory {};
+    QString m_fileName {};
+
+private slots:
+    void initTestCase();
+    void open() const;
+    void levelForScaleFactor() const;
+    void tiles() const;
+    void decode() const;
+    void unavailableTile() const;
+};
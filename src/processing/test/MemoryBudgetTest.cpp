@@ -0,0 +1,141 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+
+#include "MemoryBudgetTest.h"
+#include "../ImageCache.h"
+#include "../MemoryBudget.h"
+
+namespace
+{
+    QImage createImage(const QRgb color)
+    {
+        QImage image {10, 10, QImage::Format_ARGB32};
+        image.fill(color);
+        return image;
+    }
+
+    const qsizetype imageSize {createImage(0).sizeInBytes()};
+}
+
+void MemoryBudgetTest::usage() const
+{
+    MemoryBudget budget {1000};
+    QCOMPARE(budget.getBudget(), 1000);
+    QCOMPARE(budget.usage(), 0);
+
+    const int original {budget.registerHolder(MemoryBudget::Category::OriginalImage)};
+    const int processed {budget.registerHolder(MemoryBudget::Category::ProcessedImage)};
+    budget.setUsage(original, 100);
+    budget.setUsage(processed, 200);
+    QCOMPARE(budget.usage(), 300);
+    QCOMPARE(budget.usage(MemoryBudget::Category::OriginalImage), 100);
+    QCOMPARE(budget.usage(MemoryBudget::Category::ProcessedImage), 200);
+    QCOMPARE(budget.usage(MemoryBudget::Category::Cache), 0);
+
+    // The latest report replaces the previous one
+    budget.setUsage(original, 50);
+    QCOMPARE(budget.usage(), 250);
+
+    budget.unregisterHolder(processed);
+    QCOMPARE(budget.usage(), 50);
+
+    // Unknown holders are ignored
+    budget.setUsage(processed, 500);
+    QCOMPARE(budget.usage(), 50);
+}
+
+void MemoryBudgetTest::available() const
+{
+    MemoryBudget budget {1000};
+    const int original {budget.registerHolder(MemoryBudget::Category::OriginalImage)};
+    const int frames {budget.registerHolder(MemoryBudget::Category::AnimationFrames)};
+    const int cache {budget.registerHolder(MemoryBudget::Category::Cache, [](const qsizetype maxSize) { return maxSize; })};
+
+    // The shown image would be replaced and the cache evicted, so neither limits the next image
+    budget.setUsage(original, 400);
+    budget.setUsage(cache, 300);
+    QCOMPARE(budget.available(), 1000);
+
+    budget.setUsage(frames, 300);
+    QCOMPARE(budget.available(), 700);
+
+    budget.setUsage(frames, 2000);
+    QCOMPARE(budget.available(), 0);
+}
+
+void MemoryBudgetTest::cacheEviction() const
+{
+    MemoryBudget budget {3 * imageSize};
+    const int original {budget.registerHolder(MemoryBudget::Category::OriginalImage)};
+
+    ImageCache cache;
+    cache.setMemoryBudget(&budget);
+    cache.insert("a", createImage(qRgb(1, 1, 1)));
+    cache.insert("b", createImage(qRgb(2, 2, 2)));
+    cache.insert("c", createImage(qRgb(3, 3, 3)));
+    QCOMPARE(cache.count(), 3);
+    QCOMPARE(budget.usage(MemoryBudget::Category::Cache), 3 * imageSize);
+
+    // The least recently used image is evicted to make room for the new one
+    cache.insert("d", createImage(qRgb(4, 4, 4)));
+    QCOMPARE(cache.count(), 3);
+    QCOMPARE(cache.contains("a"), false);
+    QCOMPARE(budget.usage(), 3 * imageSize);
+
+    // Holders which cannot be evicted push the caches out
+    budget.setUsage(original, 2 * imageSize);
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.contains("d"), true);
+    QCOMPARE(budget.usage(), 3 * imageSize);
+
+    // Lowering the budget evicts as well
+    budget.setBudget(2 * imageSize);
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(budget.usage(MemoryBudget::Category::Cache), 0);
+
+    // The cache stops reporting once the budget is detached
+    cache.setMemoryBudget(nullptr);
+    budget.setBudget(10 * imageSize);
+    cache.insert("e", createImage(qRgb(5, 5, 5)));
+    QCOMPARE(budget.usage(MemoryBudget::Category::Cache), 0);
+}
+
+void MemoryBudgetTest::decodeStrategy() const
+{
+    constexpr qsizetype pixelBytes {MemoryBudget::m_bytesPerPixel * MemoryBudget::m_copiesPerImage};
+    const MemoryBudget budget {100 * 100 * pixelBytes};
+
+    QVERIFY(budget.decodeStrategy({100, 100}, true, true) == MemoryBudget::DecodeStrategy::Full);
+    QVERIFY(budget.decodeStrategy({101, 100}, true, true) == MemoryBudget::DecodeStrategy::Tiled);
+    QVERIFY(budget.decodeStrategy({101, 100}, true, false) == MemoryBudget::DecodeStrategy::Scaled);
+    // There is no way how to reduce the image
+    QVERIFY(budget.decodeStrategy({101, 100}, false, false) == MemoryBudget::DecodeStrategy::Full);
+    QVERIFY(budget.decodeStrategy({}, true, true) == MemoryBudget::DecodeStrategy::Full);
+}
+
+void MemoryBudgetTest::scaledSize() const
+{
+    constexpr qsizetype pixelBytes {MemoryBudget::m_bytesPerPixel * MemoryBudget::m_copiesPerImage};
+    const MemoryBudget budget {100 * 100 * pixelBytes};
+
+    QCOMPARE(budget.scaledSize({100, 100}), QSize(100, 100));
+    QCOMPARE(budget.scaledSize({50, 20}), QSize(50, 20));
+    QCOMPARE(budget.scaledSize({400, 400}), QSize(100, 100));
+    QCOMPARE(budget.scaledSize({800, 200}), QSize(200, 50));
+}
+
+void MemoryBudgetTest::allocationLimit() const
+{
+    QCOMPARE(MemoryBudget::allocationLimit(4096LL * 1024 * 1024), 4096);
+    QCOMPARE(MemoryBudget::allocationLimit(1), 1);
+    QVERIFY(MemoryBudget::defaultBudget() >= MemoryBudget::m_minBudget);
+}
@@ -0,0 +1,183 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "MetadataCacheTest.h"
+#include "../MetadataCache.h"
+
+namespace
+{
+    MetadataCache::Key createKey(const QString &fileName, const qint64 modificationTime = 1000)
+    {
+        return {fileName, 42, modificationTime};
+    }
+
+    MetadataCache::Metadata createMetadata(const QString &model)
+    {
+        return {{{"Camera model", model}, {"ISO", "100"}}};
+    }
+}
+
+void MetadataCacheTest::insertAndFind() const
+{
+    MetadataCache cache;
+    QCOMPARE(cache.count(), 0);
+    QVERIFY(!cache.find(createKey("/a.jpg")));
+
+    cache.insert(createKey("/a.jpg"), createMetadata("A"));
+    const auto metadata {cache.find(createKey("/a.jpg"))};
+    QVERIFY(metadata);
+    QVERIFY(metadata->information == createMetadata("A").information);
+    QCOMPARE(cache.count(), 1);
+
+    // Re-inserting the same file replaces the metadata
+    cache.insert(createKey("/a.jpg"), createMetadata("B"));
+    QVERIFY(cache.find(createKey("/a.jpg"))->information == createMetadata("B").information);
+    QCOMPARE(cache.count(), 1);
+
+    // Without any directory, nothing is stored
+    QVERIFY(cache.storePath("/a.jpg").isEmpty());
+    QVERIFY(!cache.findStored(createKey("/a.jpg")));
+
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+}
+
+void MetadataCacheTest::modifiedFile() const
+{
+    MetadataCache cache;
+    cache.insert(createKey("/a.jpg"), createMetadata("A"));
+
+    QVERIFY(!cache.find(createKey("/a.jpg", 2000)));
+    // The outdated entry is dropped
+    QCOMPARE(cache.count(), 0);
+
+    cache.insert(createKey("/a.jpg"), createMetadata("A"));
+    QVERIFY(!cache.find({"/a.jpg", 43, 1000}));
+}
+
+void MetadataCacheTest::leastRecentlyUsed() const
+{
+    MetadataCache cache {2};
+    QCOMPARE(cache.maxCount(), 2);
+
+    cache.insert(createKey("/a.jpg"), createMetadata("A"));
+    cache.insert(createKey("/b.jpg"), createMetadata("B"));
+    QVERIFY(cache.find(createKey("/a.jpg")));
+
+    // The least recently used one goes away
+    cache.insert(createKey("/c.jpg"), createMetadata("C"));
+    QCOMPARE(cache.count(), 2);
+    QVERIFY(cache.find(createKey("/a.jpg")));
+    QVERIFY(!cache.find(createKey("/b.jpg")));
+    QVERIFY(cache.find(createKey("/c.jpg")));
+}
+
+void MetadataCacheTest::persistentStore() const
+{
+    const QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    {
+        MetadataCache cache;
+        cache.setDirectory(directory.path());
+        cache.insert(createKey("/a.jpg"), createMetadata("A"));
+        QVERIFY(QFile::exists(cache.storePath("/a.jpg")));
+    }
+
+    MetadataCache cache;
+    cache.setDirectory(directory.path());
+    QVERIFY(!cache.find(createKey("/a.jpg")));
+
+    const auto metadata {cache.findStored(createKey("/a.jpg"))};
+    QVERIFY(metadata);
+    QVERIFY(metadata->information == createMetadata("A").information);
+    // Kept in the memory since then
+    QVERIFY(cache.find(createKey("/a.jpg")));
+
+    // The stored entry of the modified file is not used
+    QVERIFY(!cache.findStored(createKey("/a.jpg", 2000)));
+
+    // Neither the corrupted one
+    QFile file {cache.storePath("/a.jpg")};
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QVERIFY(file.write("corrupted") > 0);
+    file.close();
+    QVERIFY(!cache.findStored(createKey("/a.jpg")));
+}
+
+void MetadataCacheTest::prune() const
+{
+    const QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    MetadataCache cache;
+    cache.setDirectory(directory.path());
+    cache.setMaxStoredCount(2);
+    const QStringList fileNames {"/a.jpg", "/b.jpg", "/c.jpg", "/d.jpg"};
+    const QDateTime now {QDateTime::currentDateTimeUtc()};
+    for (qsizetype i = 0; i < fileNames.size(); ++i)
+    {
+        cache.insert(createKey(fileNames.at(i)), createMetadata("A"));
+        QFile file {cache.storePath(fileNames.at(i))};
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        // The later ones are used more recently, the first one is not used for too long
+        const QDateTime used {i == 0 ? now.addDays(-MetadataCache::m_maxStoredAge - 1) : now.addSecs(-60 * (fileNames.size() - i))};
+        QVERIFY(file.setFileTime(used, QFileDevice::FileModificationTime));
+    }
+
+    cache.prune();
+    QVERIFY(!QFile::exists(cache.storePath("/a.jpg")));
+    QVERIFY(!QFile::exists(cache.storePath("/b.jpg")));
+    QVERIFY(QFile::exists(cache.storePath("/c.jpg")));
+    QVERIFY(QFile::exists(cache.storePath("/d.jpg")));
+
+    // The old one goes away even within the count
+    cache.setMaxStoredCount(MetadataCache::m_defaultMaxStoredCount);
+    QFile file {cache.storePath("/d.jpg")};
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(now.addDays(-MetadataCache::m_maxStoredAge - 1), QFileDevice::FileModificationTime));
+    file.close();
+    cache.prune();
+    QVERIFY(QFile::exists(cache.storePath("/c.jpg")));
+    QVERIFY(!QFile::exists(cache.storePath("/d.jpg")));
+
+    // Loading marks the entry as used
+    QVERIFY(cache.findStored(createKey("/c.jpg")));
+    QVERIFY(QFileInfo(cache.storePath("/c.jpg")).lastModified() > now.addSecs(-10));
+}
+
+void MetadataCacheTest::language() const
+{
+    const QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    MetadataCache cache;
+    cache.setDirectory(directory.path());
+    cache.setLanguage("en_US");
+    cache.insert(createKey("/a.jpg"), createMetadata("A"));
+    const QString englishPath {cache.storePath("/a.jpg")};
+
+    // The same language keeps the entries
+    cache.setLanguage("en_US");
+    QCOMPARE(cache.count(), 1);
+
+    cache.setLanguage("cs_CZ");
+    QCOMPARE(cache.count(), 0);
+    QVERIFY(cache.storePath("/a.jpg") != englishPath);
+    QVERIFY(!cache.findStored(createKey("/a.jpg")));
+
+    cache.setLanguage("en_US");
+    QVERIFY(cache.findStored(createKey("/a.jpg")));
+}
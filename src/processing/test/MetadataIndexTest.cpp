@@ -0,0 +1,193 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QSignalSpy>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "MetadataIndexTest.h"
+#include "../MetadataIndex.h"
+#include "../MetadataIndexer.h"
+
+namespace
+{
+    MetadataIndex createIndex()
+    {
+        MetadataIndex index;
+        index.append({"c.jpg", 3000, 400, 2.8F, 0.01F, 35.0F, 50.1, 14.4, "Nikon D700", "50mm", 2048, 5000});
+        index.append({"a.jpg", 1000, 100, 8.0F, 0.5F, 24.0F, MetadataIndex::m_unknownDouble, MetadataIndex::m_unknownDouble, "Canon EOS R5", ""});
+        // Without any metadata at all
+        index.append({"b.png"});
+        index.append({"d.jpg", 2000, 1600, 4.0F, 0.002F, 85.0F, -33.9, 151.2, "Nikon D700", "85mm"});
+        return index;
+    }
+
+    QStringList names(const MetadataIndex &index, const std::vector<quint32> &positions)
+    {
+        QStringList result;
+        for (const quint32 position : positions)
+            result.append(index.at(position).fileName);
+        return result;
+    }
+}
+
+void MetadataIndexTest::appendAndAt() const
+{
+    const MetadataIndex index {createIndex()};
+    QCOMPARE(index.size(), 4);
+    QCOMPARE(index.indexOf(u"d.jpg"), 3);
+    QCOMPARE(index.indexOf(u"missing.jpg"), -1);
+
+    const MetadataIndex::Record record {index.at(0)};
+    QCOMPARE(record.fileName, "c.jpg");
+    QCOMPARE(record.captureTime, 3000);
+    QCOMPARE(record.iso, 400U);
+    QCOMPARE(record.fNumber, 2.8F);
+    QCOMPARE(record.camera, "Nikon D700");
+    QCOMPARE(record.lens, "50mm");
+
+    const MetadataIndex::Record unknown {index.at(2)};
+    QCOMPARE(unknown.captureTime, MetadataIndex::m_unknownTime);
+    QVERIFY(std::isnan(unknown.exposureTime));
+    QVERIFY(unknown.camera.isEmpty());
+
+    // Each camera is stored once
+    QCOMPARE(index.getCameras(), QStringList({"Nikon D700", "Canon EOS R5"}));
+
+    const QHash<QString, MetadataIndex::CaptureTime> captureTimes {index.getCaptureTimes()};
+    QCOMPARE(captureTimes.size(), 4);
+    QCOMPARE(captureTimes.value("a.jpg").captureTime, 1000);
+    QCOMPARE(captureTimes.value("b.png").captureTime, MetadataIndex::m_unknownTime);
+    QCOMPARE(captureTimes.value("c.jpg").fileSize, 2048);
+    QCOMPARE(captureTimes.value("c.jpg").modificationTime, 5000);
+}
+
+void MetadataIndexTest::sort() const
+{
+    const MetadataIndex index {createIndex()};
+    using enum MetadataIndex::Column;
+
+    QCOMPARE(names(index, index.sort(FileName)), QStringList({"a.jpg", "b.png", "c.jpg", "d.jpg"}));
+    QCOMPARE(names(index, index.sort(FileName, true)), QStringList({"d.jpg", "c.jpg", "b.png", "a.jpg"}));
+
+    // The unknown values go last in both orders
+    QCOMPARE(names(index, index.sort(CaptureTime)), QStringList({"a.jpg", "d.jpg", "c.jpg", "b.png"}));
+    QCOMPARE(names(index, index.sort(CaptureTime, true)), QStringList({"c.jpg", "d.jpg", "a.jpg", "b.png"}));
+    QCOMPARE(names(index, index.sort(Iso, true)), QStringList({"d.jpg", "c.jpg", "a.jpg", "b.png"}));
+    QCOMPARE(names(index, index.sort(ExposureTime)), QStringList({"d.jpg", "c.jpg", "a.jpg", "b.png"}));
+
+    // The file names decide among the same cameras
+    QCOMPARE(names(index, index.sort(Camera)), QStringList({"a.jpg", "c.jpg", "d.jpg", "b.png"}));
+    QCOMPARE(names(index, index.sort(Lens)), QStringList({"c.jpg", "d.jpg", "a.jpg", "b.png"}));
+}
+
+void MetadataIndexTest::select() const
+{
+    const MetadataIndex index {createIndex()};
+
+    QCOMPARE(index.select({}).size(), 4U);
+    QCOMPARE(names(index, index.select({.capturedFrom = 1500})), QStringList({"c.jpg", "d.jpg"}));
+    QCOMPARE(names(index, index.select({.capturedFrom = 1000, .capturedTo = 2000})), QStringList({"a.jpg", "d.jpg"}));
+    QCOMPARE(names(index, index.select({.minIso = 200, .maxIso = 800})), QStringList({"c.jpg"}));
+    QCOMPARE(names(index, index.select({.camera = "Nikon D700"})), QStringList({"c.jpg", "d.jpg"}));
+    QCOMPARE(names(index, index.select({.hasLocation = true})), QStringList({"c.jpg", "d.jpg"}));
+    QCOMPARE(names(index, index.select({.capturedTo = 2500, .camera = "Nikon D700", .hasLocation = true})), QStringList({"d.jpg"}));
+    QVERIFY(index.select({.camera = "Unknown camera"}).empty());
+}
+
+void MetadataIndexTest::storeAndLoad() const
+{
+    const QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    const MetadataIndex index {createIndex()};
+    const QString path {MetadataIndex::indexPath(directory.path(), "/photos")};
+    QVERIFY(path != MetadataIndex::indexPath(directory.path(), "/other"));
+    QVERIFY(index.store(path));
+
+    const auto loaded {MetadataIndex::load(path)};
+    QVERIFY(loaded);
+    QCOMPARE(loaded->size(), index.size());
+    for (qsizetype position = 0; position < index.size(); ++position)
+    {
+        const MetadataIndex::Record expected {index.at(position)};
+        const MetadataIndex::Record record {loaded->at(position)};
+        QCOMPARE(record.fileName, expected.fileName);
+        QCOMPARE(record.captureTime, expected.captureTime);
+        QCOMPARE(record.iso, expected.iso);
+        QCOMPARE(record.camera, expected.camera);
+        QCOMPARE(record.lens, expected.lens);
+        QCOMPARE(record.fileSize, expected.fileSize);
+        QCOMPARE(record.modificationTime, expected.modificationTime);
+        QCOMPARE(std::isnan(record.latitude), std::isnan(expected.latitude));
+    }
+    QCOMPARE(names(*loaded, loaded->select({.camera = "Nikon D700"})), QStringList({"c.jpg", "d.jpg"}));
+
+    // Truncated files are refused
+    QFile file {path};
+    QVERIFY(file.resize(file.size() / 2));
+    QVERIFY(!MetadataIndex::load(path));
+    QVERIFY(!MetadataIndex::load(directory.filePath("missing.midx")));
+
+    // So are the counts the file could not hold, before anything is allocated
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(2 * sizeof(quint32)));
+    QDataStream stream {&file};
+    stream << std::numeric_limits<quint64>::max() / 2;
+    file.close();
+    QVERIFY(!MetadataIndex::load(path));
+}
+
+void MetadataIndexTest::indexer() const
+{
+    QStringList fileNames;
+    for (int i = 0; i < 1000; ++i)
+        fileNames.append(QString("image%1.jpg").arg(i, 4, 10, QChar('0')));
+
+    // The capture time is derived from the path, so the order of the records is checked.
+    MetadataIndexer indexer {[](const QString &filePath) {
+        MetadataIndex::Record record;
+        record.captureTime = filePath.mid(filePath.size() - 8, 4).toLongLong();
+        record.camera = filePath.startsWith("/photos/") ? "Camera" : "Unknown";
+        return record;
+    }};
+    indexer.setMaxThreadCount(4);
+    QCOMPARE(indexer.getMaxThreadCount(), 4);
+
+    QSignalSpy finishedSpy {&indexer, &MetadataIndexer::finished};
+    indexer.start("/photos", fileNames);
+    QVERIFY(indexer.isRunning());
+    QVERIFY(finishedSpy.wait());
+    QVERIFY(!indexer.isRunning());
+
+    const MetadataIndex &index {indexer.getIndex()};
+    QCOMPARE(index.size(), fileNames.size());
+    QCOMPARE(indexer.getDirectory(), "/photos");
+    for (qsizetype position = 0; position < index.size(); ++position)
+    {
+        QCOMPARE(index.at(position).fileName, fileNames.at(position));
+        QCOMPARE(index.at(position).captureTime, position);
+    }
+    QCOMPARE(index.getCameras(), QStringList({"Camera"}));
+    QCOMPARE(indexer.getStatistics().fileCount, fileNames.size());
+    QVERIFY(indexer.getStatistics().filesPerSecond() >= 0.0);
+
+    // The cancelled indexing does not finish
+    indexer.start("/photos", fileNames);
+    indexer.cancel();
+    QVERIFY(!indexer.isRunning());
+    QVERIFY(!finishedSpy.wait(200));
+}
@@ -0,0 +1,23 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+
+class MetadataIndexTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void appendAndAt() const;
+    void sort() const;
+    void select() const;
+    void storeAndLoad() const;
+    void indexer() const;
+};
@@ -0,0 +1,113 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <algorithm>
+#include <qcorotask.h>
+
+#include "ThumbnailCacheTest.h"
+#include "../ThumbnailCache.h"
+
+void ThumbnailCacheTest::initTestCase()
+{
+    QVERIFY(m_directory.isValid());
+    QImage image {m_imageSize, QImage::Format_RGB32};
+    image.fill(Qt::darkCyan);
+    m_fileName = m_directory.filePath("image.png");
+    QVERIFY(image.save(m_fileName, "PNG"));
+}
+
+void ThumbnailCacheTest::thumbnailPath() const
+{
+#ifdef Q_OS_WIN
+    QSKIP("The example of the specification is a Unix path");
+#endif
+
+    // The example of the freedesktop.org thumbnail managing standard
+    const ThumbnailCache cache {"/cache/thumbnails"};
+    QCOMPARE(ThumbnailCache::uri("/home/jens/photos/me.png"), "file:///home/jens/photos/me.png");
+    QCOMPARE(cache.thumbnailPath("/home/jens/photos/me.png", ThumbnailCache::Size::Normal), "/cache/thumbnails/normal/c6ee772d9e49320e97ec29a7eb5b1697.png");
+    QCOMPARE(cache.thumbnailPath("/home/jens/photos/me.png", ThumbnailCache::Size::Large), "/cache/thumbnails/large/c6ee772d9e49320e97ec29a7eb5b1697.png");
+}
+
+void ThumbnailCacheTest::create() const
+{
+    const QTemporaryDir cacheDirectory;
+    const ThumbnailCache cache {cacheDirectory.path()};
+    QCOMPARE(cache.find(m_fileName, ThumbnailCache::Size::Normal), QImage());
+
+    const QImage thumbnail {cache.create(m_fileName, ThumbnailCache::Size::Normal)};
+    QCOMPARE(std::max(thumbnail.width(), thumbnail.height()), ThumbnailCache::pixelSize(ThumbnailCache::Size::Normal));
+    QVERIFY(QFile::exists(cache.thumbnailPath(m_fileName, ThumbnailCache::Size::Normal)));
+    // Other sizes are independent
+    QVERIFY(!QFile::exists(cache.thumbnailPath(m_fileName, ThumbnailCache::Size::Large)));
+
+    const QImage stored {cache.find(m_fileName, ThumbnailCache::Size::Normal)};
+    QCOMPARE(stored.size(), thumbnail.size());
+    QCOMPARE(stored.text("Thumb::URI"), ThumbnailCache::uri(m_fileName));
+    QCOMPARE(stored.text("Thumb::MTime"), QString::number(QFileInfo(m_fileName).lastModified().toSecsSinceEpoch()));
+    QCOMPARE(stored.text("Thumb::Image::Width"), QString::number(m_imageSize.width()));
+    QCOMPARE(stored.text("Thumb::Image::Height"), QString::number(m_imageSize.height()));
+
+    // The thumbnails themselves are never thumbnailed
+    QCOMPARE(cache.create(cache.thumbnailPath(m_fileName, ThumbnailCache::Size::Normal), ThumbnailCache::Size::Normal), QImage());
+}
+
+void ThumbnailCacheTest::invalidate() const
+{
+    const QTemporaryDir cacheDirectory;
+    const ThumbnailCache cache {cacheDirectory.path()};
+    const QString fileName {m_directory.filePath("modified.png")};
+    QVERIFY(QFile::copy(m_fileName, fileName));
+
+    QVERIFY(!cache.create(fileName, ThumbnailCache::Size::Large).isNull());
+    QVERIFY(!cache.find(fileName, ThumbnailCache::Size::Large).isNull());
+
+    // The modification within the same second is recognized by the size
+    QFile file {fileName};
+    QVERIFY(file.open(QIODevice::Append));
+    QVERIFY(file.write("modified") > 0);
+    file.close();
+    QCOMPARE(cache.find(fileName, ThumbnailCache::Size::Large), QImage());
+
+    QVERIFY(QFile::remove(fileName));
+    QCOMPARE(cache.find(fileName, ThumbnailCache::Size::Large), QImage());
+}
+
+void ThumbnailCacheTest::failure() const
+{
+    const QTemporaryDir cacheDirectory;
+    const ThumbnailCache cache {cacheDirectory.path()};
+    const QString fileName {m_directory.filePath("broken.png")};
+    QFile file {fileName};
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write("this is not an image") > 0);
+    file.close();
+
+    QCOMPARE(cache.hasFailed(fileName), false);
+    QCOMPARE(cache.create(fileName, ThumbnailCache::Size::Normal), QImage());
+    QCOMPARE(cache.hasFailed(fileName), true);
+    QVERIFY(!QFile::exists(cache.thumbnailPath(fileName, ThumbnailCache::Size::Normal)));
+}
+
+void ThumbnailCacheTest::thumbnail() const
+{
+    const QTemporaryDir cacheDirectory;
+    ThumbnailCache cache {cacheDirectory.path()};
+
+    const QImage thumbnail {QCoro::waitFor(cache.thumbnail(m_fileName, ThumbnailCache::Size::Large))};
+    QCOMPARE(std::max(thumbnail.width(), thumbnail.height()), ThumbnailCache::pixelSize(ThumbnailCache::Size::Large));
+    // The stored one is returned the next time
+    QCOMPARE(QCoro::waitFor(cache.thumbnail(m_fileName, ThumbnailCache::Size::Large)).size(), thumbnail.size());
+
+    QCOMPARE(QCoro::waitFor(cache.thumbnail(m_directory.filePath("@#$%"), ThumbnailCache::Size::Large)), QImage());
+}
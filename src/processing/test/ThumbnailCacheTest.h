@@ -0,0 +1,29 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class ThumbnailCacheTest: public QObject
+{
+    Q_OBJECT
+
+    static constexpr QSize m_imageSize {600, 400};
+    QTemporaryDir m_directory {};
+    QString m_fileName {};
+
+private slots:
+    void initTestCase();
+    void thumbnailPath() const;
+    void create() const;
+    void invalidate() const;
+    void failure() const;
+    void thumbnail() const;
+};
@@ -8,7 +8,17 @@ VookiImageViewer - a tool for showing images.
 
 ****************************************************************************/
 
+#include "AnimationFrameBufferTest.h"
+#include "ImageCacheTest.h"
 #include "ImageLoaderTest.h"
+#include "ImageProcessorTest.h"
+#include "ImagePyramidTest.h"
+#include "ImageQuadrantTransformTest.h"
+#include "ImageTileSourceTest.h"
+#include "MemoryBudgetTest.h"
+#include "MetadataCacheTest.h"
+#include "MetadataIndexTest.h"
+#include "ThumbnailCacheTest.h"
 
 #include "../../util/testing.h"
 
@@ -17,7 +27,17 @@ int main(int argc, char *argv[])
 {
     int status = 0;
 
+    TEST::runTests<AnimationFrameBufferTest>(argc, argv, &status);
+    TEST::runTests<ImageCacheTest>(argc, argv, &status);
     TEST::runTests<ImageLoaderTest>(argc, argv, &status);
+    TEST::runTests<ImageProcessorTest>(argc, argv, &status);
+    TEST::runTests<ImagePyramidTest>(argc, argv, &status);
+    TEST::runTests<ImageQuadrantTransformTest>(argc, argv, &status);
+    TEST::runTests<ImageTileSourceTest>(argc, argv, &status);
+    TEST::runTests<MemoryBudgetTest>(argc, argv, &status);
+    TEST::runTests<MetadataCacheTest>(argc, argv, &status);
+    TEST::runTests<MetadataIndexTest>(argc, argv, &status);
+    TEST::runTests<ThumbnailCacheTest>(argc, argv, &status);
 
     return status;
 }
@@ -12,6 +12,8 @@ VookiImageViewer - a tool for showing images.
 #include "ImageTransformationBase.h"
 #include <QColor>
 #include <QPainter>
+#include <QTransform>
+#include <optional>
 
 
 template<typename T> requires std::is_same_v<QImage, T>
@@ -35,12 +37,27 @@ public:
     void addImageOffsetX(int imageOffsetX);
     [[nodiscard]] int getImageOffsetX() const;
     void setImageOffsetX(int imageOffsetX);
+    /// If the source transformation is set, the bound image is rendered through it directly into the area sized canvas.
+    /// Only the visible part of the transformed image is resampled then, so neither memory nor time depends on the zoom level.
+    [[nodiscard]] const std::optional<QTransform> &getSourceTransformation() const;
+    void setSourceTransformation(const std::optional<QTransform> &transformation);
+    /// Paints the bound image at the current scroll offsets directly into the area, only the dirty rectangle is touched.
+    /// Nothing is allocated, so the scrolling does not need any transformation to be recomputed.
+    void paint(QPainter &painter, const QRect &dirtyRect);
+    /// Maps the bound image pixels into the area at the current scroll offsets.
+    [[nodiscard]] QTransform areaTransformation();
 
     static const int borderWidth {3};
     static const auto format {QImage::Format_RGB32};
 
 protected:
-    void checkScrollOffset(const QImage &image);
+    void checkScrollOffset(const QSize &size);
+    void drawBorder(QPainter &painter, const QPoint &imagePosition, const QSize &imageSize) const;
+    [[nodiscard]] QImage transformFull();
+    [[nodiscard]] QImage transformViewport();
+    /// Returns the rectangle the transformed image occupies in the area, the scroll offsets are clamped first.
+    [[nodiscard]] QRect layout();
+    void render(QPainter &painter, const QRect &imageRect) const;
 
 private:
     QSize m_areaSize {};
@@ -49,20 +66,21 @@ private:
     bool m_drawBorder{ false };
     int m_imageOffsetY {0};
     int m_imageOffsetX {0};
+    std::optional<QTransform> m_sourceTransformation {};
 };
 
 template<typename T> requires std::is_same_v<QImage, T>
-void ImageBorder<T>::checkScrollOffset(const QImage &image)
+void ImageBorder<T>::checkScrollOffset(const QSize &size)
 {
-    if (image.height() < m_areaSize.height())
+    if (size.height() < m_areaSize.height())
         m_imageOffsetY = 0;
-    else if (image.height() - m_imageOffsetY < m_areaSize.height())
-        m_imageOffsetY = image.height() - m_areaSize.height();
+    else if (size.height() - m_imageOffsetY < m_areaSize.height())
+        m_imageOffsetY = size.height() - m_areaSize.height();
 
-    if (image.width() < m_areaSize.width())
+    if (size.width() < m_areaSize.width())
         m_imageOffsetX = 0;
-    else if (image.width() - m_imageOffsetX < m_areaSize.width())
-        m_imageOffsetX = image.width() - m_areaSize.width();
+    else if (size.width() - m_imageOffsetX < m_areaSize.width())
+        m_imageOffsetX = size.width() - m_areaSize.width();
 
     if (m_imageOffsetY < 0)
         m_imageOffsetY = 0;
@@ -75,6 +93,7 @@ template<typename T> requires std::is_same_v<QImage, T>
 void ImageBorder<T>::addImageOffsetY(int imageOffsetY)
 {
     m_imageOffsetY += imageOffsetY;
+    ImageTransformationBase<T>::invalidateCache();
 }
 
 template<typename T> requires std::is_same_v<QImage, T>
@@ -87,12 +106,14 @@ template<typename T> requires std::is_same_v<QImage, T>
 void ImageBorder<T>::setImageOffsetY(int imageOffsetY)
 {
     m_imageOffsetY = imageOffsetY;
+    ImageTransformationBase<T>::invalidateCache();
 }
 
 template<typename T> requires std::is_same_v<QImage, T>
 void ImageBorder<T>::addImageOffsetX(int imageOffsetX)
 {
     m_imageOffsetX += imageOffsetX;
+    ImageTransformationBase<T>::invalidateCache();
 }
 
 template<typename T> requires std::is_same_v<QImage, T>
@@ -105,6 +126,20 @@ template<typename T> requires std::is_same_v<QImage, T>
 void ImageBorder<T>::setImageOffsetX(int imageOffsetX)
 {
     m_imageOffsetX = imageOffsetX;
+    ImageTransformationBase<T>::invalidateCache();
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+const std::optional<QTransform> &ImageBorder<T>::getSourceTransformation() const
+{
+    return m_sourceTransformation;
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+void ImageBorder<T>::setSourceTransformation(const std::optional<QTransform> &transformation)
+{
+    m_sourceTransformation = transformation;
+    ImageTransformationBase<T>::invalidateCache();
 }
 
 template<typename T> requires std::is_same_v<QImage, T>
@@ -167,48 +202,136 @@ void ImageBorder<T>::resetProperties()
 }
 
 template<typename T> requires std::is_same_v<QImage, T>
-QVariant ImageBorder<T>::transform()
+void ImageBorder<T>::drawBorder(QPainter &painter, const QPoint &imagePosition, const QSize &imageSize) const
 {
-    if (ImageTransformationBase<T>::isCacheDirty())
+    constexpr int penWidth = 1;
+    QPen pen = painter.pen();
+    pen.setWidth(penWidth);
+    pen.setColor(m_borderColor);
+    pen.setStyle(Qt::SolidLine);
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+
+    const auto& [x, y] = imagePosition;
+    for (int i = 0; i < ImageBorder::borderWidth; ++i)
+    {
+        painter.drawRect(QRect(QPoint{std::max(0, x + i),
+                                      std::max(0, y + i)},
+                               QPoint{imageSize.width() + x - i - penWidth - 1,
+                                      imageSize.height() + y - i - penWidth - 1}));
+    }
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+QImage ImageBorder<T>::transformFull()
+{
+    QImage originalImage {ImageTransformationBase<T>::getOriginalObject()};
+    QSize newSize {originalImage.size().expandedTo(m_areaSize)};
+    QImage newImage {newSize, ImageBorder::format};
+    newImage.fill(m_backgroundColor);
+
+    const auto x {newSize.width() / 2 - originalImage.width() / 2};
+    const auto y {newSize.height() / 2 - originalImage.height() / 2};
+
+    // Update scroll settings
+    checkScrollOffset(newImage.size());
+    QPainter painterImage(&newImage);
+    painterImage.drawImage(x,
+                           y,
+                           originalImage,
+                           m_imageOffsetX,
+                           m_imageOffsetY);
+
+    if (m_drawBorder)
+        drawBorder(painterImage, {x - m_imageOffsetX, y - m_imageOffsetY}, originalImage.size());
+
+    return newImage;
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+QRect ImageBorder<T>::layout()
+{
+    const QImage &originalImage {ImageTransformationBase<T>::getOriginalObject()};
+    const QSize imageSize {m_sourceTransformation ? m_sourceTransformation->mapRect(QRectF{originalImage.rect()}).toAlignedRect().size()
+                                                  : originalImage.size()};
+
+    // The layout is the same as in the full rendering, just the canvas is cropped to the area.
+    const QSize virtualSize {imageSize.expandedTo(m_areaSize)};
+    checkScrollOffset(virtualSize);
+
+    return {QPoint{virtualSize.width() / 2 - imageSize.width() / 2 - m_imageOffsetX,
+                   virtualSize.height() / 2 - imageSize.height() / 2 - m_imageOffsetY},
+            imageSize};
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+void ImageBorder<T>::render(QPainter &painter, const QRect &imageRect) const
+{
+    const QImage &originalImage {ImageTransformationBase<T>::getOriginalObject()};
+
+    if (m_sourceTransformation)
     {
-        QImage originalImage {ImageTransformationBase<T>::getOriginalObject()};
-        QSize newSize {originalImage.size().expandedTo(m_areaSize)};
-        QImage newImage {newSize, ImageBorder::format};
-        newImage.fill(m_backgroundColor);
-
-        const auto x {newSize.width() / 2 - originalImage.width() / 2};
-        const auto y {newSize.height() / 2 - originalImage.height() / 2};
-
-        // Update scroll settings
-        checkScrollOffset(newImage);
-        QPainter painterImage(&newImage);
-        painterImage.drawImage(x,
-                               y,
-                               originalImage,
-                               m_imageOffsetX,
-                               m_imageOffsetY);
-
-        if (m_drawBorder)
-        {
-            constexpr int penWidth = 1;
-            QPen pen = painterImage.pen();
-            pen.setWidth(penWidth);
-            pen.setColor(m_borderColor);
-            pen.setStyle(Qt::SolidLine);
-            painterImage.setPen(pen);
-            painterImage.setBrush(Qt::NoBrush);
-
-            for (int i = 0; i < ImageBorder::borderWidth; ++i)
-            {
-                painterImage.drawRect(QRect(QPoint{std::max(0, x - m_imageOffsetX + i),
-                                                    std::max(0, y - m_imageOffsetY + i)},
-                                            QPoint{originalImage.width() + x - m_imageOffsetX - i - penWidth - 1,
-                                                    originalImage.height() + y - m_imageOffsetY - i - penWidth - 1}));
-            }
-        }
-
-        ImageTransformationBase<T>::setCachedObject(newImage);
+        const QRectF bounds {m_sourceTransformation->mapRect(QRectF{originalImage.rect()})};
+
+        painter.save();
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.setWorldTransform(*m_sourceTransformation * QTransform::fromTranslate(imageRect.x() - bounds.left(), imageRect.y() - bounds.top()), true);
+        painter.drawImage(QPointF{0, 0}, originalImage);
+        painter.restore();
     }
+    else
+        painter.drawImage(imageRect.topLeft(), originalImage);
+
+    if (m_drawBorder)
+        drawBorder(painter, imageRect.topLeft(), imageRect.size());
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+QImage ImageBorder<T>::transformViewport()
+{
+    if (m_areaSize.isEmpty())
+        return {};
+
+    const QRect imageRect {layout()};
+    QImage newImage {m_areaSize, ImageBorder::format};
+    newImage.fill(m_backgroundColor);
+
+    QPainter painterImage(&newImage);
+    render(painterImage, imageRect);
+
+    return newImage;
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+void ImageBorder<T>::paint(QPainter &painter, const QRect &dirtyRect)
+{
+    if (m_areaSize.isEmpty() || ImageTransformationBase<T>::getOriginalObject().isNull())
+        return;
+
+    const QRect imageRect {layout()};
+    painter.save();
+    painter.setClipRect(dirtyRect);
+    painter.fillRect(dirtyRect, m_backgroundColor);
+    render(painter, imageRect);
+    painter.restore();
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+QTransform ImageBorder<T>::areaTransformation()
+{
+    const QRect imageRect {layout()};
+    if (!m_sourceTransformation)
+        return QTransform::fromTranslate(imageRect.x(), imageRect.y());
+
+    const QRectF bounds {m_sourceTransformation->mapRect(QRectF{ImageTransformationBase<T>::getOriginalObject().rect()})};
+    return *m_sourceTransformation * QTransform::fromTranslate(imageRect.x() - bounds.left(), imageRect.y() - bounds.top());
+}
+
+template<typename T> requires std::is_same_v<QImage, T>
+QVariant ImageBorder<T>::transform()
+{
+    if (ImageTransformationBase<T>::isCacheDirty())
+        ImageTransformationBase<T>::setCachedObject(m_sourceTransformation ? transformViewport() : transformFull());
 
     return ImageTransformationBase<T>::getCachedObject();
 }
@@ -0,0 +1,467 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "ImageResampler.h"
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define IMAGE_RESAMPLER_SSE2
+    #if defined(__GNUC__)
+        #include <immintrin.h>
+        #define IMAGE_RESAMPLER_AVX2
+    #endif
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define IMAGE_RESAMPLER_NEON
+#endif
+
+namespace
+{
+    constexpr int precisionBits {ImageResampler::precisionBits};
+    constexpr int rounding {1 << (precisionBits - 1)};
+
+    inline quint32 clampChannel(const int value)
+    {
+        return static_cast<quint32>(std::clamp(value >> precisionBits, 0, 255));
+    }
+
+    /// Resamples the line, the result pixel x is made of the taps source pixels starting at starts[x].
+    void horizontalScalar(const quint32 *const source, quint32 *const result, const int resultWidth, const int *const starts, const qint16 *const weights, const int taps)
+    {
+        for (int x = 0; x < resultWidth; ++x)
+        {
+            const quint32 *const pixels {source + starts[x]};
+            const qint16 *const pixelWeights {weights + static_cast<qsizetype>(x) * taps};
+
+            int channels[4] {rounding, rounding, rounding, rounding};
+            for (int t = 0; t < taps; ++t)
+                for (int c = 0; c < 4; ++c)
+                    channels[c] += static_cast<int>((pixels[t] >> (8 * c)) & 0xff) * pixelWeights[t];
+
+            result[x] = clampChannel(channels[0]) | clampChannel(channels[1]) << 8 | clampChannel(channels[2]) << 16 | clampChannel(channels[3]) << 24;
+        }
+    }
+
+    /// Resamples the columns, the result line is made of the taps source lines starting at the source.
+    void verticalScalar(const uchar *const source, const qsizetype bytesPerLine, const qint16 *const weights, const int taps, quint32 *const result, const int width)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            int channels[4] {rounding, rounding, rounding, rounding};
+            for (int t = 0; t < taps; ++t)
+            {
+                const quint32 pixel {reinterpret_cast<const quint32 *>(source + t * bytesPerLine)[x]};
+                for (int c = 0; c < 4; ++c)
+                    channels[c] += static_cast<int>((pixel >> (8 * c)) & 0xff) * weights[t];
+            }
+
+            result[x] = clampChannel(channels[0]) | clampChannel(channels[1]) << 8 | clampChannel(channels[2]) << 16 | clampChannel(channels[3]) << 24;
+        }
+    }
+
+#if defined(IMAGE_RESAMPLER_SSE2)
+    inline __m128i weightPair(const qint16 first, const qint16 second)
+    {
+        return _mm_set1_epi32(static_cast<int>(static_cast<quint16>(first) | static_cast<quint32>(static_cast<quint16>(second)) << 16));
+    }
+
+    void horizontalSSE2(const quint32 *const source, quint32 *const result, const int resultWidth, const int *const starts, const qint16 *const weights, const int taps)
+    {
+        const __m128i zero {_mm_setzero_si128()};
+        for (int x = 0; x < resultWidth; ++x)
+        {
+            const quint32 *const pixels {source + starts[x]};
+            const qint16 *const pixelWeights {weights + static_cast<qsizetype>(x) * taps};
+
+            __m128i sum {_mm_set1_epi32(rounding)};
+            int t = 0;
+            for (; t + 2 <= taps; t += 2)
+            {
+                // Channels of both pixels are interleaved, so a single multiply-add weights and sums them.
+                const __m128i pair {_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pixels + t)), zero)};
+                const __m128i interleaved {_mm_unpacklo_epi16(pair, _mm_srli_si128(pair, 8))};
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(interleaved, weightPair(pixelWeights[t], pixelWeights[t + 1])));
+            }
+
+            if (t < taps)
+            {
+                const __m128i pixel {_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pixels[t])), zero), zero)};
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(pixel, weightPair(pixelWeights[t], 0)));
+            }
+
+            const __m128i packed {_mm_packs_epi32(_mm_srai_epi32(sum, precisionBits), zero)};
+            result[x] = static_cast<quint32>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, zero)));
+        }
+    }
+
+    void verticalSSE2(const uchar *const source, const qsizetype bytesPerLine, const qint16 *const weights, const int taps, quint32 *const result, const int width)
+    {
+        const __m128i zero {_mm_setzero_si128()};
+        int x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i sums[4] {_mm_set1_epi32(rounding), _mm_set1_epi32(rounding), _mm_set1_epi32(rounding), _mm_set1_epi32(rounding)};
+            for (int t = 0; t < taps; t += 2)
+            {
+                // Channels of two lines are interleaved, so a single multiply-add weights and sums them.
+                const bool hasSecond {t + 1 < taps};
+                const __m128i first {_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + t * bytesPerLine) + x / 4)};
+                const __m128i second {hasSecond ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + (t + 1) * bytesPerLine) + x / 4) : zero};
+                const __m128i weight {weightPair(weights[t], hasSecond ? weights[t + 1] : 0)};
+
+                const __m128i firstLow {_mm_unpacklo_epi8(first, zero)};
+                const __m128i firstHigh {_mm_unpackhi_epi8(first, zero)};
+                const __m128i secondLow {_mm_unpacklo_epi8(second, zero)};
+                const __m128i secondHigh {_mm_unpackhi_epi8(second, zero)};
+
+                sums[0] = _mm_add_epi32(sums[0], _mm_madd_epi16(_mm_unpacklo_epi16(firstLow, secondLow), weight));
+                sums[1] = _mm_add_epi32(sums[1], _mm_madd_epi16(_mm_unpackhi_epi16(firstLow, secondLow), weight));
+                sums[2] = _mm_add_epi32(sums[2], _mm_madd_epi16(_mm_unpacklo_epi16(firstHigh, secondHigh), weight));
+                sums[3] = _mm_add_epi32(sums[3], _mm_madd_epi16(_mm_unpackhi_epi16(firstHigh, secondHigh), weight));
+            }
+
+            const __m128i low {_mm_packs_epi32(_mm_srai_epi32(sums[0], precisionBits), _mm_srai_epi32(sums[1], precisionBits))};
+            const __m128i high {_mm_packs_epi32(_mm_srai_epi32(sums[2], precisionBits), _mm_srai_epi32(sums[3], precisionBits))};
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(result + x), _mm_packus_epi16(low, high));
+        }
+
+        if (x < width)
+            verticalScalar(source + x * 4, bytesPerLine, weights, taps, result + x, width - x);
+    }
+#endif
+
+#if defined(IMAGE_RESAMPLER_AVX2)
+    __attribute__((target("avx2"))) void verticalAVX2(const uchar *const source, const qsizetype bytesPerLine, const qint16 *const weights, const int taps, quint32 *const result, const int width)
+    {
+        const __m256i zero {_mm256_setzero_si256()};
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            // The same as the SSE2 variant, just every 128 bits lane holds its own 4 pixels.
+            __m256i sums[4] {_mm256_set1_epi32(rounding), _mm256_set1_epi32(rounding), _mm256_set1_epi32(rounding), _mm256_set1_epi32(rounding)};
+            for (int t = 0; t < taps; t += 2)
+            {
+                const bool hasSecond {t + 1 < taps};
+                const __m256i first {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + t * bytesPerLine + x * 4))};
+                const __m256i second {hasSecond ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + (t + 1) * bytesPerLine + x * 4)) : zero};
+                const __m256i weight {_mm256_set1_epi32(static_cast<int>(static_cast<quint16>(weights[t]) |
+                                                                         static_cast<quint32>(static_cast<quint16>(hasSecond ? weights[t + 1] : 0)) << 16))};
+
+                const __m256i firstLow {_mm256_unpacklo_epi8(first, zero)};
+                const __m256i firstHigh {_mm256_unpackhi_epi8(first, zero)};
+                const __m256i secondLow {_mm256_unpacklo_epi8(second, zero)};
+                const __m256i secondHigh {_mm256_unpackhi_epi8(second, zero)};
+
+                sums[0] = _mm256_add_epi32(sums[0], _mm256_madd_epi16(_mm256_unpacklo_epi16(firstLow, secondLow), weight));
+                sums[1] = _mm256_add_epi32(sums[1], _mm256_madd_epi16(_mm256_unpackhi_epi16(firstLow, secondLow), weight));
+                sums[2] = _mm256_add_epi32(sums[2], _mm256_madd_epi16(_mm256_unpacklo_epi16(firstHigh, secondHigh), weight));
+                sums[3] = _mm256_add_epi32(sums[3], _mm256_madd_epi16(_mm256_unpackhi_epi16(firstHigh, secondHigh), weight));
+            }
+
+            const __m256i low {_mm256_packs_epi32(_mm256_srai_epi32(sums[0], precisionBits), _mm256_srai_epi32(sums[1], precisionBits))};
+            const __m256i high {_mm256_packs_epi32(_mm256_srai_epi32(sums[2], precisionBits), _mm256_srai_epi32(sums[3], precisionBits))};
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + x), _mm256_packus_epi16(low, high));
+        }
+
+        if (x < width)
+            verticalSSE2(source + x * 4, bytesPerLine, weights, taps, result + x, width - x);
+    }
+#endif
+
+#if defined(IMAGE_RESAMPLER_NEON)
+    void horizontalNEON(const quint32 *const source, quint32 *const result, const int resultWidth, const int *const starts, const qint16 *const weights, const int taps)
+    {
+        for (int x = 0; x < resultWidth; ++x)
+        {
+            const quint32 *const pixels {source + starts[x]};
+            const qint16 *const pixelWeights {weights + static_cast<qsizetype>(x) * taps};
+
+            int32x4_t sum {vdupq_n_s32(rounding)};
+            for (int t = 0; t < taps; ++t)
+            {
+                const int16x4_t pixel {vget_low_s16(vreinterpretq_s16_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(pixels[t])))))};
+                sum = vmlal_n_s16(sum, pixel, pixelWeights[t]);
+            }
+
+            const int16x4_t narrowed {vqmovn_s32(vshrq_n_s32(sum, precisionBits))};
+            result[x] = vget_lane_u32(vreinterpret_u32_u8(vqmovun_s16(vcombine_s16(narrowed, narrowed))), 0);
+        }
+    }
+
+    void verticalNEON(const uchar *const source, const qsizetype bytesPerLine, const qint16 *const weights, const int taps, quint32 *const result, const int width)
+    {
+        int x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            int32x4_t sums[4] {vdupq_n_s32(rounding), vdupq_n_s32(rounding), vdupq_n_s32(rounding), vdupq_n_s32(rounding)};
+            for (int t = 0; t < taps; ++t)
+            {
+                const uint8x16_t pixels {vld1q_u8(source + t * bytesPerLine + x * 4)};
+                const int16x8_t low {vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(pixels)))};
+                const int16x8_t high {vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(pixels)))};
+
+                sums[0] = vmlal_n_s16(sums[0], vget_low_s16(low), weights[t]);
+                sums[1] = vmlal_n_s16(sums[1], vget_high_s16(low), weights[t]);
+                sums[2] = vmlal_n_s16(sums[2], vget_low_s16(high), weights[t]);
+                sums[3] = vmlal_n_s16(sums[3], vget_high_s16(high), weights[t]);
+            }
+
+            const int16x8_t low {vcombine_s16(vqmovn_s32(vshrq_n_s32(sums[0], precisionBits)), vqmovn_s32(vshrq_n_s32(sums[1], precisionBits)))};
+            const int16x8_t high {vcombine_s16(vqmovn_s32(vshrq_n_s32(sums[2], precisionBits)), vqmovn_s32(vshrq_n_s32(sums[3], precisionBits)))};
+            vst1q_u8(reinterpret_cast<uint8_t *>(result + x), vcombine_u8(vqmovun_s16(low), vqmovun_s16(high)));
+        }
+
+        if (x < width)
+            verticalScalar(source + x * 4, bytesPerLine, weights, taps, result + x, width - x);
+    }
+#endif
+
+    using HorizontalKernel = void (*)(const quint32 *, quint32 *, int, const int *, const qint16 *, int);
+    using VerticalKernel = void (*)(const uchar *, qsizetype, const qint16 *, int, quint32 *, int);
+
+    std::pair<HorizontalKernel, VerticalKernel> kernels(const ImageResampler::Instructions instructions)
+    {
+        switch (instructions)
+        {
+#if defined(IMAGE_RESAMPLER_AVX2)
+            case ImageResampler::Instructions::AVX2:
+                // The horizontal pass sums just a few taps per pixel, there is nothing to gain from the wider registers.
+                return {horizontalSSE2, verticalAVX2};
+#endif
+#if defined(IMAGE_RESAMPLER_SSE2)
+            case ImageResampler::Instructions::SSE2:
+                return {horizontalSSE2, verticalSSE2};
+#endif
+#if defined(IMAGE_RESAMPLER_NEON)
+            case ImageResampler::Instructions::NEON:
+                return {horizontalNEON, verticalNEON};
+#endif
+            default:
+                return {horizontalScalar, verticalScalar};
+        }
+    }
+}
+
+template<typename F>
+void ImageResampler::forEachRows(const int rows, F function)
+{
+    const int tasks {std::clamp(rows / m_minRowsPerTask, 1, QThreadPool::globalInstance()->maxThreadCount())};
+    if (tasks == 1)
+    {
+        function(0, rows);
+        return;
+    }
+
+    std::vector<std::pair<int, int>> ranges;
+    for (int task = 0; task < tasks; ++task)
+        ranges.emplace_back(rows * task / tasks, rows * (task + 1) / tasks);
+
+    QtConcurrent::blockingMap(ranges, [&function](const std::pair<int, int> &range) { function(range.first, range.second); });
+}
+
+QImage ImageResampler::resampled(const QImage &image, const QSize &size, const Filter filter)
+{
+    return resampled(image, size, filter, supportedInstructions());
+}
+
+QImage ImageResampler::resampled(const QImage &image, const QSize &size, const Filter filter, const Instructions instructions)
+{
+    if (image.isNull() || size.isEmpty())
+        return {};
+
+    // Weighting of the premultiplied pixels does not bleed colors of the transparent pixels.
+    const bool hasAlphaChannel {image.hasAlphaChannel()};
+    const QImage source {image.convertToFormat(hasAlphaChannel ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32)};
+    if (size == source.size())
+        return source;
+
+    const auto selectedKernels {kernels(instructions == Instructions::AVX2 && supportedInstructions() != Instructions::AVX2 ? Instructions::SSE2 : instructions)};
+    const HorizontalKernel horizontal {selectedKernels.first};
+    const VerticalKernel vertical {selectedKernels.second};
+
+    // Lines are accessed through the raw pointers, QImage::scanLine() must not be called from multiple threads.
+    QImage intermediate {source};
+    if (size.width() != source.width())
+    {
+        const Contributions contributions {ImageResampler::contributions(source.width(), size.width(), filter)};
+        intermediate = QImage {size.width(), source.height(), source.format()};
+        uchar *const bits {intermediate.bits()};
+        const qsizetype bytesPerLine {intermediate.bytesPerLine()};
+
+        forEachRows(source.height(), [&](const int first, const int last) {
+            for (int y = first; y < last; ++y)
+                horizontal(reinterpret_cast<const quint32 *>(source.constScanLine(y)),
+                           reinterpret_cast<quint32 *>(bits + y * bytesPerLine),
+                           size.width(),
+                           contributions.starts.data(),
+                           contributions.weights.data(),
+                           contributions.taps);
+        });
+    }
+
+    QImage result {intermediate};
+    if (size.height() != source.height())
+    {
+        const Contributions contributions {ImageResampler::contributions(source.height(), size.height(), filter)};
+        result = QImage {size, source.format()};
+        uchar *const bits {result.bits()};
+        const qsizetype bytesPerLine {result.bytesPerLine()};
+
+        forEachRows(size.height(), [&](const int first, const int last) {
+            for (int y = first; y < last; ++y)
+                vertical(intermediate.constScanLine(contributions.starts[y]),
+                         intermediate.bytesPerLine(),
+                         contributions.weights.data() + static_cast<qsizetype>(y) * contributions.taps,
+                         contributions.taps,
+                         reinterpret_cast<quint32 *>(bits + y * bytesPerLine),
+                         size.width());
+        });
+    }
+
+    // Negative lobes of the filters may produce colors exceeding the alpha, which is not a valid premultiplied pixel.
+    if (hasAlphaChannel)
+    {
+        uchar *const bits {result.bits()};
+        const qsizetype bytesPerLine {result.bytesPerLine()};
+
+        forEachRows(result.height(), [&](const int first, const int last) {
+            for (int y = first; y < last; ++y)
+            {
+                auto *const line {reinterpret_cast<QRgb *>(bits + y * bytesPerLine)};
+                for (int x = 0; x < result.width(); ++x)
+                {
+                    const int alpha {qAlpha(line[x])};
+                    line[x] = qRgba(std::min(qRed(line[x]), alpha), std::min(qGreen(line[x]), alpha), std::min(qBlue(line[x]), alpha), alpha);
+                }
+            }
+        });
+    }
+
+    result.setColorSpace(source.colorSpace());
+    return result;
+}
+
+ImageResampler::Filter ImageResampler::filterForScaleFactor(const double scaleFactor)
+{
+    if (scaleFactor < 0.5)
+        return Filter::Box;
+
+    return scaleFactor <= 1.0 ? Filter::Lanczos3 : Filter::Bicubic;
+}
+
+ImageResampler::Instructions ImageResampler::supportedInstructions()
+{
+#if defined(IMAGE_RESAMPLER_AVX2)
+    static const Instructions instructions {__builtin_cpu_supports("avx2") ? Instructions::AVX2 : Instructions::SSE2};
+    return instructions;
+#elif defined(IMAGE_RESAMPLER_SSE2)
+    return Instructions::SSE2;
+#elif defined(IMAGE_RESAMPLER_NEON)
+    return Instructions::NEON;
+#else
+    return Instructions::Scalar;
+#endif
+}
+
+ImageResampler::Contributions ImageResampler::contributions(const int sourceSize, const int resultSize, const Filter filter)
+{
+    // Reductions stretch the filter, so all the source pixels are taken into account.
+    const double scale {static_cast<double>(sourceSize) / resultSize};
+    const double filterScale {std::max(scale, 1.0)};
+    const double support {filterSupport(filter) * filterScale};
+
+    Contributions contributions;
+    contributions.taps = std::min(sourceSize, static_cast<int>(std::ceil(support)) * 2 + 1);
+    contributions.starts.resize(resultSize);
+    contributions.weights.assign(static_cast<size_t>(resultSize) * contributions.taps, 0);
+
+    std::vector<double> weights(contributions.taps);
+    for (int i = 0; i < resultSize; ++i)
+    {
+        const double center {(i + 0.5) * scale};
+        const int first {std::max(0, static_cast<int>(center - support + 0.5))};
+        const int last {std::min(sourceSize, static_cast<int>(center + support + 0.5))};
+        const int count {std::min(last - first, contributions.taps)};
+
+        double sum {0};
+        for (int j = 0; j < count; ++j)
+            sum += weights[j] = filterWeight(filter, (first + j - center + 0.5) / filterScale);
+
+        // All the taps have to be inside the source, so the start is shifted and the weights are padded by zeros.
+        const int start {std::min(first, sourceSize - contributions.taps)};
+        qint16 *const fixedWeights {contributions.weights.data() + static_cast<qsizetype>(i) * contributions.taps + (first - start)};
+        contributions.starts[i] = start;
+
+        // The rounding error is added to the largest weight, so the weights always sum up to the 1.0.
+        int fixedSum {0};
+        int largest {0};
+        for (int j = 0; j < count; ++j)
+        {
+            fixedWeights[j] = static_cast<qint16>(std::lround((sum != 0 ? weights[j] / sum : 0) * (1 << precisionBits)));
+            fixedSum += fixedWeights[j];
+            if (fixedWeights[j] > fixedWeights[largest])
+                largest = j;
+        }
+
+        if (count > 0)
+            fixedWeights[largest] = static_cast<qint16>(fixedWeights[largest] + (1 << precisionBits) - fixedSum);
+    }
+
+    return contributions;
+}
+
+double ImageResampler::filterSupport(const Filter filter)
+{
+    switch (filter)
+    {
+        case Filter::Box:
+            return 0.5;
+        case Filter::Bicubic:
+            return 2.0;
+        case Filter::Lanczos3:
+            return 3.0;
+    }
+
+    return 0.5;
+}
+
+double ImageResampler::filterWeight(const Filter filter, const double x)
+{
+    switch (filter)
+    {
+        case Filter::Box:
+            return x > -0.5 && x <= 0.5 ? 1.0 : 0.0;
+        case Filter::Bicubic:
+        {
+            // Keys cubic convolution with a = -0.5
+            constexpr double a {-0.5};
+            const double absX {std::abs(x)};
+            if (absX < 1.0)
+                return ((a + 2.0) * absX - (a + 3.0)) * absX * absX + 1.0;
+            if (absX < 2.0)
+                return (((absX - 5.0) * absX + 8.0) * absX - 4.0) * a;
+            return 0.0;
+        }
+        case Filter::Lanczos3:
+        {
+            const auto sinc = [](const double value) {
+                return value == 0.0 ? 1.0 : std::sin(std::numbers::pi * value) / (std::numbers::pi * value);
+            };
+            return std::abs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+        }
+    }
+
+    return 0.0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QSize>
+#include <vector>
+
+/// Separable resampling of images. Rows and columns are resampled in two passes with the fixed point filter weights,
+/// both passes run in parallel and use SIMD kernels selected at runtime according to the CPU.
+class ImageResampler
+{
+public:
+    enum class Filter {
+        /// Average of all covered pixels, fast and without aliasing for large reductions.
+        Box,
+        /// Sharp enough and without visible ringing, suitable for enlarging.
+        Bicubic,
+        /// The best quality for reductions.
+        Lanczos3
+    };
+
+    enum class Instructions {
+        Scalar,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    ImageResampler() = delete;
+
+    [[nodiscard]] static QImage resampled(const QImage &image, const QSize &size, Filter filter);
+    /// The instruction set is given explicitly, an unsupported one falls back to the scalar code. The result is the same
+    /// for all instruction sets.
+    [[nodiscard]] static QImage resampled(const QImage &image, const QSize &size, Filter filter, Instructions instructions);
+
+    [[nodiscard]] static Filter filterForScaleFactor(double scaleFactor);
+    /// The best instruction set supported by the CPU.
+    [[nodiscard]] static Instructions supportedInstructions();
+
+    static constexpr int precisionBits {14};
+
+protected:
+    /// Fixed point weights of the source pixels contributing to the result pixels. Every result pixel has the same
+    /// number of taps, the first one is at its start position.
+    struct Contributions
+    {
+        int taps {0};
+        std::vector<int> starts {};
+        std::vector<qint16> weights {};
+    };
+
+    [[nodiscard]] static Contributions contributions(int sourceSize, int resultSize, Filter filter);
+    [[nodiscard]] static double filterSupport(Filter filter);
+    [[nodiscard]] static double filterWeight(Filter filter, double x);
+
+    /// Splits the rows among the threads of the global thread pool.
+    template<typename F>
+    static void forEachRows(int rows, F function);
+
+    // Smaller tasks do not pay off the threading overhead
+    static constexpr int m_minRowsPerTask {32};
+};
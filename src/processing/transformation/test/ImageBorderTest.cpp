@@ -84,6 +84,54 @@ void ImageBorderTest::imageOffsets() const
     QCOMPARE(imageBorder.getImageOffsetX(), setInitialOffsetX + substraction);
 }
 
+void ImageBorderTest::paint() const
+{
+    constexpr auto fillingColor = Qt::blue;
+
+    QImage image(80, 60, QImage::Format_RGB32);
+    image.fill(fillingColor);
+
+    for (const auto &[offsetX, offsetY] : { std::pair {0, 0}, std::pair {10, 5}, std::pair {1000, 1000} })
+    {
+        // Painting has to be the same as the visible part of the transformed image.
+
+        ImageBorder<QImage> imageBorder;
+        imageBorder.bind(image);
+        imageBorder.setDrawBorder(true);
+        imageBorder.setAreaSize({ 50, 40 });
+        imageBorder.setImageOffsetX(offsetX);
+        imageBorder.setImageOffsetY(offsetY);
+
+        QImage outputImage(imageBorder.getAreaSize(), ImageBorder<QImage>::format);
+        QPainter painter(&outputImage);
+        imageBorder.paint(painter, outputImage.rect());
+        painter.end();
+
+        const QImage transformedImage = imageBorder.transform().value<QImage>();
+        QCOMPARE(outputImage, transformedImage.copy(outputImage.rect()));
+    }
+
+    {
+        // Only the dirty rectangle is painted.
+
+        constexpr auto untouchedColor = Qt::green;
+
+        ImageBorder<QImage> imageBorder;
+        imageBorder.bind(image);
+        imageBorder.setAreaSize({ 100, 100 });
+
+        QImage outputImage(imageBorder.getAreaSize(), ImageBorder<QImage>::format);
+        outputImage.fill(untouchedColor);
+        QPainter painter(&outputImage);
+        imageBorder.paint(painter, {0, 0, 50, 100});
+        painter.end();
+
+        checkAllPixels(outputImage, imageBorder.getBackgroundColor().rgba(), {0, 0}, {10, 100});
+        checkAllPixels(outputImage, QColor(fillingColor).rgba(), {10, 20}, {50, 80});
+        checkAllPixels(outputImage, QColor(untouchedColor).rgba(), {50, 0}, {100, 100});
+    }
+}
+
 void ImageBorderTest::resetProperties() const
 {
     ImageBorder<QImage> imageBorder;
@@ -245,6 +293,68 @@ void ImageBorderTest::checkTransformationWithOffset(const int offsetX, const int
 }
 
 
+void ImageBorderTest::sourceTransformation() const
+{
+    constexpr auto fillingColor = Qt::blue;
+
+    QImage image(40, 30, QImage::Format_RGB32);
+    image.fill(fillingColor);
+    const QTransform transformation {QTransform::fromScale(2, 2)};
+
+    for (const auto &[offsetX, offsetY] : { std::pair {0, 0}, std::pair {10, 5}, std::pair {1000, 1000} })
+    {
+        // The viewport rendering has to be the same as the visible part of the full rendering.
+
+        ImageBorder<QImage> fullImageBorder;
+        fullImageBorder.bind(image.transformed(transformation, Qt::SmoothTransformation));
+        fullImageBorder.setDrawBorder(true);
+        fullImageBorder.setAreaSize({ 50, 40 });
+        fullImageBorder.setImageOffsetX(offsetX);
+        fullImageBorder.setImageOffsetY(offsetY);
+        const QImage fullImage = fullImageBorder.transform().value<QImage>();
+
+        ImageBorder<QImage> imageBorder;
+        imageBorder.bind(image);
+        imageBorder.setSourceTransformation(transformation);
+        imageBorder.setDrawBorder(true);
+        imageBorder.setAreaSize({ 50, 40 });
+        imageBorder.setImageOffsetX(offsetX);
+        imageBorder.setImageOffsetY(offsetY);
+        QCOMPARE(imageBorder.isCacheDirty(), true);
+        const QImage outputImage = imageBorder.transform().value<QImage>();
+        QCOMPARE(imageBorder.isCacheDirty(), false);
+
+        QCOMPARE(outputImage.size(), imageBorder.getAreaSize());
+        QCOMPARE(imageBorder.getImageOffsetX(), fullImageBorder.getImageOffsetX());
+        QCOMPARE(imageBorder.getImageOffsetY(), fullImageBorder.getImageOffsetY());
+        QCOMPARE(outputImage, fullImage.copy(QRect {QPoint {0, 0}, imageBorder.getAreaSize()}));
+    }
+
+    {
+        // The image smaller than the area is centered.
+
+        ImageBorder<QImage> imageBorder;
+        imageBorder.bind(image);
+        imageBorder.setSourceTransformation(QTransform::fromScale(0.5, 0.5));
+        imageBorder.setAreaSize({ 40, 30 });
+        const QImage outputImage = imageBorder.transform().value<QImage>();
+
+        QCOMPARE(outputImage.size(), imageBorder.getAreaSize());
+        checkAllPixels(outputImage, QColor(fillingColor).rgba(), {10, 8}, {30, 23});
+        QCOMPARE(outputImage.pixel(0, 0), imageBorder.getBackgroundColor().rgba());
+        QCOMPARE(outputImage.pixel(39, 29), imageBorder.getBackgroundColor().rgba());
+    }
+
+    {
+        // Area size is not set, nothing is visible.
+
+        ImageBorder<QImage> imageBorder;
+        imageBorder.bind(image);
+        imageBorder.setSourceTransformation(transformation);
+        QVERIFY(imageBorder.transform().value<QImage>().isNull());
+    }
+}
+
 void ImageBorderTest::transform() const
 {
     constexpr auto fillingColor = Qt::blue;
@@ -32,6 +32,8 @@ private slots:
     void backgroundColor() const;
     void drawBorder() const;
     void imageOffsets() const;
+    void paint() const;
     void resetProperties() const;
+    void sourceTransformation() const;
     void transform() const;
 };
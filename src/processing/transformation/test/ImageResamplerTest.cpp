@@ -0,0 +1,243 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "ImageResamplerTest.h"
+
+namespace
+{
+    const ImageResampler::Filter filters[] {ImageResampler::Filter::Box, ImageResampler::Filter::Bicubic, ImageResampler::Filter::Lanczos3};
+
+    // Both reductions and enlargements, odd sizes exercise the remainders of the SIMD kernels.
+    const std::pair<QSize, QSize> sizes[] {{{37, 23}, {11, 50}},
+                                           {{100, 80}, {33, 27}},
+                                           {{64, 64}, {200, 130}},
+                                           {{300, 200}, {299, 201}},
+                                           {{1, 1}, {7, 3}},
+                                           {{257, 3}, {19, 3}},
+                                           {{3, 300}, {3, 17}}};
+
+    double filterWeight(const ImageResampler::Filter filter, const double x)
+    {
+        const auto sinc = [](const double value) { return value == 0.0 ? 1.0 : std::sin(std::numbers::pi * value) / (std::numbers::pi * value); };
+        const double absX {std::abs(x)};
+
+        switch (filter)
+        {
+            case ImageResampler::Filter::Box:
+                return x > -0.5 && x <= 0.5 ? 1.0 : 0.0;
+            case ImageResampler::Filter::Bicubic:
+                if (absX < 1.0)
+                    return (1.5 * absX - 2.5) * absX * absX + 1.0;
+                return absX < 2.0 ? ((-0.5 * absX + 2.5) * absX - 4.0) * absX + 2.0 : 0.0;
+            case ImageResampler::Filter::Lanczos3:
+                return absX < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+        }
+
+        return 0.0;
+    }
+
+    double filterSupport(const ImageResampler::Filter filter)
+    {
+        switch (filter)
+        {
+            case ImageResampler::Filter::Box:
+                return 0.5;
+            case ImageResampler::Filter::Bicubic:
+                return 2.0;
+            case ImageResampler::Filter::Lanczos3:
+                return 3.0;
+        }
+
+        return 0.5;
+    }
+
+    /// Resamples the lines of channel values in the double precision.
+    std::vector<std::vector<double>> resampleLines(const std::vector<std::vector<double>> &lines, const int resultSize, const ImageResampler::Filter filter)
+    {
+        const int sourceSize {static_cast<int>(lines.front().size())};
+        const double scale {static_cast<double>(sourceSize) / resultSize};
+        const double filterScale {std::max(scale, 1.0)};
+        const double support {filterSupport(filter) * filterScale};
+
+        std::vector<std::vector<double>> result(lines.size(), std::vector<double>(resultSize));
+        for (int i = 0; i < resultSize; ++i)
+        {
+            const double center {(i + 0.5) * scale};
+            const int first {std::max(0, static_cast<int>(center - support + 0.5))};
+            const int last {std::min(sourceSize, static_cast<int>(center + support + 0.5))};
+
+            double sum {0};
+            for (int j = first; j < last; ++j)
+                sum += filterWeight(filter, (j - center + 0.5) / filterScale);
+
+            for (size_t line = 0; line < lines.size(); ++line)
+            {
+                double value {0};
+                for (int j = first; j < last; ++j)
+                    value += filterWeight(filter, (j - center + 0.5) / filterScale) / sum * lines[line][j];
+                result[line][i] = std::clamp(value, 0.0, 255.0);
+            }
+        }
+
+        return result;
+    }
+}
+
+QImage ImageResamplerTest::randomImage(const QSize &size, const bool hasAlphaChannel)
+{
+    QImage image {size, hasAlphaChannel ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32};
+    auto *const generator {QRandomGenerator::global()};
+
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+        {
+            const int alpha {hasAlphaChannel ? generator->bounded(256) : 255};
+            image.setPixel(x, y, qRgba(generator->bounded(alpha + 1), generator->bounded(alpha + 1), generator->bounded(alpha + 1), alpha));
+        }
+
+    return image;
+}
+
+QImage ImageResamplerTest::referenceResampled(const QImage &image, const QSize &size, const ImageResampler::Filter filter)
+{
+    QImage result {size, QImage::Format_RGB32};
+
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        // Rows are resampled first, the intermediate result is rounded as the fixed point implementation does.
+        std::vector<std::vector<double>> rows(image.height(), std::vector<double>(image.width()));
+        for (int y = 0; y < image.height(); ++y)
+            for (int x = 0; x < image.width(); ++x)
+                rows[y][x] = (image.pixel(x, y) >> (8 * channel)) & 0xff;
+
+        if (size.width() != image.width())
+        {
+            rows = resampleLines(rows, size.width(), filter);
+            for (auto &row : rows)
+                std::ranges::transform(row, row.begin(), [](const double value) { return std::round(value); });
+        }
+
+        std::vector<std::vector<double>> columns(size.width(), std::vector<double>(image.height()));
+        for (int y = 0; y < image.height(); ++y)
+            for (int x = 0; x < size.width(); ++x)
+                columns[x][y] = rows[y][x];
+
+        if (size.height() != image.height())
+            columns = resampleLines(columns, size.height(), filter);
+
+        for (int y = 0; y < size.height(); ++y)
+            for (int x = 0; x < size.width(); ++x)
+                result.setPixel(x, y, (result.pixel(x, y) & ~(0xffu << (8 * channel))) | static_cast<QRgb>(std::lround(columns[x][y])) << (8 * channel));
+    }
+
+    return result;
+}
+
+void ImageResamplerTest::filterForScaleFactor() const
+{
+    QVERIFY(ImageResampler::filterForScaleFactor(0.1) == ImageResampler::Filter::Box);
+    QVERIFY(ImageResampler::filterForScaleFactor(0.5) == ImageResampler::Filter::Lanczos3);
+    QVERIFY(ImageResampler::filterForScaleFactor(1.0) == ImageResampler::Filter::Lanczos3);
+    QVERIFY(ImageResampler::filterForScaleFactor(2.0) == ImageResampler::Filter::Bicubic);
+}
+
+void ImageResamplerTest::instructions() const
+{
+    // All the instruction sets (even unsupported ones) give exactly the same result as the scalar code.
+    for (const auto &[sourceSize, size] : sizes)
+        for (const auto filter : filters)
+            for (const bool hasAlphaChannel : {false, true})
+            {
+                const QImage image {randomImage(sourceSize, hasAlphaChannel)};
+                const QImage expected {ImageResampler::resampled(image, size, filter, ImageResampler::Instructions::Scalar)};
+
+                for (const auto instructions : {ImageResampler::Instructions::SSE2, ImageResampler::Instructions::AVX2, ImageResampler::Instructions::NEON})
+                    QCOMPARE(ImageResampler::resampled(image, size, filter, instructions), expected);
+            }
+}
+
+void ImageResamplerTest::premultipliedAlpha() const
+{
+    {
+        // Colors never exceed the alpha, even with the negative filter lobes.
+
+        QImage image {randomImage({50, 50}, true)};
+        const QImage result {ImageResampler::resampled(image, {170, 30}, ImageResampler::Filter::Lanczos3)};
+        QCOMPARE(result.format(), QImage::Format_ARGB32_Premultiplied);
+
+        for (int y = 0; y < result.height(); ++y)
+            for (int x = 0; x < result.width(); ++x)
+            {
+                const QRgb pixel {result.pixel(x, y)};
+                QVERIFY(qRed(pixel) <= qAlpha(pixel) && qGreen(pixel) <= qAlpha(pixel) && qBlue(pixel) <= qAlpha(pixel));
+            }
+    }
+
+    {
+        // Transparent pixels do not bleed into the opaque ones.
+
+        QImage image {2, 1, QImage::Format_ARGB32};
+        image.setPixel(0, 0, qRgba(255, 0, 0, 255));
+        image.setPixel(1, 0, qRgba(0, 255, 0, 0));
+        const QImage result {ImageResampler::resampled(image, {1, 1}, ImageResampler::Filter::Box)};
+        QCOMPARE(result.pixelColor(0, 0).toRgb().red(), 255);
+        QCOMPARE(result.pixelColor(0, 0).toRgb().green(), 0);
+        QCOMPARE(result.pixelColor(0, 0).alpha(), 128);
+    }
+}
+
+void ImageResamplerTest::reference() const
+{
+    // Fixed point rounding errors are within 1.
+    for (const auto &[sourceSize, size] : sizes)
+        for (const auto filter : filters)
+        {
+            const QImage image {randomImage(sourceSize, false)};
+            const QImage result {ImageResampler::resampled(image, size, filter, ImageResampler::Instructions::Scalar)};
+            const QImage expected {referenceResampled(image, size, filter)};
+
+            for (int y = 0; y < size.height(); ++y)
+                for (int x = 0; x < size.width(); ++x)
+                {
+                    QVERIFY(std::abs(qRed(result.pixel(x, y)) - qRed(expected.pixel(x, y))) <= 1);
+                    QVERIFY(std::abs(qGreen(result.pixel(x, y)) - qGreen(expected.pixel(x, y))) <= 1);
+                    QVERIFY(std::abs(qBlue(result.pixel(x, y)) - qBlue(expected.pixel(x, y))) <= 1);
+                }
+        }
+}
+
+void ImageResamplerTest::resampled() const
+{
+    QCOMPARE(ImageResampler::resampled(QImage{}, {10, 10}, ImageResampler::Filter::Box), QImage{});
+
+    QImage image {40, 30, QImage::Format_RGB32};
+    image.fill(qRgb(10, 100, 200));
+    QCOMPARE(ImageResampler::resampled(image, {0, 10}, ImageResampler::Filter::Box), QImage{});
+    QCOMPARE(ImageResampler::resampled(image, image.size(), ImageResampler::Filter::Lanczos3), image);
+
+    // The uniform color is kept by all the filters.
+    for (const auto filter : filters)
+        for (const QSize size : {QSize{13, 7}, QSize{40, 90}, QSize{400, 3}})
+        {
+            const QImage result {ImageResampler::resampled(image, size, filter)};
+            QCOMPARE(result.size(), size);
+            QCOMPARE(result.format(), QImage::Format_RGB32);
+            for (int y = 0; y < result.height(); ++y)
+                for (int x = 0; x < result.width(); ++x)
+                    QCOMPARE(result.pixel(x, y), qRgb(10, 100, 200));
+        }
+}
@@ -0,0 +1,27 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+#include "../ImageResampler.h"
+
+class ImageResamplerTest: public QObject
+{
+    Q_OBJECT
+
+    [[nodiscard]] static QImage randomImage(const QSize &size, bool hasAlphaChannel);
+    [[nodiscard]] static QImage referenceResampled(const QImage &image, const QSize &size, ImageResampler::Filter filter);
+
+private slots:
+    void filterForScaleFactor() const;
+    void instructions() const;
+    void premultipliedAlpha() const;
+    void reference() const;
+    void resampled() const;
+};
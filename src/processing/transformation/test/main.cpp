@@ -10,6 +10,7 @@ VookiImageViewer - a tool for showing images.
 
 #include "ImageBorderTest.h"
 #include "ImageFlipTest.h"
+#include "ImageResamplerTest.h"
 #include "ImageRotationTest.h"
 #include "ImageTransformationBaseTest.h"
 #include "ImageZoomTest.h"
@@ -23,6 +24,7 @@ int main(int argc, char *argv[])
 
     TEST::runTests<ImageBorderTest>(argc, argv, &status);
     TEST::runTests<ImageFlipTest>(argc, argv, &status);
+    TEST::runTests<ImageResamplerTest>(argc, argv, &status);
     TEST::runTests<ImageRotationTest>(argc, argv, &status);
     TEST::runTests<ImageTransformationBaseTest>(argc, argv, &status);
     TEST::runTests<ImageZoomTest>(argc, argv, &status);
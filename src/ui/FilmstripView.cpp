@@ -0,0 +1,85 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "FilmstripView.h"
+#include <QStyleOptionViewItem>
+
+FilmstripView::FilmstripView(QWidget *parent)
+                                        : QListView(parent)
+{
+    const int side {ThumbnailCache::pixelSize(ThumbnailModel::m_thumbnailSize)};
+    setModel(&m_thumbnailModel);
+    setViewMode(QListView::ListMode);
+    setUniformItemSizes(true);
+    setLayoutMode(QListView::Batched);
+    setMovement(QListView::Static);
+    setResizeMode(QListView::Adjust);
+    setSelectionMode(QAbstractItemView::SingleSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setTextElideMode(Qt::ElideMiddle);
+    setIconSize({side, side});
+    setGridSize({side + m_spacing, side + m_spacing + m_textHeight});
+    setOrientation(Qt::Horizontal);
+
+    QObject::connect(this, &QListView::activated, this, &FilmstripView::onActivated);
+    QObject::connect(this, &QListView::clicked, this, &FilmstripView::onActivated);
+}
+
+ThumbnailModel &FilmstripView::thumbnailModel()
+{
+    return m_thumbnailModel;
+}
+
+void FilmstripView::setOrientation(const Qt::Orientation orientation)
+{
+    // The filmstrip is a single row, the grid wraps the rows and scrolls vertically.
+    setFlow(QListView::LeftToRight);
+    setWrapping(orientation == Qt::Vertical);
+    setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+}
+
+void FilmstripView::setCurrentImage(const QString &fileName)
+{
+    const int row {m_thumbnailModel.getRow(fileName)};
+    if (row < 0)
+    {
+        clearSelection();
+        return;
+    }
+
+    const QModelIndex index {m_thumbnailModel.index(row)};
+    selectionModel()->setCurrentIndex(index, QItemSelectionModel::ClearAndSelect);
+    scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void FilmstripView::initViewItemOption(QStyleOptionViewItem *option) const
+{
+    // The icon layout of the list mode, the icon mode would lay out all items one by one.
+    QListView::initViewItemOption(option);
+    option->decorationPosition = QStyleOptionViewItem::Top;
+    option->decorationAlignment = Qt::AlignCenter;
+    option->displayAlignment = Qt::AlignHCenter | Qt::AlignTop;
+    option->decorationSize = iconSize();
+    option->showDecorationSelected = true;
+}
+
+void FilmstripView::scrollContentsBy(const int dx, const int dy)
+{
+    // The cells scrolled away are not interesting anymore, the newly visible ones request their thumbnails when painted.
+    m_thumbnailModel.cancelRequests();
+    QListView::scrollContentsBy(dx, dy);
+}
+
+void FilmstripView::onActivated(const QModelIndex &index)
+{
+    if (const QString fileName {m_thumbnailModel.getFileName(index.row())}; !fileName.isEmpty())
+        emit imageSelected(fileName);
+}
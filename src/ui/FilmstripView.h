@@ -0,0 +1,49 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "../model/ThumbnailModel.h"
+#include "../util/compiler.h"
+#include <QListView>
+
+/// Thumbnails of the catalog images laid out as a filmstrip (horizontal) or as a grid (vertical).
+/// The list mode with the uniform item sizes is used even for the icons, so the layout does not query
+/// every single item and just the visible cells are materialized, even in the directories with thousands of images.
+class FilmstripView final : public QListView
+{
+    Q_OBJECT
+
+public:
+    explicit FilmstripView(QWidget *parent = nullptr);
+    DISABLE_COPY_MOVE(FilmstripView);
+
+    [[nodiscard]] ThumbnailModel &thumbnailModel();
+    void setOrientation(Qt::Orientation orientation);
+
+signals:
+    void imageSelected(const QString &fileName);
+
+public slots:
+    /// Selects the image, the catalog moved to, without emitting the imageSelected().
+    void setCurrentImage(const QString &fileName);
+
+protected:
+    void initViewItemOption(QStyleOptionViewItem *option) const override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private slots:
+    void onActivated(const QModelIndex &index);
+
+private:
+    ThumbnailModel m_thumbnailModel {};
+
+    static constexpr int m_spacing {8};
+    static constexpr int m_textHeight {24};
+};
@@ -16,6 +16,7 @@ VookiImageViewer - a tool for showing images.
 #include <QGuiApplication>
 #include <QPaintEvent>
 #include <QPainter>
+#include <QPointer>
 #include <QtConcurrent>
 #include <cmath>
 #include <qcorofuture.h>
@@ -24,7 +25,22 @@ ImageAreaWidget::ImageAreaWidget(QWidget *parent)
                                         : QWidget(parent)
 {
     m_originalImage.fill(qRgb(0, 0, 0));
-    m_finalImage.fill(qRgb(0, 0, 0));
+
+    // The transformed image is kept for scrolling, unless it is too large to be kept at all.
+    m_imageProcessor.setRenderMode(ImageProcessor::RenderMode::Automatic);
+
+    m_imageCache.setMemoryBudget(&m_memoryBudget);
+    m_imagePrefetcher.setMemoryBudget(&m_memoryBudget);
+    m_imageLoader.setMemoryBudget(&m_memoryBudget);
+    m_imageProcessor.setMemoryBudget(&m_memoryBudget);
+    m_imageTileSource.setMemoryBudget(&m_memoryBudget);
+
+    m_metadataCache->setDirectory(MetadataCache::defaultDirectory());
+
+    // Armed for the remaining time to the next frame presentation, not for the whole frame delay.
+    m_animationTimer.setSingleShot(true);
+    m_animationTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_animationTimer, &QTimer::timeout, this, &ImageAreaWidget::onNextImage);
 }
 
 void ImageAreaWidget::setBackgroundColor(const QColor &color)
@@ -40,36 +56,100 @@ void ImageAreaWidget::drawBorder(const bool draw, const QColor &color)
 
 QCoro::Task<bool> ImageAreaWidget::showImage(const QString &fileName)
 {
+    m_isFullResolutionPending = false;
+    stopPlayback();
+    m_imageProcessor.setTileSource(nullptr);
+    m_imageTileSource.close();
+    updateScaledSizeHint();
     if (!m_imageLoader.loadImage(fileName))
         co_return false;
 
-    m_originalImage = m_imageLoader.getImage();
+    // Images exceeding the memory budget are decoded as an overview only, the visible details are decoded tile by tile.
+    const bool isTiled {m_imageLoader.getDecodeStrategy() == MemoryBudget::DecodeStrategy::Tiled && m_imageTileSource.open(fileName)};
+
+    // The widget might be destroyed while waiting, e.g. once the application quits.
+    const QPointer<ImageAreaWidget> safeThis {this};
+
+    // Prefer the image already decoded by the prefetcher, the full resolution one does as well.
+    const QString key {ImageCache::imageKey(fileName, m_imageLoader.getScaledSizeHint())};
+    m_originalImage = m_imageCache.find(key);
+    if (m_originalImage.isNull() && m_imageLoader.getScaledSizeHint().isValid())
+        m_originalImage = m_imageCache.find(ImageCache::imageKey(fileName, {}));
     if (m_originalImage.isNull())
-        co_return false;
+    {
+        // Decoding runs on the worker thread. If the user moves to another image meanwhile,
+        // this request is cancelled and the null image is returned.
+        const QImage image {co_await m_imageLoader.getImageAsync()};
+        if (!safeThis || image.isNull())
+            co_return false;
+
+        m_originalImage = image;
+        // Keep it around, so stepping back to this image is instant as well
+        if (!m_imageLoader.isAnimated())
+            m_imageCache.insert(key, m_originalImage);
+    }
+
+    m_memoryBudget.setUsage(m_originalImageHolder, m_originalImage.sizeInBytes());
 
     // Start metadata extraction asynchronously
     auto metadataTask = extractMetadata(fileName);
 
-    m_imageProcessor.bind(m_originalImage);
+    // Interactions show a fast preview at first, the full quality one follows when ready.
+    // Animation frames are replaced too often for that, so they are rendered in the full quality right away.
+    m_imageProcessor.setProgressiveRendering(!m_imageLoader.isAnimated());
+    m_imageProcessor.bind(m_originalImage, true, m_imageLoader.getOriginalSize());
+    m_imageProcessor.setTileSource(isTiled ? &m_imageTileSource : nullptr);
     update();
 
-    emit imageDimensionsChanged(m_originalImage.width(), m_originalImage.height());
+    emit imageDimensionsChanged(m_imageProcessor.getOriginalSize().width(), m_imageProcessor.getOriginalSize().height());
 
     transformImage();
     update();
 
     // Wait for metadata extraction to complete
     co_await metadataTask;
+    if (!safeThis)
+        co_return false;
 
-    if (m_imageLoader.imageCount() > 1)
+    // Another image might have been shown meanwhile.
+    if (m_imageLoader.imageCount() > 1 && m_imageLoader.getFileName() == fileName)
     {
         if (const auto delay = m_imageLoader.nextImageDelay(); delay > 0)
-            QTimer::singleShot(delay, this, SLOT(onNextImage()));
+        {
+            const auto now {PlaybackClock::Clock::now()};
+            m_playbackClock.start(now, PlaybackClock::Duration {delay});
+            m_animationTimer.start(m_playbackClock.remaining(now));
+        }
     }
 
     co_return true;
 }
 
+const ImageAreaWidget::RenderStatistics &ImageAreaWidget::getRenderStatistics() const
+{
+    return m_renderStatistics;
+}
+
+const PlaybackClock::Statistics &ImageAreaWidget::getPlaybackStatistics() const
+{
+    return m_playbackClock.getStatistics();
+}
+
+void ImageAreaWidget::prefetchImages(const QStringList &fileNames)
+{
+    m_imagePrefetcher.prefetch(fileNames);
+}
+
+void ImageAreaWidget::setMemoryBudget(const qsizetype budget)
+{
+    m_memoryBudget.setBudget(budget > 0 ? budget : MemoryBudget::defaultBudget());
+}
+
+void ImageAreaWidget::setMetadataLanguage(const QString &language)
+{
+    m_metadataCache->setLanguage(language);
+}
+
 void ImageAreaWidget::repaintWithTransformations()
 {
     transformImage();
@@ -80,64 +160,89 @@ void ImageAreaWidget::repaintWithTransformations()
 void ImageAreaWidget::onDecreaseOffsetX(const int pixels)
 {
     m_imageProcessor.addImageOffsetX(-pixels);
-    repaintWithTransformations();
+    update();
 }
 
 void ImageAreaWidget::onDecreaseOffsetY(const int pixels)
 {
     m_imageProcessor.addImageOffsetY(-pixels);
-    repaintWithTransformations();
+    update();
 }
 
 void ImageAreaWidget::onFlipHorizontallyTriggered()
 {
     m_imageProcessor.flipHorizontally();
-    transformImage();
-    update();
+    scheduleTransformation();
 }
 
 void ImageAreaWidget::onFlipVerticallyTriggered()
 {
     m_imageProcessor.flipVertically();
-    transformImage();
-    update();
+    scheduleTransformation();
 }
 
 void ImageAreaWidget::onIncreaseOffsetX(const int pixels)
 {
     m_imageProcessor.addImageOffsetX(pixels);
-    repaintWithTransformations();
+    update();
 }
 
 void ImageAreaWidget::onIncreaseOffsetY(const int pixels)
 {
     m_imageProcessor.addImageOffsetY(pixels);
-    repaintWithTransformations();
+    update();
 }
 
 void ImageAreaWidget::onNextImage()
 {
-    m_originalImage = m_imageLoader.getNextImage();
-    m_imageProcessor.bind(m_originalImage, false);
-    transformImage();
+    if (!m_playbackClock.isRunning())
+        return;
+
+    // Frames which would be replaced already are skipped, so a slow rendering does not slow down the animation.
+    // All frames but one are skipped at most, the animation never stands still.
+    PlaybackClock::Duration delay {};
+    // The skipped frames have changed the image too.
+    QRect changedRect {};
+    bool isWholeImageChanged {false};
+    for (int skipped = 0;; ++skipped)
+    {
+        m_originalImage = m_imageLoader.getNextImage();
+        delay = PlaybackClock::Duration {m_imageLoader.nextImageDelay()};
+        isWholeImageChanged = isWholeImageChanged || m_imageLoader.getChangedRect().isNull();
+        changedRect |= m_imageLoader.getChangedRect();
+        if (delay <= PlaybackClock::Duration::zero() || skipped + 1 >= m_imageLoader.imageCount()
+            || !m_playbackClock.isLate(PlaybackClock::Clock::now(), delay))
+            break;
+
+        m_playbackClock.drop(delay);
+    }
+
+    m_memoryBudget.setUsage(m_originalImageHolder, m_originalImage.sizeInBytes());
+    // Unless the user has changed something meanwhile, the frame is rendered with the transformation of the previous one.
+    if (!m_imageProcessor.bindFrame(m_originalImage, isWholeImageChanged ? QRect {} : changedRect))
+        transformImage();
     update();
 
-    if (const auto delay = m_imageLoader.nextImageDelay(); delay > 0)
-        QTimer::singleShot(delay, this, SLOT(onNextImage()));
+    if (delay <= PlaybackClock::Duration::zero())
+    {
+        stopPlayback();
+        return;
+    }
+
+    m_playbackClock.present(PlaybackClock::Clock::now(), delay);
+    m_animationTimer.start(m_playbackClock.remaining(PlaybackClock::Clock::now()));
 }
 
 void ImageAreaWidget::onRotateLeftTriggered()
 {
     m_imageProcessor.rotateLeft();
-    transformImage();
-    update();
+    scheduleTransformation();
 }
 
 void ImageAreaWidget::onRotateRightTriggered()
 {
     m_imageProcessor.rotateRight();
-    transformImage();
-    update();
+    scheduleTransformation();
 }
 
 void ImageAreaWidget::onScrollDownTriggered()
@@ -164,8 +269,8 @@ void ImageAreaWidget::onSetFitToWindowTriggered(const bool enabled)
 {
     m_imageProcessor.setFitToArea(enabled);
     m_imageProcessor.setScaleFactor(1.0);
-    transformImage();
-    update();
+    updateScaledSizeHint();
+    scheduleTransformation();
 }
 
 void ImageAreaWidget::zoom(const double factor, const bool isZoomIn)
@@ -179,8 +284,7 @@ void ImageAreaWidget::zoom(const double factor, const bool isZoomIn)
     else
         m_imageProcessor.setScaleFactor(newScaleFactor > minValue ? newScaleFactor : minValue);
 
-    transformImage();
-    update();
+    scheduleTransformation();
 }
 
 void ImageAreaWidget::onZoomImageInTriggered(const double factor)
@@ -285,15 +389,18 @@ void ImageAreaWidget::nativeGestureEvent(QNativeGestureEvent *event)
 
 void ImageAreaWidget::paintEvent(QPaintEvent *event)
 {
+    if (m_isTransformationPending)
+        transformImage();
+
     QPainter painter(this);
-    const QRect &dirtyRect = event->rect();
-    painter.drawImage(dirtyRect, m_finalImage, dirtyRect);
+    m_imageProcessor.paint(painter, event->rect());
+    if (m_imageProcessor.isTileDecodingPending())
+        decodeTiles();
 }
 
 void ImageAreaWidget::resizeEvent(QResizeEvent *event)
 {
-    transformImage();
-    update();
+    scheduleTransformation();
     QWidget::resizeEvent(event);
 }
 
@@ -310,15 +417,47 @@ void ImageAreaWidget::scrollTo(const QPoint &point)
         onIncreaseOffsetY(-point.y());
 }
 
+void ImageAreaWidget::scheduleTransformation()
+{
+    // The transformation is deferred to the next paint event, so all the changes made within a single frame
+    // (e.g. the window resizing or the wheel spinning) are transformed just once.
+    ++m_renderStatistics.requested;
+    m_isTransformationPending = true;
+    update();
+}
+
+void ImageAreaWidget::stopPlayback()
+{
+    m_animationTimer.stop();
+    if (!m_playbackClock.isRunning())
+        return;
+
+    m_playbackClock.stop();
+    const PlaybackClock::Statistics &statistics {m_playbackClock.getStatistics()};
+    qDebug() << "Animation stopped:" << statistics.presented << "frames presented," << statistics.dropped << "dropped";
+}
+
 void ImageAreaWidget::transformImage()
 {
+    // Direct calls are requests executed right away.
+    if (!std::exchange(m_isTransformationPending, false))
+        ++m_renderStatistics.requested;
+
     if (m_originalImage.isNull())
         return;
 
+    ++m_renderStatistics.executed;
+
     m_imageProcessor.setAreaSize(size());
-    m_finalImage = m_imageProcessor.process();
+    m_imageProcessor.prepare();
+    if (m_imageProcessor.isRefinementPending())
+        refineImage();
+
+    // The reduced resolution image would be upscaled, so it's the time to decode the full resolution.
+    if (needsFullResolution())
+        loadFullResolution();
 
-    emit zoomPercentageChanged(m_imageProcessor.getScaleFactor() * m_originalImage.width() / m_originalImage.width());
+    emit zoomPercentageChanged(m_imageProcessor.getScaleFactor());
 }
 
 void ImageAreaWidget::wheelEvent(QWheelEvent *event)
@@ -353,9 +492,16 @@ void ImageAreaWidget::wheelEvent(QWheelEvent *event)
     event->accept();
 }
 
+QCoro::Task<void> ImageAreaWidget::decodeTiles()
+{
+    const QPointer<ImageAreaWidget> safeThis {this};
+    if (co_await m_imageProcessor.decodeTiles() && safeThis)
+        update();
+}
+
 QCoro::Task<void> ImageAreaWidget::extractMetadata(const QString &fileName)
 {
-    const auto metadataExtractor = std::make_shared<MetadataExtractor>();
+    const auto metadataExtractor = std::make_shared<MetadataExtractor>(m_metadataCache);
     QPointer<ImageAreaWidget> safeThis(this);
 
     auto infoConnection = connect(metadataExtractor.get(),
@@ -383,7 +529,7 @@ QCoro::Task<void> ImageAreaWidget::extractMetadata(const QString &fileName)
     });
 
     // Extract metadata asynchronously
-    co_await metadataExtractor->extract(fileName, m_originalImage.width(), m_originalImage.height());
+    co_await metadataExtractor->extract(fileName, m_imageProcessor.getOriginalSize().width(), m_imageProcessor.getOriginalSize().height());
 
     // Cleanup connections
     disconnect(infoConnection);
@@ -391,4 +537,56 @@ QCoro::Task<void> ImageAreaWidget::extractMetadata(const QString &fileName)
     disconnect(dimensionsConnection);
 
     co_return;
+}
+
+QCoro::Task<void> ImageAreaWidget::loadFullResolution()
+{
+    m_isFullResolutionPending = true;
+    const QString fileName {m_imageLoader.getFileName()};
+    m_imageLoader.setScaledSizeHint({});
+    if (!m_imageLoader.loadImage(fileName))
+    {
+        m_isFullResolutionPending = false;
+        co_return;
+    }
+
+    const QPointer<ImageAreaWidget> safeThis {this};
+    const QImage image {co_await m_imageLoader.getImageAsync()};
+    // Destroyed meanwhile, or another image has been requested and the flag belongs to it
+    if (!safeThis || !m_isFullResolutionPending || m_imageLoader.getFileName() != fileName)
+        co_return;
+
+    // The failed decoding is tried again by the next transformation.
+    m_isFullResolutionPending = false;
+    if (image.isNull())
+        co_return;
+
+    m_originalImage = image;
+    m_memoryBudget.setUsage(m_originalImageHolder, m_originalImage.sizeInBytes());
+    m_imageCache.insert(ImageCache::imageKey(fileName, {}), m_originalImage);
+    m_imageProcessor.bind(m_originalImage, false, m_imageLoader.getOriginalSize());
+    transformImage();
+    update();
+}
+
+bool ImageAreaWidget::needsFullResolution() const
+{
+    return !m_isFullResolutionPending && !m_imageLoader.isAnimated()
+           && m_imageLoader.getDecodeStrategy() == MemoryBudget::DecodeStrategy::Full && m_imageProcessor.getOriginalSize() != m_originalImage.size()
+           && m_imageProcessor.getImageScaleFactor() > m_maxReducedImageScaleFactor;
+}
+
+QCoro::Task<void> ImageAreaWidget::refineImage()
+{
+    const QPointer<ImageAreaWidget> safeThis {this};
+    if (co_await m_imageProcessor.refine() && safeThis)
+        update();
+}
+
+void ImageAreaWidget::updateScaledSizeHint()
+{
+    // Reduced resolution makes sense only if the image is shrunk to the window.
+    const QSize hint {m_imageProcessor.isFitToAreaEnabled() ? size() : QSize()};
+    m_imageLoader.setScaledSizeHint(hint);
+    m_imagePrefetcher.setScaledSizeHint(hint);
 }
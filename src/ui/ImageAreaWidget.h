@@ -14,11 +14,18 @@ VookiImageViewer - a tool for showing images.
 #include <QWidget>
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <qcorotask.h>
 #include <utility>
 #include <vector>
+#include "../processing/ImageCache.h"
 #include "../processing/ImageLoader.h"
+#include "../processing/ImagePrefetcher.h"
 #include "../processing/ImageProcessor.h"
+#include "../processing/ImageTileSource.h"
+#include "../processing/MemoryBudget.h"
+#include "../processing/MetadataCache.h"
+#include "../util/PlaybackClock.h"
 #include "../util/RotatingIndex.h"
 #include "../util/compiler.h"
 
@@ -35,12 +42,27 @@ class ImageAreaWidget : public QWidget
     Q_OBJECT
 
 public:
+    /// Counts the transformations requested by the user interactions and the ones really executed.
+    struct RenderStatistics
+    {
+        uint64_t requested {0};
+        uint64_t executed {0};
+    };
+
     explicit ImageAreaWidget(QWidget *parent = nullptr);
     DISABLE_COPY_MOVE(ImageAreaWidget);
 
     void setBackgroundColor(const QColor &color);
     void drawBorder(bool draw, const QColor &color = QColor(Qt::white));
     QCoro::Task<bool> showImage(const QString &fileName);
+    void prefetchImages(const QStringList &fileNames);
+    /// In bytes, the 0 derives the budget from the physical memory size.
+    void setMemoryBudget(qsizetype budget);
+    /// Language of the translations shown in the image information, the cached information follows it.
+    void setMetadataLanguage(const QString &language);
+    [[nodiscard]] const RenderStatistics &getRenderStatistics() const;
+    /// Presented and dropped frames of the animation being played.
+    [[nodiscard]] const PlaybackClock::Statistics &getPlaybackStatistics() const;
     void repaintWithTransformations();
 
 signals:
@@ -77,19 +99,41 @@ protected:
     void nativeGestureEvent(QNativeGestureEvent *event);
     void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void scheduleTransformation();
     void scrollTo(const QPoint &point);
+    /// Logs the presented and dropped frames of the animation being played.
+    void stopPlayback();
     void transformImage();
     void wheelEvent(QWheelEvent *event) override;
     void zoom(double factor, bool isZoomIn);
 
+    QCoro::Task<void> decodeTiles();
     QCoro::Task<void> extractMetadata(const QString &fileName);
+    QCoro::Task<void> loadFullResolution();
+    [[nodiscard]] bool needsFullResolution() const;
+    QCoro::Task<void> refineImage();
+    void updateScaledSizeHint();
 
 private:
+    // Outlives all the holders reporting to it
+    MemoryBudget m_memoryBudget {};
+    const int m_originalImageHolder {m_memoryBudget.registerHolder(MemoryBudget::Category::OriginalImage)};
     QImage m_originalImage {};
-    QImage m_finalImage {};
     QPoint m_mouseMoveLast {};
     ImageLoader m_imageLoader {};
     ImageProcessor m_imageProcessor {};
+    ImageCache m_imageCache {};
+    ImagePrefetcher m_imagePrefetcher {m_imageCache};
+    ImageTileSource m_imageTileSource {};
+    // Shared with the extractors, which may still be parsing when the widget is gone.
+    const std::shared_ptr<MetadataCache> m_metadataCache {std::make_shared<MetadataCache>()};
+    bool m_isFullResolutionPending {false};
+    bool m_isTransformationPending {false};
+    RenderStatistics m_renderStatistics {};
+    PlaybackClock m_playbackClock {};
+    QTimer m_animationTimer {};
 
     static constexpr int m_imageOffsetStep {100};
+    // Tolerates the rounding of the reduced resolution image dimensions
+    static constexpr double m_maxReducedImageScaleFactor {1.01};
 };
@@ -11,11 +11,13 @@ VookiImageViewer - a tool for showing images.
 #include "MainWindow.h"
 
 #include "../model/FileSystemSortFilterProxyModel.h"
+#include "../processing/MetadataExtractor.h"
 #include "../ui/support/Settings.h"
 #include "../ui/support/SettingsStrings.h"
 #include "../util/ByteSize.h"
 #include "../util/misc.h"
 #include "AboutComponentsDialog.h"
+#include "FilmstripView.h"
 #include "ReleaseNotesDialog.h"
 #include "version.h"
 #include "../application/Application.h"
@@ -24,10 +26,20 @@ VookiImageViewer - a tool for showing images.
 #include "ui_AboutDialog.h"
 #include "ui_AboutSupportedFormatsDialog.h"
 #include <QAction>
+#include <QActionGroup>
+#include <QDateTime>
+#include <QDockWidget>
 #include <QFileSystemModel>
 #include <QImageReader>
 #include <QMessageBox>
 #include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
 
 #if not QT_CONFIG(whatsthis)
     #error "Qt was not compiled with the whatsthis feature, cannot compile this program which depends on it."
@@ -37,7 +49,10 @@ MainWindow::MainWindow(QWidget *parent)
                                         : QMainWindow(parent)
                                         , m_fileSystemModel(new QFileSystemModel(this))
                                         , m_sortFileSystemModel(new FileSystemSortFilterProxyModel(this))
+                                        , m_filmstripDock(new QDockWidget(this))
+                                        , m_filmstripView(new FilmstripView(m_filmstripDock))
                                         , m_catalog(Util::convertFormatsToFilters(QImageReader::supportedImageFormats()))
+                                        , m_metadataIndexer(&MetadataExtractor::readRecord)
 {
     m_ui.setupUi(this);
 
@@ -53,6 +68,53 @@ MainWindow::MainWindow(QWidget *parent)
     m_ui.dockInfoWidget->toggleViewAction()->setWhatsThis("viv/shortcut/window/info");
     m_ui.menuShow->addAction(m_ui.dockInfoWidget->toggleViewAction());
 
+    m_filmstripDock->setObjectName("dockFilmstripWidget");
+    m_filmstripDock->setWindowTitle(tr("Filmstrip"));
+    m_filmstripDock->setWidget(m_filmstripView);
+    addDockWidget(Qt::BottomDockWidgetArea, m_filmstripDock);
+    m_filmstripDock->toggleViewAction()->setShortcut(QKeySequence(Qt::Key_G));
+    m_filmstripDock->toggleViewAction()->setWhatsThis("viv/shortcut/window/filmstrip");
+    m_ui.menuShow->addAction(m_filmstripDock->toggleViewAction());
+    // Docked at the sides, there is more room for the grid than for the filmstrip.
+    QObject::connect(m_filmstripDock, &QDockWidget::dockLocationChanged, this, [this](const Qt::DockWidgetArea area) {
+        m_filmstripView->setOrientation(area == Qt::LeftDockWidgetArea || area == Qt::RightDockWidgetArea ? Qt::Vertical : Qt::Horizontal);
+    });
+    QObject::connect(m_filmstripView, &FilmstripView::imageSelected, this, &MainWindow::onFilmstripImageSelected);
+    m_filmstripView->thumbnailModel().setCatalog(&m_catalog);
+
+    QObject::connect(&m_catalog, &ImageCatalog::itemsInserted, this, &MainWindow::onCatalogItemsInserted);
+    QObject::connect(&m_catalog, &ImageCatalog::itemsMerged, this, &MainWindow::onCatalogItemsMerged);
+    // Neighbours wrap around the catalog ends, those are known for sure once the whole directory is enumerated.
+    QObject::connect(&m_catalog, &ImageCatalog::enumerationFinished, this, &MainWindow::prefetchNeighbours);
+    QObject::connect(&m_catalog, &ImageCatalog::itemsAdded, this, &MainWindow::onCatalogItemsAdded);
+    QObject::connect(&m_catalog, &ImageCatalog::currentItemRemoved, this, [this]() { showImage(false); });
+    QObject::connect(&m_catalog, &ImageCatalog::catalogSorted, this, &MainWindow::onCatalogSorted);
+    m_catalog.setCaptureTimeReader(&MetadataExtractor::readCaptureTime);
+    m_catalog.setIndexDirectory(CatalogIndex::defaultDirectory());
+
+    QObject::connect(m_ui.actionIndexMetadata, &QAction::triggered, this, &MainWindow::onIndexMetadataTriggered);
+    QObject::connect(&m_metadataIndexer, &MetadataIndexer::progressChanged, this, [this](const qsizetype indexedCount, const qsizetype totalCount) {
+        //: Used in the statusbar while the metadata are being indexed. Example: "Indexing metadata: 120 of 3000"
+        m_ui.statusBar->showMessage(tr("Indexing metadata: %1 of %2").arg(QString::number(indexedCount), QString::number(totalCount)));
+    });
+    QObject::connect(&m_metadataIndexer, &MetadataIndexer::finished, this, &MainWindow::onMetadataIndexed);
+
+    // Sort criteria are exclusive, the action data tell which one is chosen.
+    auto * const sortActionGroup = new QActionGroup(this);
+    const std::array<std::pair<QAction *, CatalogOrder::Criterion>, 5> sortActions {{
+        {m_ui.actionSortByName, CatalogOrder::Criterion::Name},
+        {m_ui.actionSortByNaturalOrder, CatalogOrder::Criterion::Natural},
+        {m_ui.actionSortByLocaleOrder, CatalogOrder::Criterion::Locale},
+        {m_ui.actionSortByModificationTime, CatalogOrder::Criterion::ModificationTime},
+        {m_ui.actionSortByCaptureTime, CatalogOrder::Criterion::CaptureTime},
+    }};
+    for (const auto &[action, criterion] : sortActions)
+    {
+        action->setData(static_cast<int>(criterion));
+        sortActionGroup->addAction(action);
+    }
+    QObject::connect(sortActionGroup, &QActionGroup::triggered, this, &MainWindow::onSortByTriggered);
+
     m_sortFileSystemModel->setSourceModel(m_fileSystemModel);
 
     m_fileSystemModel->setRootPath(QDir::currentPath());
@@ -75,13 +137,24 @@ MainWindow::MainWindow(QWidget *parent)
     m_ui.toolBar->setHidden(settings->value(SETTINGS_WINDOW_HIDE_TOOLBAR).toBool());
     m_ui.dockWidget->setHidden(settings->value(SETTINGS_WINDOW_HIDE_NAVIGATION).toBool());
     m_ui.dockInfoWidget->setHidden(settings->value(SETTINGS_WINDOW_HIDE_INFORMATION).toBool());
+    m_filmstripDock->setHidden(settings->value(SETTINGS_WINDOW_HIDE_FILMSTRIP).toBool());
     m_ui.toolBar->toggleViewAction()->setChecked(!settings->value(SETTINGS_WINDOW_HIDE_TOOLBAR).toBool());
     m_ui.dockWidget->toggleViewAction()->setChecked(!settings->value(SETTINGS_WINDOW_HIDE_NAVIGATION).toBool());
     m_ui.dockInfoWidget->toggleViewAction()->setChecked(!settings->value(SETTINGS_WINDOW_HIDE_INFORMATION).toBool());
+    m_filmstripDock->toggleViewAction()->setChecked(!settings->value(SETTINGS_WINDOW_HIDE_FILMSTRIP).toBool());
 
     if (settings->value(SETTINGS_IMAGE_FITIMAGETOWINDOW).toBool())
         m_ui.actionFitToWindow->setChecked(true);
 
+    for (const auto &[action, criterion] : sortActions)
+    {
+        if (settings->value(SETTINGS_IMAGE_SORT_ORDER).toInt() == static_cast<int>(criterion))
+        {
+            action->setChecked(true);
+            m_catalog.setSortCriterion(criterion);
+        }
+    }
+
     if (settings->value(SETTINGS_WINDOW_HIDE_STATUSBAR).toBool())
         m_ui.actionStatusBar->setChecked(false);
 
@@ -90,6 +163,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     propagateBackgroundSettings();
     propagateBorderSettings();
+    propagateCatalogSettings();
+    propagateMemorySettings();
     restoreRecentFiles();
     loadTranslators();
 }
@@ -104,17 +179,26 @@ MainWindow::HANDLE_RESULT_E MainWindow::handleImagePath(const QString &path, con
     {
         if (info.isReadable())
         {
+            // Directories are enumerated in the background, the images are shown while the catalog is still growing.
             if (info.isDir())
             {
-                m_catalog.initialize(QDir(path));
+                loadMetadataIndex(QDir(path).canonicalPath());
+                m_catalog.initializeAsync(QDir(path));
                 showImage(addToRecentFiles);
+                // The first enumerated image is shown as soon as it is there, the indexed directory has it already.
+                if (m_catalog.getCatalogSize() == 0)
+                    m_pendingCatalogImage = addToRecentFiles;
+                else
+                    m_pendingCatalogImage.reset();
                 return HANDLE_RESULT_E::OK;
             }
 
             if (info.isFile())
             {
-                m_catalog.initialize(QFile(path));
+                loadMetadataIndex(info.absoluteDir().canonicalPath());
+                m_catalog.initializeAsync(QFile(path));
                 showImage(addToRecentFiles);
+                m_pendingCatalogImage.reset();
                 return HANDLE_RESULT_E::OK;
             }
         }
@@ -134,6 +218,7 @@ void MainWindow::changeEvent(QEvent *event)
             // this event is sent if a translator is loaded
             case QEvent::LanguageChange:
                 m_ui.retranslateUi(this);
+                m_filmstripDock->setWindowTitle(tr("Filmstrip"));
                 break;
 
             // this event is sent, if the system, language changes
@@ -161,16 +246,20 @@ QString MainWindow::getRecentFile(const qsizetype item) const
     return {};
 }
 
-void MainWindow::loadTranslators()
+void MainWindow::loadTranslators() const
 {
     const auto settings = Settings::userSettings();
+    const QLocale locale {settings->value(SETTINGS_LANGUAGE_USE_SYSTEM).toBool() ? QLocale() : QLocale(settings->value(SETTINGS_LANGUAGE_CODE).value<QString>())};
     if (auto * const application = dynamic_cast<Application *>(QCoreApplication::instance()))
-    {
-        if (settings->value(SETTINGS_LANGUAGE_USE_SYSTEM).toBool())
-            application->installTranslators(QLocale());
-        else
-            application->installTranslators(QLocale(settings->value(SETTINGS_LANGUAGE_CODE).value<QString>()));
-    }
+        application->installTranslators(locale);
+
+    // The cached image information is translated already
+    m_ui.imageAreaWidget->setMetadataLanguage(locale.name());
+}
+
+void MainWindow::prefetchNeighbours() const
+{
+    m_ui.imageAreaWidget->prefetchImages(m_catalog.getNeighbours(m_prefetchNextCount, m_prefetchPreviousCount));
 }
 
 void MainWindow::propagateBackgroundSettings() const
@@ -185,6 +274,20 @@ void MainWindow::propagateBorderSettings() const
     m_ui.imageAreaWidget->drawBorder(settings->value(SETTINGS_IMAGE_BORDER_DRAW).toBool(), settings->value(SETTINGS_IMAGE_BORDER_COLOR).value<QColor>());
 }
 
+void MainWindow::propagateCatalogSettings()
+{
+    // Applies to the next opened image or directory.
+    const auto settings = Settings::userSettings();
+    m_catalog.setRecursion({settings->value(SETTINGS_IMAGE_RECURSION_DEPTH).toInt(), settings->value(SETTINGS_IMAGE_RECURSION_SYMLINKS).toBool()});
+}
+
+void MainWindow::propagateMemorySettings() const
+{
+    const auto settings = Settings::userSettings();
+    constexpr qsizetype mebibyte {1024 * 1024};
+    m_ui.imageAreaWidget->setMemoryBudget(settings->value(SETTINGS_IMAGE_MEMORY_BUDGET).toLongLong() * mebibyte);
+}
+
 QString MainWindow::registerProcessedImage(const QString &filePath, const bool addToRecentFiles)
 {
     if (filePath.isEmpty())
@@ -219,6 +322,7 @@ QString MainWindow::registerProcessedImage(const QString &filePath, const bool a
     }
 
     m_ui.fileSystemTreeView->setCurrentIndex(m_sortFileSystemModel->mapFromSource(m_fileSystemModel->index(m_catalog.getCurrent())));
+    m_filmstripView->setCurrentImage(m_filmstripView->thumbnailModel().getFileName(static_cast<int>(m_catalog.getCurrentIndex())));
     m_ui.statusBar->showMessage(filePath);
     return filePath;
 }
@@ -259,6 +363,7 @@ void MainWindow::restoreRecentFiles()
 void MainWindow::showImage(const bool addToRecentFiles)
 {
     m_ui.imageAreaWidget->showImage(registerProcessedImage(m_catalog.getCurrent(), addToRecentFiles));
+    prefetchNeighbours();
 }
 
 void MainWindow::onAboutToQuit() const
@@ -312,6 +417,55 @@ void MainWindow::onAboutSupportedImageFormats()
     dialog.exec();
 }
 
+void MainWindow::onCatalogItemsAdded(const QString &newestFileName)
+{
+    // Tethered shooting, the freshly taken image is shown as soon as it is written.
+    if (!Settings::userSettings()->value(SETTINGS_IMAGE_AUTO_ADVANCE).toBool())
+        return;
+
+    if (const qsizetype index {m_catalog.indexOf(newestFileName)}; index >= 0 && index != m_catalog.getCurrentIndex())
+    {
+        m_catalog.setCurrentIndex(index);
+        showImage(false);
+    }
+}
+
+void MainWindow::onCatalogItemsInserted(const qsizetype first, const qsizetype count)
+{
+    if (m_pendingCatalogImage)
+    {
+        const bool addToRecentFiles {*m_pendingCatalogImage};
+        m_pendingCatalogImage.reset();
+        showImage(addToRecentFiles);
+        return;
+    }
+
+    // Neighbours of the shown image might have just been enumerated.
+    const qsizetype current {m_catalog.getCurrentIndex()};
+    if (first <= current + m_prefetchNextCount && first + count + m_prefetchPreviousCount > current)
+        prefetchNeighbours();
+}
+
+void MainWindow::onCatalogItemsMerged()
+{
+    if (m_pendingCatalogImage)
+    {
+        onCatalogItemsInserted(0, m_catalog.getCatalogSize());
+        return;
+    }
+
+    // The filmstrip has been reset, and the neighbours of the shown image might have just been enumerated.
+    m_filmstripView->setCurrentImage(m_catalog.getCurrent());
+    prefetchNeighbours();
+}
+
+void MainWindow::onCatalogSorted()
+{
+    m_filmstripView->setCurrentImage(m_catalog.getCurrent());
+    // Neighbours are different ones in the new order.
+    prefetchNeighbours();
+}
+
 void MainWindow::onClearHistory() const
 {
     const auto actions = m_ui.menuRecentFiles->actions();
@@ -330,6 +484,17 @@ void MainWindow::onFileSystemTreeViewActivated(const QModelIndex &index)
     handleImagePath(filePath);
 }
 
+void MainWindow::onFilmstripImageSelected(const QString &filePath)
+{
+    // The filmstrip lists the catalog items in the catalog order.
+    const int row {m_filmstripView->thumbnailModel().getRow(filePath)};
+    if (row < 0 || row == m_catalog.getCurrentIndex())
+        return;
+
+    m_catalog.setCurrentIndex(row);
+    showImage(true);
+}
+
 void MainWindow::onFitToWindowToggled(const bool toggled) const
 {
     m_ui.imageAreaWidget->onSetFitToWindowTriggered(toggled);
@@ -356,6 +521,11 @@ void MainWindow::onFullScreenToggled([[maybe_unused]] bool toggled)
             m_ui.dockInfoWidget->show();
         else
             m_ui.dockInfoWidget->hide();
+        m_filmstripDock->toggleViewAction()->setChecked(m_widgetVisibilityPriorFullscreen.isFilmstripVisible);
+        if (m_widgetVisibilityPriorFullscreen.isFilmstripVisible)
+            m_filmstripDock->show();
+        else
+            m_filmstripDock->hide();
         m_ui.actionStatusBar->setChecked(m_widgetVisibilityPriorFullscreen.isStatusBarVisible);
         if (m_widgetVisibilityPriorFullscreen.isStatusBarVisible)
             m_ui.statusBar->show();
@@ -367,6 +537,7 @@ void MainWindow::onFullScreenToggled([[maybe_unused]] bool toggled)
         m_widgetVisibilityPriorFullscreen.isToolBarVisible = m_ui.toolBar->toggleViewAction()->isChecked();
         m_widgetVisibilityPriorFullscreen.isFileSystemNavigationVisible = m_ui.dockWidget->toggleViewAction()->isChecked();
         m_widgetVisibilityPriorFullscreen.isInformationVisible = m_ui.dockInfoWidget->toggleViewAction()->isChecked();
+        m_widgetVisibilityPriorFullscreen.isFilmstripVisible = m_filmstripDock->toggleViewAction()->isChecked();
         m_widgetVisibilityPriorFullscreen.isStatusBarVisible = m_ui.actionStatusBar->isChecked();
 
         const auto settings = Settings::userSettings();
@@ -388,6 +559,12 @@ void MainWindow::onFullScreenToggled([[maybe_unused]] bool toggled)
             m_ui.dockInfoWidget->hide();
         }
 
+        if (settings->value(SETTINGS_FULLSCREEN_HIDE_FILMSTRIP).toBool())
+        {
+            m_filmstripDock->toggleViewAction()->setChecked(false);
+            m_filmstripDock->hide();
+        }
+
         if (settings->value(SETTINGS_FULLSCREEN_HIDE_STATUSBAR).toBool())
         {
             m_ui.actionStatusBar->setChecked(false);
@@ -401,6 +578,7 @@ void MainWindow::onFullScreenToggled([[maybe_unused]] bool toggled)
 void MainWindow::onNextImageTriggered()
 {
     m_ui.imageAreaWidget->showImage(registerProcessedImage(m_catalog.getNext()));
+    prefetchNeighbours();
 }
 
 void MainWindow::onOriginalSizeTriggered() const
@@ -412,6 +590,7 @@ void MainWindow::onOriginalSizeTriggered() const
 void MainWindow::onPreviousImageTriggered()
 {
     m_ui.imageAreaWidget->showImage(registerProcessedImage(m_catalog.getPrevious()));
+    prefetchNeighbours();
 }
 
 void MainWindow::onQuitTriggered()
@@ -443,11 +622,20 @@ void MainWindow::onSettingsTriggered()
     {
         propagateBackgroundSettings();
         propagateBorderSettings();
+        propagateCatalogSettings();
+        propagateMemorySettings();
         m_ui.imageAreaWidget->repaintWithTransformations();
         loadTranslators();
     }
 }
 
+void MainWindow::onSortByTriggered(QAction *action)
+{
+    const auto criterion {static_cast<CatalogOrder::Criterion>(action->data().toInt())};
+    Settings::userSettings()->setValue(SETTINGS_IMAGE_SORT_ORDER, static_cast<int>(criterion));
+    m_catalog.setSortCriterion(criterion);
+}
+
 void MainWindow::onStatusBarToggled(const bool toggled) const
 {
     toggled ? m_ui.statusBar->show() : m_ui.statusBar->hide();
@@ -481,10 +669,79 @@ void MainWindow::onImageSizeChanged(const uint64_t size) const
     m_ui.statusBar->setSizeLabel(tr("%1 %2").arg(QString::number(newSize), unitString));
 }
 
+void MainWindow::loadMetadataIndex(const QString &directory)
+{
+    setCaptureTimes(directory, [path = MetadataIndex::indexPath(MetadataIndex::defaultDirectory(), directory)]() {
+        const std::optional<MetadataIndex> index {MetadataIndex::load(path)};
+        return index ? index->getCaptureTimes() : QHash<QString, MetadataIndex::CaptureTime> {};
+    });
+}
+
+void MainWindow::setCaptureTimes(const QString &directory, std::function<QHash<QString, MetadataIndex::CaptureTime>()> captureTimesLoader)
+{
+    struct CaptureTimes
+    {
+        std::once_flag loading {};
+        std::atomic<bool> isLoaded {false};
+        QHash<QString, MetadataIndex::CaptureTime> captureTimes {};
+    };
+
+    // Shared by the copies of the reader, the worker threads just read the hash once it is loaded.
+    m_catalog.setCaptureTimeReader([prefix = directory + QLatin1Char('/'), state = std::make_shared<CaptureTimes>(),
+                                    loader = std::move(captureTimesLoader)](const QString &fileName) {
+        // The single images gathered on the GUI thread do not wait for the whole index, they are read right away.
+        if (!fileName.startsWith(prefix) || (!state->isLoaded && QThread::currentThread() == QCoreApplication::instance()->thread()))
+            return MetadataExtractor::readCaptureTime(fileName);
+
+        std::call_once(state->loading, [&state, &loader]() {
+            state->captureTimes = loader();
+            state->isLoaded = true;
+        });
+
+        if (const auto it {state->captureTimes.constFind(fileName.mid(prefix.size()))}; it != state->captureTimes.cend())
+        {
+            // The image modified since it was indexed is read again.
+            if (const QFileInfo info {fileName}; info.size() == it->fileSize && info.lastModified().toMSecsSinceEpoch() == it->modificationTime)
+                return it->captureTime == MetadataIndex::m_unknownTime ? QDateTime {} : QDateTime::fromMSecsSinceEpoch(it->captureTime);
+        }
+
+        return MetadataExtractor::readCaptureTime(fileName);
+    });
+}
+
+void MainWindow::onIndexMetadataTriggered()
+{
+    if (m_catalog.getCatalogSize() == 0)
+        return;
+
+    m_metadataIndexer.start(m_catalog.getDirectory(), m_catalog.getItems());
+}
+
+void MainWindow::onMetadataIndexed()
+{
+    const MetadataIndexer::Statistics &statistics {m_metadataIndexer.getStatistics()};
+    //: Used in the statusbar once the metadata are indexed. Example: "Indexed metadata of 3000 images, 850 files/s"
+    m_ui.statusBar->showMessage(tr("Indexed metadata of %1 images, %2 files/s").arg(QString::number(statistics.fileCount), QString::number(qRound(statistics.filesPerSecond()))));
+
+    // Another directory might have been opened meanwhile, it keeps its own capture times then.
+    if (m_metadataIndexer.getDirectory() == m_catalog.getDirectory())
+        setCaptureTimes(m_metadataIndexer.getDirectory(), [index = m_metadataIndexer.getIndex()]() { return index.getCaptureTimes(); });
+
+    // Stored on the worker thread, the index of tens of thousands of images takes a few megabytes.
+    QThreadPool::globalInstance()->start([index = m_metadataIndexer.getIndex(), path = MetadataIndex::indexPath(MetadataIndex::defaultDirectory(), m_metadataIndexer.getDirectory())]() {
+        index.store(path);
+    });
+}
+
 void MainWindow::onZoomPercentageChanged(const qreal value) const
 {
     //: Used in the statusbar showing the zooming percentage. Example: "12%"
     m_ui.statusBar->setZoomLabel(tr("%1 %").arg(QString::number(static_cast<int>(value * 100))));
+
+    // Emitted by every executed transformation, so the saving of the coalesced ones can be watched there.
+    const ImageAreaWidget::RenderStatistics &statistics {m_ui.imageAreaWidget->getRenderStatistics()};
+    //: Tooltip of the zooming percentage in the statusbar. Example: "Zoom (rendered 12 of 40 requested transformations)"
+    m_ui.statusBar->setZoomToolTip(tr("Zoom (rendered %1 of %2 requested transformations)").arg(QString::number(statistics.executed), QString::number(statistics.requested)));
 }
 
 void MainWindow::onHomeDirClicked() const
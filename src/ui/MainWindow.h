@@ -10,13 +10,19 @@ VookiImageViewer - a tool for showing images.
 ****************************************************************************/
 
 #include "../model/ImageCatalog.h"
+#include "../processing/MetadataIndexer.h"
 #include "../util/compiler.h"
 #include "ui_MainWindow.h"
+#include <QHash>
 #include <QString>
+#include <functional>
+#include <optional>
 
 // Forward declarations
+class QDockWidget;
 class QFileSystemModel;
 class FileSystemSortFilterProxyModel;
+class FilmstripView;
 
 class MainWindow : public QMainWindow
 {
@@ -40,11 +46,20 @@ public:
 protected:
     void changeEvent(QEvent *) override;
     [[nodiscard]] QString getRecentFile(qsizetype item) const;
-    static void loadTranslators();
+    /// The stored metadata index of the directory, if it has been indexed before, is read once the capture time order
+    /// needs it, on the worker thread.
+    void loadMetadataIndex(const QString &directory);
+    void loadTranslators() const;
+    void prefetchNeighbours() const;
     void propagateBackgroundSettings() const;
     void propagateBorderSettings() const;
+    void propagateCatalogSettings();
+    void propagateMemorySettings() const;
     [[nodiscard]] QString registerProcessedImage(const QString &filePath, bool addToRecentFiles = true);
     void restoreRecentFiles();
+    /// The capture time order takes the indexed images from there, just the others and the modified ones are read.
+    /// The capture times are loaded by the first image needing them.
+    void setCaptureTimes(const QString &directory, std::function<QHash<QString, MetadataIndex::CaptureTime>()> captureTimesLoader);
     void showImage(bool addToRecentFiles);
 
 public slots:
@@ -56,14 +71,21 @@ protected slots:
     void onAboutComponentsTriggered();
     void onAboutQtTriggered();
     void onAboutSupportedImageFormats();
+    void onCatalogItemsAdded(const QString &newestFileName);
+    void onCatalogItemsInserted(qsizetype first, qsizetype count);
+    void onCatalogItemsMerged();
+    void onCatalogSorted();
     void onClearHistory() const;
     void onDocsDirClicked() const;
     void onFileSystemTreeViewActivated(const QModelIndex &index);
+    void onFilmstripImageSelected(const QString &filePath);
     void onFitToWindowToggled(bool toggled) const;
     void onFullScreenToggled(bool toggled);
     void onHomeDirClicked() const;
     void onImageDimensionsChanged(int width, int height) const;
     void onImageSizeChanged(uint64_t size) const;
+    void onIndexMetadataTriggered();
+    void onMetadataIndexed();
     void onNextImageTriggered();
     void onOriginalSizeTriggered() const;
     void onPicturesDirClicked() const;
@@ -72,6 +94,7 @@ protected slots:
     void onRecentFileTriggered(const QString &filePath);
     void onReleaseNotesTriggered();
     void onSettingsTriggered();
+    void onSortByTriggered(QAction *action);
     void onStatusBarToggled(bool toggled) const;
     void onZoomInTriggered() const;
     void onZoomOutTriggered() const;
@@ -81,7 +104,15 @@ private:
     Ui::MainWindow m_ui {};
     QFileSystemModel *m_fileSystemModel;
     FileSystemSortFilterProxyModel *m_sortFileSystemModel;
+    QDockWidget *m_filmstripDock;
+    FilmstripView *m_filmstripView;
     ImageCatalog m_catalog;
+    MetadataIndexer m_metadataIndexer;
+    // Set while the opened directory has no enumerated image yet, tells whether it goes to the recent files.
+    std::optional<bool> m_pendingCatalogImage {};
+
+    static constexpr qsizetype m_prefetchNextCount {2};
+    static constexpr qsizetype m_prefetchPreviousCount {1};
 
     struct
     {
@@ -89,5 +120,6 @@ private:
         bool isStatusBarVisible;
         bool isToolBarVisible;
         bool isInformationVisible;
+        bool isFilmstripVisible;
     } m_widgetVisibilityPriorFullscreen {};
 };
@@ -30,12 +30,16 @@ SettingsDialog::SettingsDialog(std::unique_ptr<QSettings> defaultSettings,
                                             &m_uiSettingsDialog.checkBoxWindowHideToolbar,
                                             &m_uiSettingsDialog.checkBoxWindowHideNavigation,
                                             &m_uiSettingsDialog.checkBoxWindowHideInformation,
+                                            &m_uiSettingsDialog.checkBoxWindowHideFilmstrip,
                                             &m_uiSettingsDialog.checkBoxFullscreenHideStatusbar,
                                             &m_uiSettingsDialog.checkBoxFullscreenHideToolbar,
                                             &m_uiSettingsDialog.checkBoxFullscreenHideNavigation,
                                             &m_uiSettingsDialog.checkBoxFullscreenHideInformation,
+                                            &m_uiSettingsDialog.checkBoxFullscreenHideFilmstrip,
                                             &m_uiSettingsDialog.checkBoxRememberRecentImages,
                                             &m_uiSettingsDialog.checkBoxImageFitToWindow,
+                                            &m_uiSettingsDialog.checkBoxImageAutoAdvance,
+                                            &m_uiSettingsDialog.checkBoxRecursionFollowSymlinks,
                                             &m_uiSettingsDialog.checkBoxImageDrawBorder,
                                         }
 {
@@ -86,6 +90,8 @@ void SettingsDialog::initializeUI(const QSettings * const settings)
     m_uiSettingsDialog.toolButtonBorderColor->setEnabled(settings->value(m_uiSettingsDialog.checkBoxImageDrawBorder->whatsThis()).toBool());
     m_borderColor = settings->value(SETTINGS_IMAGE_BORDER_COLOR).value<QColor>();
     m_backgroundColor = settings->value(SETTINGS_IMAGE_BACKGROUND_COLOR).value<QColor>();
+    m_uiSettingsDialog.spinBoxMemoryBudget->setValue(settings->value(SETTINGS_IMAGE_MEMORY_BUDGET).toInt());
+    m_uiSettingsDialog.spinBoxRecursionDepth->setValue(settings->value(SETTINGS_IMAGE_RECURSION_DEPTH).toInt());
     m_languageCode = settings->value(SETTINGS_LANGUAGE_CODE).value<QString>();
 
     if (const auto findIt = std::ranges::find_if(Languages::m_localizations,
@@ -105,6 +111,8 @@ void SettingsDialog::onAccept()
 
     m_userSettings->setValue(SETTINGS_IMAGE_BORDER_COLOR, m_borderColor);
     m_userSettings->setValue(SETTINGS_IMAGE_BACKGROUND_COLOR, m_backgroundColor);
+    m_userSettings->setValue(SETTINGS_IMAGE_MEMORY_BUDGET, m_uiSettingsDialog.spinBoxMemoryBudget->value());
+    m_userSettings->setValue(SETTINGS_IMAGE_RECURSION_DEPTH, m_uiSettingsDialog.spinBoxRecursionDepth->value());
     m_userSettings->setValue(SETTINGS_LANGUAGE_CODE, m_languageCode);
 
     // store all shortcuts in user settings
@@ -53,6 +53,6 @@ private:
     QString m_languageCode;
     std::unique_ptr<QSettings> m_defaultSettings;
     std::unique_ptr<QSettings> m_userSettings;
-    const std::array<QCheckBox **, 13> m_settingsCheckboxes;
+    const std::array<QCheckBox **, 17> m_settingsCheckboxes;
     Ui::SettingsDialog m_uiSettingsDialog {};
 };
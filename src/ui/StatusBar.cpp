@@ -48,6 +48,11 @@ void StatusBar::setZoomLabel(const QString &value)
     m_zoomLabel.setText(value);
 }
 
+void StatusBar::setZoomToolTip(const QString &value)
+{
+    m_zoomLabel.setToolTip(value);
+}
+
 void StatusBar::clearLabels()
 {
     showMessage("");
@@ -24,6 +24,7 @@ public:
     void setDimensionLabel(const QString &value);
     void setSizeLabel(const QString &value);
     void setZoomLabel(const QString &value);
+    void setZoomToolTip(const QString &value);
 
     void clearLabels();
 
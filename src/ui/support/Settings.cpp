@@ -11,6 +11,7 @@ VookiImageViewer - a tool for showing images.
 #include "Settings.h"
 #include <QCoreApplication>
 #include "SettingsStrings.h"
+#include "../../model/CatalogOrder.h"
 #include "../../util/misc.h"
 
 std::unique_ptr<QSettings> Settings::defaultSettings()
@@ -32,15 +33,24 @@ void Settings::initializeSettings(QSettings * const defaultSettings)
     defaultSettings->setValue(SETTINGS_WINDOW_HIDE_TOOLBAR, false);
     defaultSettings->setValue(SETTINGS_WINDOW_HIDE_NAVIGATION, false);
     defaultSettings->setValue(SETTINGS_WINDOW_HIDE_INFORMATION, false);
+    defaultSettings->setValue(SETTINGS_WINDOW_HIDE_FILMSTRIP, true);
     defaultSettings->setValue(SETTINGS_FULLSCREEN_HIDE_STATUSBAR, true);
     defaultSettings->setValue(SETTINGS_FULLSCREEN_HIDE_TOOLBAR, true);
     defaultSettings->setValue(SETTINGS_FULLSCREEN_HIDE_NAVIGATION, true);
     defaultSettings->setValue(SETTINGS_FULLSCREEN_HIDE_INFORMATION, true);
+    defaultSettings->setValue(SETTINGS_FULLSCREEN_HIDE_FILMSTRIP, true);
     defaultSettings->setValue(SETTINGS_IMAGE_REMEMBER_RECENT, true);
     defaultSettings->setValue(SETTINGS_IMAGE_FITIMAGETOWINDOW, false);
+    defaultSettings->setValue(SETTINGS_IMAGE_AUTO_ADVANCE, false);
+    defaultSettings->setValue(SETTINGS_IMAGE_SORT_ORDER, static_cast<int>(CatalogOrder::Criterion::Natural));
+    // Levels of the subdirectories shown along with the opened directory
+    defaultSettings->setValue(SETTINGS_IMAGE_RECURSION_DEPTH, 0);
+    defaultSettings->setValue(SETTINGS_IMAGE_RECURSION_SYMLINKS, false);
     defaultSettings->setValue(SETTINGS_IMAGE_BORDER_DRAW, false);
     defaultSettings->setValue(SETTINGS_IMAGE_BORDER_COLOR, QColor(Qt::white));
     defaultSettings->setValue(SETTINGS_IMAGE_BACKGROUND_COLOR, QColor(Qt::black));
+    // In MiB, the 0 derives the budget from the physical memory size
+    defaultSettings->setValue(SETTINGS_IMAGE_MEMORY_BUDGET, 0);
     defaultSettings->setValue(SETTINGS_LANGUAGE_USE_SYSTEM, true);
     defaultSettings->setValue(SETTINGS_LANGUAGE_CODE, QString("en_US"));
 
@@ -17,11 +17,17 @@ VookiImageViewer - a tool for showing images.
     ITEM(SETTINGS_FULLSCREEN_HIDE_TOOLBAR, "viv/fullscreen/hide/toolbar") \
     ITEM(SETTINGS_FULLSCREEN_HIDE_NAVIGATION, "viv/fullscreen/hide/navigation") \
     ITEM(SETTINGS_FULLSCREEN_HIDE_INFORMATION, "viv/fullscreen/hide/information") \
+    ITEM(SETTINGS_FULLSCREEN_HIDE_FILMSTRIP, "viv/fullscreen/hide/filmstrip") \
     ITEM(SETTINGS_IMAGE_REMEMBER_RECENT, "viv/image/remember/recent") \
     ITEM(SETTINGS_IMAGE_FITIMAGETOWINDOW, "viv/image/fitimagetowindow") \
+    ITEM(SETTINGS_IMAGE_AUTO_ADVANCE, "viv/image/autoadvance") \
+    ITEM(SETTINGS_IMAGE_SORT_ORDER, "viv/image/sort/order") \
+    ITEM(SETTINGS_IMAGE_RECURSION_DEPTH, "viv/image/recursion/depth") \
+    ITEM(SETTINGS_IMAGE_RECURSION_SYMLINKS, "viv/image/recursion/symlinks") \
     ITEM(SETTINGS_IMAGE_BORDER_DRAW, "viv/image/border/draw") \
     ITEM(SETTINGS_IMAGE_BORDER_COLOR, "viv/image/border/color") \
     ITEM(SETTINGS_IMAGE_BACKGROUND_COLOR, "viv/image/background/color") \
+    ITEM(SETTINGS_IMAGE_MEMORY_BUDGET, "viv/image/memory/budget") \
     ITEM(SETTINGS_LANGUAGE_USE_SYSTEM, "viv/language/system") \
     ITEM(SETTINGS_LANGUAGE_CODE, "viv/language/code") \
     ITEM(SETTINGS_RECENT_FILE_1, "viv/recent/file/1") \
@@ -33,6 +39,7 @@ VookiImageViewer - a tool for showing images.
     ITEM(SETTINGS_WINDOW_HIDE_TOOLBAR, "viv/window/hide/toolbar") \
     ITEM(SETTINGS_WINDOW_HIDE_NAVIGATION, "viv/window/hide/navigation") \
     ITEM(SETTINGS_WINDOW_HIDE_INFORMATION, "viv/window/hide/information") \
+    ITEM(SETTINGS_WINDOW_HIDE_FILMSTRIP, "viv/window/hide/filmstrip") \
 
 #define DEFINE_VARIABLES(variable, value, ...) static constexpr auto const variable = value;
 FOR_LIST_OF_VARIABLES( DEFINE_VARIABLES )
@@ -0,0 +1,66 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "PlaybackClock.h"
+#include <algorithm>
+
+void PlaybackClock::start(const TimePoint now, const Duration delay)
+{
+    m_statistics = {};
+    m_isRunning = true;
+    m_dueTime = now;
+    present(now, delay);
+}
+
+void PlaybackClock::stop()
+{
+    m_isRunning = false;
+}
+
+bool PlaybackClock::isRunning() const
+{
+    return m_isRunning;
+}
+
+bool PlaybackClock::isLate(const TimePoint now, const Duration delay) const
+{
+    return m_dueTime + delay <= now;
+}
+
+void PlaybackClock::drop(const Duration delay)
+{
+    m_dueTime += delay;
+    ++m_statistics.dropped;
+}
+
+void PlaybackClock::present(const TimePoint now, const Duration delay)
+{
+    // Falls too far behind, e.g. if the application has been suspended, so the lost time is not replayed.
+    if (isLate(now, delay))
+        m_dueTime = now;
+
+    m_dueTime += delay;
+    ++m_statistics.presented;
+}
+
+PlaybackClock::TimePoint PlaybackClock::getDueTime() const
+{
+    return m_dueTime;
+}
+
+PlaybackClock::Duration PlaybackClock::remaining(const TimePoint now) const
+{
+    return std::max(Duration::zero(), std::chrono::ceil<Duration>(m_dueTime - now));
+}
+
+const PlaybackClock::Statistics &PlaybackClock::getStatistics() const
+{
+    return m_statistics;
+}
@@ -0,0 +1,53 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+
+/// Schedules the animation frames against the absolute presentation timestamps. Every frame is due when the previous
+/// one has been shown for its delay, no matter how long the decoding and rendering took, so the playback does not drift.
+/// Frames which would have been already replaced by the next ones at the time they could be shown are dropped.
+class PlaybackClock
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration = std::chrono::milliseconds;
+
+    struct Statistics
+    {
+        uint64_t presented {0};
+        uint64_t dropped {0};
+    };
+
+    /// The first frame has been presented at the given time, the next one is due after the delay.
+    void start(TimePoint now, Duration delay);
+    void stop();
+    [[nodiscard]] bool isRunning() const;
+
+    /// True if the frame shown for the given delay would be over already, so it should be dropped.
+    [[nodiscard]] bool isLate(TimePoint now, Duration delay) const;
+    void drop(Duration delay);
+    /// The frame is being presented. If even the dropped frames did not catch up with the time, the clock is
+    /// synchronized with the current time again.
+    void present(TimePoint now, Duration delay);
+
+    /// Presentation time of the next frame.
+    [[nodiscard]] TimePoint getDueTime() const;
+    /// Time remaining to the presentation of the next frame, zero if it is already due.
+    [[nodiscard]] Duration remaining(TimePoint now) const;
+    [[nodiscard]] const Statistics &getStatistics() const;
+
+private:
+    TimePoint m_dueTime {};
+    bool m_isRunning {false};
+    Statistics m_statistics {};
+};
@@ -0,0 +1,26 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "PrivateFile.h"
+#include <QDir>
+#include <QFileInfo>
+
+namespace Util
+{
+    bool openPrivateFile(QSaveFile &file)
+    {
+        const QString directory {QFileInfo(file.fileName()).absolutePath()};
+        if (!QDir().mkpath(directory))
+            return false;
+        QFile::setPermissions(directory, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+
+        return file.open(QIODevice::WriteOnly) && file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QSaveFile>
+
+namespace Util
+{
+    /// Opens the cache file for writing, creating its directory. Both are restricted to the owner before anything
+    /// is written, so neither the temporary file nor the committed one is ever readable by others.
+    [[nodiscard]] bool openPrivateFile(QSaveFile &file);
+}
@@ -0,0 +1,148 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "StringArena.h"
+#include <QHashFunctions>
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <utility>
+
+qsizetype StringArena::size() const
+{
+    return static_cast<qsizetype>(m_entries.size());
+}
+
+bool StringArena::isEmpty() const
+{
+    return m_entries.empty();
+}
+
+QStringView StringArena::at(const qsizetype position) const
+{
+    const Entry &entry {m_entries.at(position)};
+    return {m_characters.data() + entry.offset, static_cast<qsizetype>(entry.length)};
+}
+
+QStringView StringArena::operator[](const qsizetype position) const
+{
+    return at(position);
+}
+
+void StringArena::clear()
+{
+    m_characters = {};
+    m_entries = {};
+    m_garbage = 0;
+    m_index = {};
+    m_isIndexValid = false;
+}
+
+void StringArena::reserve(const qsizetype count, const qsizetype characters)
+{
+    m_entries.reserve(count);
+    m_characters.reserve(characters);
+}
+
+void StringArena::append(const QStringView string)
+{
+    m_entries.push_back(store(string));
+    m_isIndexValid = false;
+}
+
+void StringArena::remove(const qsizetype position, const qsizetype count)
+{
+    const auto first {m_entries.begin() + position};
+    for (auto entry {first}; entry != first + count; ++entry)
+        m_garbage += entry->length;
+
+    m_entries.erase(first, first + count);
+    m_isIndexValid = false;
+
+    if (m_garbage > m_characters.size() / 2)
+        compact();
+}
+
+void StringArena::reorder(const std::vector<quint32> &positions)
+{
+    // Just the entries are moved, the characters stay where they are.
+    std::vector<Entry> entries;
+    entries.reserve(positions.size());
+    for (const quint32 position : positions)
+        entries.push_back(m_entries[position]);
+
+    m_entries = std::move(entries);
+    m_isIndexValid = false;
+}
+
+qsizetype StringArena::indexOf(const QStringView string) const
+{
+    if (m_entries.empty())
+        return -1;
+
+    if (!m_isIndexValid)
+        rebuildIndex();
+
+    const std::size_t mask {m_index.size() - 1};
+    for (std::size_t slot {qHash(string) & mask}; m_index[slot] != 0; slot = (slot + 1) & mask)
+    {
+        if (const qsizetype position {m_index[slot] - 1}; at(position) == string)
+            return position;
+    }
+
+    return -1;
+}
+
+qsizetype StringArena::lowerBound(const QStringView string, const qsizetype first) const
+{
+    const auto entry {std::lower_bound(m_entries.begin() + first, m_entries.end(), string, [this](const Entry &entry, const QStringView value) {
+        return QStringView {m_characters.data() + entry.offset, static_cast<qsizetype>(entry.length)} < value;
+    })};
+    return static_cast<qsizetype>(std::distance(m_entries.begin(), entry));
+}
+
+StringArena::Entry StringArena::store(const QStringView string)
+{
+    const Entry entry {static_cast<quint32>(m_characters.size()), static_cast<quint32>(string.size())};
+    m_characters.insert(m_characters.end(), string.begin(), string.end());
+    return entry;
+}
+
+void StringArena::compact()
+{
+    std::vector<QChar> characters;
+    characters.reserve(m_characters.size() - m_garbage);
+    for (Entry &entry : m_entries)
+    {
+        const auto first {m_characters.begin() + entry.offset};
+        entry.offset = static_cast<quint32>(characters.size());
+        characters.insert(characters.end(), first, first + entry.length);
+    }
+
+    m_characters = std::move(characters);
+    m_garbage = 0;
+}
+
+void StringArena::rebuildIndex() const
+{
+    m_index.assign(std::bit_ceil(std::max<std::size_t>(m_entries.size() * 2, 16)), 0);
+
+    const std::size_t mask {m_index.size() - 1};
+    for (std::size_t position = 0; position < m_entries.size(); ++position)
+    {
+        std::size_t slot {qHash(at(static_cast<qsizetype>(position))) & mask};
+        while (m_index[slot] != 0)
+            slot = (slot + 1) & mask;
+
+        m_index[slot] = static_cast<quint32>(position + 1);
+    }
+
+    m_isIndexValid = true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QChar>
+#include <QStringView>
+#include <QtGlobal>
+#include <vector>
+
+/// Ordered list of strings stored back to back in a single buffer. A string costs its characters and 8 bytes,
+/// instead of a separately allocated QString, so even the million-entry lists stay small. Strings are looked up
+/// through an open-addressing hash index of the positions, which is rebuilt lazily after the modifications.
+class StringArena
+{
+public:
+    [[nodiscard]] qsizetype size() const;
+    [[nodiscard]] bool isEmpty() const;
+    /// The view is valid until the next modification.
+    [[nodiscard]] QStringView at(qsizetype position) const;
+    [[nodiscard]] QStringView operator[](qsizetype position) const;
+
+    void clear();
+    void reserve(qsizetype count, qsizetype characters);
+    void append(QStringView string);
+    /// Inserts the strings in front of the position.
+    template<typename Iterator>
+    void insert(qsizetype position, Iterator first, Iterator last);
+    /// The characters of the removed strings are reclaimed once they take more than a half of the buffer.
+    void remove(qsizetype position, qsizetype count = 1);
+    /// Puts the strings in the order of the given positions, which list every position once.
+    void reorder(const std::vector<quint32> &positions);
+
+    /// Returns -1 if the string is not there.
+    [[nodiscard]] qsizetype indexOf(QStringView string) const;
+    /// The first position, starting from the given one, whose string is not less than the given one.
+    /// The strings have to be sorted.
+    [[nodiscard]] qsizetype lowerBound(QStringView string, qsizetype first = 0) const;
+
+private:
+    struct Entry
+    {
+        quint32 offset;
+        quint32 length;
+    };
+
+    Entry store(QStringView string);
+    void compact();
+    void rebuildIndex() const;
+
+    std::vector<QChar> m_characters {};
+    std::vector<Entry> m_entries {};
+    // Characters no longer referenced by any entry
+    std::size_t m_garbage {0};
+    // Slots hold the position + 1, zero marks the empty one. Kept at most half full.
+    mutable std::vector<quint32> m_index {};
+    mutable bool m_isIndexValid {false};
+};
+
+template<typename Iterator>
+void StringArena::insert(const qsizetype position, Iterator first, Iterator last)
+{
+    // Characters are always appended, just the small entries are moved.
+    std::vector<Entry> entries;
+    for (; first != last; ++first)
+        entries.push_back(store(*first));
+
+    m_entries.insert(m_entries.begin() + position, entries.begin(), entries.end());
+    m_isIndexValid = false;
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "PlaybackClockTest.h"
+#include "../PlaybackClock.h"
+
+using namespace std::chrono_literals;
+
+void PlaybackClockTest::noDrift() const
+{
+    const PlaybackClock::TimePoint start {};
+    PlaybackClock clock;
+    QVERIFY(!clock.isRunning());
+
+    clock.start(start, 100ms);
+    QVERIFY(clock.isRunning());
+    QVERIFY(clock.getDueTime() == start + 100ms);
+
+    // Frames presented late are not postponing the following ones.
+    for (int frame = 1; frame <= 10; ++frame)
+    {
+        const auto now {start + frame * 100ms + 30ms};
+        QVERIFY(!clock.isLate(now, 100ms));
+        clock.present(now, 100ms);
+        QVERIFY(clock.getDueTime() == start + (frame + 1) * 100ms);
+    }
+
+    QCOMPARE(clock.getStatistics().presented, uint64_t {11});
+    QCOMPARE(clock.getStatistics().dropped, uint64_t {0});
+
+    clock.stop();
+    QVERIFY(!clock.isRunning());
+}
+
+void PlaybackClockTest::dropLateFrames() const
+{
+    const PlaybackClock::TimePoint start {};
+    PlaybackClock clock;
+    clock.start(start, 100ms);
+
+    // The rendering took 250 ms, so the frame due at 100 ms is over and the one due at 200 ms is shown.
+    const auto now {start + 250ms};
+    QVERIFY(clock.isLate(now, 100ms));
+    clock.drop(100ms);
+    QVERIFY(!clock.isLate(now, 100ms));
+    clock.present(now, 100ms);
+
+    QVERIFY(clock.getDueTime() == start + 300ms);
+    QCOMPARE(clock.getStatistics().presented, uint64_t {2});
+    QCOMPARE(clock.getStatistics().dropped, uint64_t {1});
+}
+
+void PlaybackClockTest::resynchronize() const
+{
+    const PlaybackClock::TimePoint start {};
+    PlaybackClock clock;
+    clock.start(start, 100ms);
+
+    // Frames were not dropped at all, the lost time is not replayed.
+    const auto now {start + 10s};
+    clock.present(now, 100ms);
+    QVERIFY(clock.getDueTime() == now + 100ms);
+
+    // Restarting clears the statistics.
+    clock.start(now, 50ms);
+    QCOMPARE(clock.getStatistics().presented, uint64_t {1});
+    QCOMPARE(clock.getStatistics().dropped, uint64_t {0});
+}
+
+void PlaybackClockTest::remaining() const
+{
+    const PlaybackClock::TimePoint start {};
+    PlaybackClock clock;
+    clock.start(start, 100ms);
+
+    QCOMPARE(clock.remaining(start).count(), 100);
+    QCOMPARE(clock.remaining(start + 40ms).count(), 60);
+    QCOMPARE(clock.remaining(start + 40500us).count(), 60);
+    QCOMPARE(clock.remaining(start + 150ms).count(), 0);
+}
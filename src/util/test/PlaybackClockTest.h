@@ -0,0 +1,23 @@
+#pragma once
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+
+class PlaybackClockTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void noDrift() const;
+    void dropLateFrames() const;
+    void resynchronize() const;
+    void remaining() const;
+};
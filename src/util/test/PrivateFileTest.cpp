@@ -0,0 +1,40 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "PrivateFileTest.h"
+#include "../PrivateFile.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+void PrivateFileTest::openPrivateFile() const
+{
+    const QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    // The missing directories are created
+    const QString path {directory.filePath("cache/nested/file.bin")};
+    QSaveFile file {path};
+    QVERIFY(Util::openPrivateFile(file));
+    QVERIFY(file.write("data") == 4);
+    QVERIFY(file.commit());
+
+    QFile written {path};
+    QVERIFY(written.open(QIODevice::ReadOnly));
+    QCOMPARE(written.readAll(), QByteArray("data"));
+
+#ifdef Q_OS_UNIX
+    // Neither the file nor its directory is accessible by others
+    constexpr QFileDevice::Permissions others {QFileDevice::ReadGroup | QFileDevice::WriteGroup | QFileDevice::ExeGroup
+                                               | QFileDevice::ReadOther | QFileDevice::WriteOther | QFileDevice::ExeOther};
+    QCOMPARE(QFile::permissions(path) & others, QFileDevice::Permissions {});
+    QCOMPARE(QFile::permissions(QFileInfo(path).absolutePath()) & others, QFileDevice::Permissions {});
+#endif
+}
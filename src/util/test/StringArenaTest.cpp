@@ -0,0 +1,128 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include "StringArenaTest.h"
+#include "../StringArena.h"
+#include <QStringList>
+
+void StringArenaTest::empty() const
+{
+    const StringArena arena;
+    QVERIFY(arena.isEmpty());
+    QCOMPARE(arena.size(), 0);
+    QCOMPARE(arena.indexOf(u"first"), -1);
+    QCOMPARE(arena.lowerBound(u"first"), 0);
+}
+
+void StringArenaTest::append() const
+{
+    StringArena arena;
+    arena.append(u"first");
+    arena.append(u"");
+    arena.append(QString::fromUtf8("třetí"));
+
+    QCOMPARE(arena.size(), 3);
+    QCOMPARE(arena.at(0).toString(), QString("first"));
+    QCOMPARE(arena.at(1).toString(), QString(""));
+    QCOMPARE(arena[2].toString(), QString::fromUtf8("třetí"));
+
+    arena.clear();
+    QVERIFY(arena.isEmpty());
+    QCOMPARE(arena.indexOf(u"first"), -1);
+}
+
+void StringArenaTest::insert() const
+{
+    StringArena arena;
+    arena.append(u"b");
+    arena.append(u"e");
+
+    const QStringList front {"a"};
+    const QStringList middle {"c", "d"};
+    const QStringList back {"f"};
+    arena.insert(2, back.cbegin(), back.cend());
+    arena.insert(1, middle.cbegin(), middle.cend());
+    arena.insert(0, front.cbegin(), front.cend());
+
+    QCOMPARE(arena.size(), 6);
+    for (qsizetype i = 0; i < arena.size(); ++i)
+        QCOMPARE(arena.at(i).toString(), QString(QChar(u'a' + static_cast<int>(i))));
+}
+
+void StringArenaTest::remove() const
+{
+    StringArena arena;
+    for (const auto *item : {u"a", u"b", u"c", u"d", u"e", u"f"})
+        arena.append(item);
+
+    arena.remove(1, 2);
+    QCOMPARE(arena.size(), 4);
+    QCOMPARE(arena.at(1).toString(), QString("d"));
+    QCOMPARE(arena.indexOf(u"b"), -1);
+    QCOMPARE(arena.indexOf(u"e"), 2);
+
+    // More than a half of the characters is garbage, the strings survive the compaction
+    arena.remove(0);
+    arena.remove(0);
+    QCOMPARE(arena.size(), 2);
+    QCOMPARE(arena.at(0).toString(), QString("e"));
+    QCOMPARE(arena.at(1).toString(), QString("f"));
+    QCOMPARE(arena.indexOf(u"f"), 1);
+}
+
+void StringArenaTest::reorder() const
+{
+    StringArena arena;
+    for (const auto *item : {u"a", u"b", u"c"})
+        arena.append(item);
+
+    QCOMPARE(arena.indexOf(u"a"), 0);
+    arena.reorder({2, 0, 1});
+    QCOMPARE(arena.size(), 3);
+    QCOMPARE(arena.at(0).toString(), QString("c"));
+    QCOMPARE(arena.at(1).toString(), QString("a"));
+    QCOMPARE(arena.at(2).toString(), QString("b"));
+    QCOMPARE(arena.indexOf(u"a"), 1);
+}
+
+void StringArenaTest::indexOf() const
+{
+    // Enough strings to grow the index several times and to have the colliding slots
+    constexpr int count {10000};
+    StringArena arena;
+    for (int i = 0; i < count; ++i)
+        arena.append(QString("image%1.jpg").arg(i));
+
+    for (int i = 0; i < count; i += 97)
+        QCOMPARE(arena.indexOf(QString("image%1.jpg").arg(i)), i);
+
+    QCOMPARE(arena.indexOf(u"image.jpg"), -1);
+
+    // The index follows the positions moved by the insertion
+    const QStringList inserted {"inserted.jpg"};
+    arena.insert(0, inserted.cbegin(), inserted.cend());
+    QCOMPARE(arena.indexOf(u"inserted.jpg"), 0);
+    QCOMPARE(arena.indexOf(u"image0.jpg"), 1);
+    QCOMPARE(arena.indexOf(QString("image%1.jpg").arg(count - 1)), count);
+}
+
+void StringArenaTest::lowerBound() const
+{
+    StringArena arena;
+    for (const auto *item : {u"b", u"d", u"f"})
+        arena.append(item);
+
+    QCOMPARE(arena.lowerBound(u"a"), 0);
+    QCOMPARE(arena.lowerBound(u"b"), 0);
+    QCOMPARE(arena.lowerBound(u"c"), 1);
+    QCOMPARE(arena.lowerBound(u"f"), 2);
+    QCOMPARE(arena.lowerBound(u"g"), 3);
+    QCOMPARE(arena.lowerBound(u"a", 2), 2);
+}
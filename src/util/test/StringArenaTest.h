@@ -0,0 +1,25 @@
+/****************************************************************************
+VookiImageViewer - a tool for showing images.
+- https://github.com/vookimedlo/vooki-image-viewer
+
+  SPDX-FileCopyrightText: 2026 Michal Duda <github@vookimedlo.cz>
+  SPDX-License-Identifier: GPL-3.0-or-later
+  SPDX-FileType: SOURCE
+
+****************************************************************************/
+
+#include <QTest>
+
+class StringArenaTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void empty() const;
+    void append() const;
+    void insert() const;
+    void remove() const;
+    void reorder() const;
+    void indexOf() const;
+    void lowerBound() const;
+};
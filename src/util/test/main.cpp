@@ -11,8 +11,11 @@ VookiImageViewer - a tool for showing images.
 #include "ArrayTest.h"
 #include "ByteSizeTest.h"
 #include "MiscTest.h"
+#include "PlaybackClockTest.h"
+#include "PrivateFileTest.h"
 #include "EnumClassArrayTest.h"
 #include "RotatingIndexTest.h"
+#include "StringArenaTest.h"
 #include "../testing.h"
 
 
@@ -24,7 +27,10 @@ int main(int argc, char *argv[])
     TEST::runTests<ByteSizeTest>(argc, argv, &status);
     TEST::runTests<EnumClassArrayTest>(argc, argv, &status);
     TEST::runTests<MiscTest>(argc, argv, &status);
+    TEST::runTests<PlaybackClockTest>(argc, argv, &status);
+    TEST::runTests<PrivateFileTest>(argc, argv, &status);
     TEST::runTests<RotatingIndexTest>(argc, argv, &status);
+    TEST::runTests<StringArenaTest>(argc, argv, &status);
 
     return status;
 }